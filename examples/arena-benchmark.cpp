@@ -0,0 +1,108 @@
+#include <iostream>
+#include <chrono>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_NODES 64
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//parses hwloc + caps-numa-benchmark data into num_nodes nodes of a new topology; if arena is not NULL, the whole topology is placed in the arena
+Topology* parse_topology(string topoPath, string bwPath, int num_nodes, TopologyArena* arena)
+{
+    Topology* t;
+    {
+        TopologyArena::Scope scope(arena);
+        t = new Topology();
+    }
+    for(int i = 0; i < num_nodes; i++)
+    {
+        Node* n;
+        {
+            TopologyArena::Scope scope(arena);
+            n = new Node(t, i);
+        }
+        if(parseHwlocOutput(n, topoPath, arena) != 0 || parseCapsNumaBenchmark(n, bwPath, ";", arena) != 0)
+        {
+            cout << "failed parsing input data" << endl;
+            return NULL;
+        }
+    }
+    return t;
+}
+
+//this file benchmarks building and tearing down a topology with the default heap allocation and with a TopologyArena
+int main(int argc, char *argv[])
+{
+    std::string path_prefix(argv[0]);
+    std::size_t found = path_prefix.find_last_of("/\\");
+    path_prefix=path_prefix.substr(0,found) + "/";
+    string topoPath = path_prefix + "example_data/skylake_hwloc.xml";
+    string bwPath = path_prefix + "example_data/skylake_caps_numa_benchmark.csv";
+
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    //heap
+    t_start = high_resolution_clock::now();
+    Topology* t = parse_topology(topoPath, bwPath, NUM_NODES, NULL);
+    t_end = high_resolution_clock::now();
+    if(t == NULL)
+        return 1;
+    uint64_t time_parse_heap = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    vector<Component*> components;
+    t->GetSubtreeNodeList(&components);
+    size_t num_components = components.size();
+
+    t_start = high_resolution_clock::now();
+    t->Delete(true);
+    t_end = high_resolution_clock::now();
+    uint64_t time_teardown_heap = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+    //arena
+    TopologyArena* arena = new TopologyArena();
+    t_start = high_resolution_clock::now();
+    t = parse_topology(topoPath, bwPath, NUM_NODES, arena);
+    t_end = high_resolution_clock::now();
+    if(t == NULL)
+        return 1;
+    uint64_t time_parse_arena = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    size_t arena_objects = arena->GetNumObjects();
+    size_t arena_bytes = arena->GetReservedBytes();
+
+    t_start = high_resolution_clock::now();
+    delete arena;
+    t_end = high_resolution_clock::now();
+    uint64_t time_teardown_arena = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+    cout << "nodes, " << NUM_NODES << ", components, " << num_components;
+    cout << ", arena_objects, " << arena_objects << ", arena_bytes, " << arena_bytes;
+    cout << ", time_parse_heap, " << time_parse_heap;
+    cout << ", time_parse_arena, " << time_parse_arena;
+    cout << ", time_teardown_heap, " << time_teardown_heap;
+    cout << ", time_teardown_arena, " << time_teardown_arena << endl;
+
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <chrono>
+#include <map>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_STORES 100000
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//this file benchmarks inserting and looking up attributes in std::map<string,void*> (the former attrib type) against AttribStore -- through its map-like (string key) interface and through the typed interface with pre-interned keys
+int main(int argc, char *argv[])
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    for(int num_keys : {2, 4, 8, 16})
+    {
+        vector<string> key_names;
+        vector<AttribKey> keys;
+        for(int k = 0; k < num_keys; k++)
+        {
+            key_names.push_back("attribute_key_" + std::to_string(k));
+            keys.push_back(AttribKey(key_names.back()));
+        }
+        vector<int> values(num_keys);
+        uint64_t checksum = 0;
+
+        vector<map<string,void*>> maps(NUM_STORES);
+        vector<AttribStore> stores_void(NUM_STORES);
+        vector<AttribStore> stores_typed(NUM_STORES);
+
+        //insert
+        t_start = high_resolution_clock::now();
+        for(auto& m : maps)
+            for(int k = 0; k < num_keys; k++)
+                m[key_names[k]] = (void*)&values[k];
+        t_end = high_resolution_clock::now();
+        uint64_t time_insert_map = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        t_start = high_resolution_clock::now();
+        for(auto& s : stores_void)
+            for(int k = 0; k < num_keys; k++)
+                s[key_names[k]] = (void*)&values[k];
+        t_end = high_resolution_clock::now();
+        uint64_t time_insert_store_void = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        t_start = high_resolution_clock::now();
+        for(auto& s : stores_typed)
+            for(int k = 0; k < num_keys; k++)
+                s.Set(keys[k], k);
+        t_end = high_resolution_clock::now();
+        uint64_t time_insert_store_typed = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        //lookup (the last key)
+        const string& key_name = key_names.back();
+        const AttribKey& key = keys.back();
+        t_start = high_resolution_clock::now();
+        for(auto& m : maps)
+            checksum += *(int*)m.find(key_name)->second;
+        t_end = high_resolution_clock::now();
+        uint64_t time_lookup_map = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        t_start = high_resolution_clock::now();
+        for(auto& s : stores_void)
+            checksum += *(int*)s.find(key_name)->second;
+        t_end = high_resolution_clock::now();
+        uint64_t time_lookup_store_void = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        t_start = high_resolution_clock::now();
+        for(auto& s : stores_typed)
+            checksum += *s.Get<int>(key);
+        t_end = high_resolution_clock::now();
+        uint64_t time_lookup_store_typed = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        cout << "stores, " << NUM_STORES << ", keys_per_store, " << num_keys;
+        cout << ", time_insert_map, " << time_insert_map;
+        cout << ", time_insert_store_void, " << time_insert_store_void;
+        cout << ", time_insert_store_typed, " << time_insert_store_typed;
+        cout << ", time_lookup_map, " << time_lookup_map;
+        cout << ", time_lookup_store_void, " << time_lookup_store_void;
+        cout << ", time_lookup_store_typed, " << time_lookup_store_typed;
+        cout << ", sizeof_map, " << sizeof(map<string,void*>) << ", sizeof_store, " << sizeof(AttribStore);
+        cout << ", (checksum " << checksum << ")" << endl;
+    }
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
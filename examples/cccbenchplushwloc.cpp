@@ -41,7 +41,7 @@ int main(int argc, char *argv[])
     
     
     auto cccparser = new CccbenchParser(cccPath);
-    cccparser->applyDataPaths(n);
+    DataPathMatrix* c2c = cccparser->applyDataPaths(n);
 
     auto allcores = new vector<Component *>();
     topo->FindAllSubcomponentsByType(allcores, SYS_SAGE_COMPONENT_CORE);    
@@ -51,9 +51,10 @@ int main(int argc, char *argv[])
         for(auto c1 : *allcores)
             cout << endl << c0->GetId() << " " << c1->GetId() << endl;
 
-    cout << "---------------- Printing all DataPaths ----------------" << endl;
-    n->PrintAllDataPathsInSubtree();
-    cout << "----------------                        ----------------" << endl;
+    cout << "---------------- Printing the core-to-core latencies ----------------" << endl;
+    if(c2c != NULL)
+        c2c->Print();
+    cout << "----------------                                      ----------------" << endl;
     delete topo;
     delete n;
     return 0;
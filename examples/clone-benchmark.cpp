@@ -0,0 +1,94 @@
+#include <iostream>
+#include <chrono>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_REPEATS 20
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//this file benchmarks copying a topology (hwloc + caps-numa-benchmark DataPaths): re-parsing the input data vs CloneSubtree() vs a copy-on-write Fork() modified in one component
+int main(int argc, char *argv[])
+{
+    std::string path_prefix(argv[0]);
+    std::size_t found = path_prefix.find_last_of("/\\");
+    path_prefix=path_prefix.substr(0,found) + "/";
+    string topoPath = path_prefix + "example_data/skylake_hwloc.xml";
+    string bwPath = path_prefix + "example_data/skylake_caps_numa_benchmark.csv";
+
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    uint64_t time_parse = 0, time_clone = 0, time_fork = 0;
+    int num_components = 0, num_datapaths = 0;
+    for(int i = 0; i < NUM_REPEATS; i++)
+    {
+        //re-parse
+        t_start = high_resolution_clock::now();
+        Topology* t = new Topology();
+        Node* n = new Node(t, 0);
+        if(parseHwlocOutput(n, topoPath) != 0 || parseCapsNumaBenchmark(n, bwPath, ";") != 0)
+        {
+            cout << "failed parsing input data" << endl;
+            return 1;
+        }
+        t_end = high_resolution_clock::now();
+        time_parse += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        //deep copy
+        t_start = high_resolution_clock::now();
+        Component* clone = t->CloneSubtree();
+        t_end = high_resolution_clock::now();
+        time_clone += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+        if(clone == NULL)
+            return 1;
+        num_components = clone->CountAllSubcomponents();
+        unsigned component_size, dataPath_size;
+        std::set<DataPath*> counted_dataPaths;
+        clone->GetTopologySize(&component_size, &dataPath_size, &counted_dataPaths);
+        num_datapaths = counted_dataPaths.size();
+
+        //fork + materialize one Cache for a what-if change
+        vector<Component*> caches;
+        t->GetAllSubcomponentsByType(&caches, SYS_SAGE_COMPONENT_CACHE);
+        t_start = high_resolution_clock::now();
+        Component* fork = t->Fork();
+        Cache* cache = (Cache*)fork->Unshare(caches[0]);
+        cache->SetCacheSize(cache->GetCacheSize() / 2);
+        t_end = high_resolution_clock::now();
+        time_fork += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        fork->Delete(true);
+        clone->Delete(true);
+        t->Delete(true);
+    }
+
+    cout << "repeats, " << NUM_REPEATS << ", components, " << num_components << ", datapaths, " << num_datapaths;
+    cout << ", time_parse, " << time_parse / NUM_REPEATS;
+    cout << ", time_clone, " << time_clone / NUM_REPEATS;
+    cout << ", time_fork_unshare, " << time_fork / NUM_REPEATS << endl;
+
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
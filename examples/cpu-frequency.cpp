@@ -53,7 +53,7 @@ int main(int argc, char *argv[])
     }
 
     cout << "-- Refresh frequency on all cores of Node 1(and store the timestamp). " << endl;
-    //Frequency gets stored in attrib freq_history (value of type std::vector<std::tuple<long long=timestamp,double=frequency in MHz>>)
+    //Frequency gets stored in attrib freq_history (value of type AttribTimeSeries -- ring buffer of samples <long long=timestamp,double=frequency in MHz>)
     int repeat = 10;
     for(int i = 0; i<repeat; i++)
     {
@@ -62,11 +62,14 @@ int main(int argc, char *argv[])
     }
 
     cout << "-- Print out frequency history on core 1 of Node 1. " << endl;
-    std::vector<std::tuple<long long,double>>* fh = (std::vector<std::tuple<long long,double>>*)c1->attrib["freq_history"];
-    for(auto [ ts,freq ] : *fh)
+    AttribTimeSeries* fh = c1->attrib.Get<AttribTimeSeries>("freq_history");
+    std::vector<AttribTimeSeries::Sample> samples;
+    fh->GetSamples(&samples);
+    for(auto [ ts,freq ] : samples)
     {
         cout << "    ts: " << ts << " frequency[MHz]: " << freq << endl;
     }
+    cout << "    min: " << fh->GetMin() << " max: " << fh->GetMax() << " mean: " << fh->GetMean() << " median: " << fh->GetPercentile(50) << endl;
 
     cout << "-- Export all information to xml " << output_name << endl;
     exportToXml(topo, output_name);
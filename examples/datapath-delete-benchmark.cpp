@@ -0,0 +1,101 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_COMPONENTS 1000
+#define NUM_REPEATS 3
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//creates NUM_COMPONENTS*NUM_COMPONENTS DataPaths: all-to-all between the cores (type PHYSICAL), and the same number from the node to the cores (type L3CAT, i.e. a node with NUM_COMPONENTS*NUM_COMPONENTS outgoing DataPaths)
+static vector<DataPath*> CreateDataPaths(Node* n, vector<Component*>& cores)
+{
+    vector<DataPath*> dps;
+    dps.reserve(NUM_COMPONENTS*NUM_COMPONENTS);
+    for(Component* src : cores)
+        for(Component* tgt : cores)
+            dps.push_back(new DataPath(src, tgt, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL));
+    for(int i = 0; i < NUM_COMPONENTS; i++)
+        for(Component* tgt : cores)
+            new DataPath(n, tgt, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+    return dps;
+}
+
+//this file benchmarks deleting 1M DataPaths: one by one in random order, by type in one pass, and all DataPaths of a high-degree component
+int main(int argc, char *argv[])
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    Topology* t = new Topology();
+    Node* n = new Node(t, 0);
+    vector<Component*> cores;
+    for(int i = 0; i < NUM_COMPONENTS; i++)
+        cores.push_back(new Core(n, i));
+    std::mt19937 rng(42);
+
+    uint64_t time_random = 0, time_by_type = 0, time_node = 0;
+    for(int i = 0; i < NUM_REPEATS; i++)
+    {
+        vector<DataPath*> dps = CreateDataPaths(n, cores);
+        std::shuffle(dps.begin(), dps.end(), rng);
+
+        //1M individual deletions in random order
+        t_start = high_resolution_clock::now();
+        for(DataPath* dp : dps)
+            dp->DeleteDataPath();
+        t_end = high_resolution_clock::now();
+        time_random += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        //1M DataPaths of one type in one pass
+        CreateDataPaths(n, cores);
+        t_start = high_resolution_clock::now();
+        int deleted = t->DeleteDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, true);
+        t_end = high_resolution_clock::now();
+        time_by_type += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+        if(deleted != NUM_COMPONENTS*NUM_COMPONENTS)
+        {
+            cout << "unexpected number of deleted DataPaths: " << deleted << endl;
+            return 1;
+        }
+
+        //1M DataPaths of the node
+        t_start = high_resolution_clock::now();
+        n->DeleteAllDataPaths();
+        t_end = high_resolution_clock::now();
+        time_node += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    }
+
+    cout << "repeats, " << NUM_REPEATS << ", datapaths, " << NUM_COMPONENTS*NUM_COMPONENTS;
+    cout << ", time_delete_random_order, " << time_random / NUM_REPEATS;
+    cout << ", time_delete_by_type, " << time_by_type / NUM_REPEATS;
+    cout << ", time_delete_all_of_node, " << time_node / NUM_REPEATS << endl;
+
+    t->Delete(true);
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
@@ -0,0 +1,130 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <unistd.h>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_THREADS 256
+#define NUM_SMS 132
+#define NUM_MIG_PARTITIONS 7
+#define NUM_REFRESHES 10000
+#define REPORT_EVERY 1000
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//resident set size of this process in kB
+static long GetRssKb()
+{
+    long pages = 0, rss = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> rss;
+    return rss * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+//synthetic model of one refresh by Node::UpdateL3CATCoreCOS() and Chip::UpdateMIGSettings() (which need libpqos/NVML and real hardware): the same DataPath and attribute updates on the same endpoints, with made-up values
+//CAT: a bidirectional L3CAT DataPath per thread and its L3 with "CATcos", "CATL3mask" and the "CATL3mask_history" time series
+//MIG: per partition (uuid), oriented MIG DataPaths from the GPU Chip to its Memory and L2 cache (with "mig_size" and the "mig_size_history" time series) and to its SMs
+static void Refresh(vector<Component*>& threads, Cache* l3, Chip* gpu, Memory* gpu_mem, Cache* l2, vector<Component*>& sms, int iteration)
+{
+    static const AttribKey CATcos_key("CATcos");
+    static const AttribKey CATL3mask_key("CATL3mask");
+    static const AttribKey CATL3mask_history_key("CATL3mask_history");
+    static const AttribKey mig_uuid_key("mig_uuid");
+    static const AttribKey mig_size_key("mig_size");
+    static const AttribKey mig_size_history_key("mig_size_history");
+
+    long long ts = high_resolution_clock::now().time_since_epoch().count();
+    uint64_t mask = 0xff;
+    for(Component* thread : threads)
+    {
+        DataPath* d = UpsertDataPath(thread, l3, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        d->attrib.Set(CATcos_key, (uint64_t)(iteration % 16));
+        d->attrib.Set(CATL3mask_key, mask);
+        d->attrib.AppendSample(CATL3mask_history_key, ts, mask);
+    }
+    for(int p = 0; p < NUM_MIG_PARTITIONS; p++)
+    {
+        string uuid = "MIG-" + to_string(p);
+        long long mig_size = (long long)(iteration % 40 + 1) * 1024 * 1024 * 1024;
+        DataPath* d = UpsertDataPath(gpu, gpu_mem, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, mig_uuid_key, uuid);
+        d->attrib.Set(mig_size_key, mig_size);
+        d->attrib.AppendSample(mig_size_history_key, ts, mig_size);
+        long long cache_mig_size = l2->GetCacheSize() / NUM_MIG_PARTITIONS;
+        d = UpsertDataPath(gpu, l2, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, mig_uuid_key, uuid);
+        d->attrib.Set(mig_size_key, cache_mig_size);
+        d->attrib.AppendSample(mig_size_history_key, ts, cache_mig_size);
+        for(size_t i = p; i < sms.size(); i += NUM_MIG_PARTITIONS)
+            UpsertDataPath(gpu, sms[i], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, mig_uuid_key, uuid);
+    }
+}
+
+//this file soak-tests periodically refreshed DataPaths (CAT and MIG settings, see Refresh()): NUM_REFRESHES refreshes update the DataPaths in place and append to fixed-capacity histories, so the number of DataPaths and the memory footprint stay flat
+int main(int argc, char *argv[])
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    Topology* t = new Topology();
+    Node* n = new Node(t, 0);
+    Chip* socket = new Chip(n, 0);
+    Cache* l3 = new Cache(socket, 0, 3, 32*1024*1024, 16);
+    vector<Component*> threads;
+    for(int i = 0; i < NUM_THREADS; i++)
+        threads.push_back(new Thread(new Core(l3, i), i));
+    Chip* gpu = new Chip(n, 1, "GPU", SYS_SAGE_CHIP_TYPE_GPU);
+    Memory* gpu_mem = new Memory(gpu, "GPU memory");
+    Cache* l2 = new Cache(gpu_mem, 0, "L2", 50*1024*1024);
+    vector<Component*> sms;
+    for(int i = 0; i < NUM_SMS; i++)
+    {
+        Subdivision* sm = new Subdivision(l2, i, "SM");
+        sm->SetSubdivisionType(SYS_SAGE_SUBDIVISION_TYPE_GPU_SM);
+        sms.push_back(sm);
+    }
+
+    uint64_t time = 0;
+    long rss_start = 0;
+    for(int i = 1; i <= NUM_REFRESHES; i++)
+    {
+        t_start = high_resolution_clock::now();
+        Refresh(threads, l3, gpu, gpu_mem, l2, sms, i);
+        t_end = high_resolution_clock::now();
+        time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+        if(i == 1)
+            rss_start = GetRssKb();
+        if(i % REPORT_EVERY == 0)
+        {
+            cout << "refreshes, " << i << ", time_per_refresh, " << time / REPORT_EVERY;
+            cout << ", datapaths_l3, " << l3->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size();
+            cout << ", datapaths_gpu, " << gpu->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size();
+            cout << ", rss_kb, " << GetRssKb() << ", rss_growth_kb, " << GetRssKb() - rss_start << endl;
+            time = 0;
+        }
+    }
+
+    t->Delete(true);
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <chrono>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define QUERY_REPEATS 16
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//builds a synthetic topology with (roughly) num_components components: Node -> Chips -> L3 -> Cores -> Threads
+Topology* build_topology(int num_components)
+{
+    Topology* t = new Topology();
+    Node* n = new Node(t, 0);
+    int created = 2;
+    int chip_id = 0, core_id = 0, thread_id = 0;
+    while(created < num_components)
+    {
+        Chip* chip = new Chip(n, chip_id++, "socket", SYS_SAGE_CHIP_TYPE_CPU_SOCKET);
+        Cache* l3 = new Cache(chip, chip_id, 3);
+        created += 2;
+        for(int c = 0; c < 32 && created < num_components; c++)
+        {
+            Core* core = new Core(l3, core_id++);
+            new Thread(core, thread_id++);
+            new Thread(core, thread_id++);
+            created += 3;
+        }
+    }
+    return t;
+}
+
+//this file benchmarks queries on the pointer-based Component Tree against the same queries on a FrozenTopology snapshot
+int main(int argc, char *argv[])
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    for(int num_components : {1000, 10000, 100000})
+    {
+        Topology* t = build_topology(num_components);
+        vector<Component*> threads = t->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD);
+        int last_thread_id = threads.back()->GetId();
+        size_t found = 0;
+
+        //time freeze
+        t_start = high_resolution_clock::now();
+        FrozenTopology* f = t->Freeze();
+        t_end = high_resolution_clock::now();
+        uint64_t time_freeze = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        //time GetAllSubcomponentsByType
+        t_start = high_resolution_clock::now();
+        for(int i = 0; i < QUERY_REPEATS; i++)
+            found += t->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD).size();
+        t_end = high_resolution_clock::now();
+        uint64_t time_tree_byType = (t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead)/QUERY_REPEATS;
+        t_start = high_resolution_clock::now();
+        for(int i = 0; i < QUERY_REPEATS; i++)
+            found += f->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD).size();
+        t_end = high_resolution_clock::now();
+        uint64_t time_frozen_byType = (t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead)/QUERY_REPEATS;
+
+        //time GetSubcomponentById (worst case -- the last thread)
+        t_start = high_resolution_clock::now();
+        for(int i = 0; i < QUERY_REPEATS; i++)
+            found += (t->GetSubcomponentById(last_thread_id, SYS_SAGE_COMPONENT_THREAD) != NULL);
+        t_end = high_resolution_clock::now();
+        uint64_t time_tree_byId = (t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead)/QUERY_REPEATS;
+        t_start = high_resolution_clock::now();
+        for(int i = 0; i < QUERY_REPEATS; i++)
+            found += (f->GetSubcomponentById(last_thread_id, SYS_SAGE_COMPONENT_THREAD) != NULL);
+        t_end = high_resolution_clock::now();
+        uint64_t time_frozen_byId = (t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead)/QUERY_REPEATS;
+
+        //time GetAncestorType for all threads
+        t_start = high_resolution_clock::now();
+        for(Component* thread : threads)
+            found += (thread->GetAncestorType(SYS_SAGE_COMPONENT_CHIP) != NULL);
+        t_end = high_resolution_clock::now();
+        uint64_t time_tree_ancestor = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+        vector<int> thread_idx;
+        for(Component* thread : threads)
+            thread_idx.push_back(f->GetIndex(thread));
+        t_start = high_resolution_clock::now();
+        for(int idx : thread_idx)
+            found += (f->GetAncestorType(idx, SYS_SAGE_COMPONENT_CHIP) != NULL);
+        t_end = high_resolution_clock::now();
+        uint64_t time_frozen_ancestor = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+        //time GetTopoTreeDepth
+        t_start = high_resolution_clock::now();
+        for(int i = 0; i < QUERY_REPEATS; i++)
+            found += t->GetTopoTreeDepth();
+        t_end = high_resolution_clock::now();
+        uint64_t time_tree_depth = (t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead)/QUERY_REPEATS;
+        t_start = high_resolution_clock::now();
+        for(int i = 0; i < QUERY_REPEATS; i++)
+            found += f->GetTopoTreeDepth();
+        t_end = high_resolution_clock::now();
+        uint64_t time_frozen_depth = (t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead)/QUERY_REPEATS;
+
+        cout << "components, " << f->GetNumComponents();
+        cout << ", time_freeze, " << time_freeze;
+        cout << ", time_tree_GetAllSubcomponentsByType, " << time_tree_byType;
+        cout << ", time_frozen_GetAllSubcomponentsByType, " << time_frozen_byType;
+        cout << ", time_tree_GetSubcomponentById, " << time_tree_byId;
+        cout << ", time_frozen_GetSubcomponentById, " << time_frozen_byId;
+        cout << ", time_tree_GetAncestorType, " << time_tree_ancestor;
+        cout << ", time_frozen_GetAncestorType, " << time_frozen_ancestor;
+        cout << ", time_tree_GetTopoTreeDepth, " << time_tree_depth;
+        cout << ", time_frozen_GetTopoTreeDepth, " << time_frozen_depth;
+        cout << ", (checksum " << found << ")" << endl;
+
+        delete f;
+        t->Delete(true);
+    }
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <filesystem>
+#include <sys/resource.h>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_PACKAGES 8
+#define NUM_CORES_PER_PACKAGE 250
+#define NUM_REPEATS 10
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//peak resident set size of this process in kB
+static long GetMaxRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+//writes a synthetic hwloc 2.x XML: NUM_PACKAGES packages with a L3 cache, a NUMA node and NUM_CORES_PER_PACKAGE cores (L2, L1, Core, 2 PUs) each, i.e. 5 objects per core plus the info and cpuset attributes hwloc emits
+static int WriteHwlocXml(string path)
+{
+    ofstream f(path);
+    f << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE topology SYSTEM \"hwloc2.dtd\">\n<topology version=\"2.0\">\n";
+    f << "  <object type=\"Machine\" os_index=\"0\" cpuset=\"0xffffffff\" complete_cpuset=\"0xffffffff\" gp_index=\"1\">\n";
+    f << "    <info name=\"Backend\" value=\"Linux\"/>\n    <info name=\"Architecture\" value=\"x86_64\"/>\n";
+    int objects = 1, gp = 2, pu = 0;
+    for(int p = 0; p < NUM_PACKAGES; p++)
+    {
+        f << "    <object type=\"Package\" os_index=\"" << p << "\" cpuset=\"0x0000ffff\" complete_cpuset=\"0x0000ffff\" nodeset=\"0x00000001\" gp_index=\"" << gp++ << "\">\n";
+        f << "      <info name=\"CPUVendor\" value=\"GenuineIntel\"/>\n      <info name=\"CPUModel\" value=\"Synthetic CPU\"/>\n";
+        f << "      <object type=\"L3Cache\" cpuset=\"0x0000ffff\" complete_cpuset=\"0x0000ffff\" gp_index=\"" << gp++ << "\" cache_size=\"33554432\" depth=\"3\" cache_linesize=\"64\" cache_associativity=\"16\" cache_type=\"0\">\n";
+        f << "        <info name=\"Inclusive\" value=\"0\"/>\n";
+        f << "        <object type=\"NUMANode\" os_index=\"" << p << "\" cpuset=\"0x0000ffff\" complete_cpuset=\"0x0000ffff\" gp_index=\"" << gp++ << "\" local_memory=\"68719476736\">\n";
+        f << "          <page_type size=\"4096\" count=\"0\"/>\n          <page_type size=\"2097152\" count=\"0\"/>\n        </object>\n";
+        objects += 3;
+        for(int c = 0; c < NUM_CORES_PER_PACKAGE; c++)
+        {
+            f << "        <object type=\"L2Cache\" cpuset=\"0x00000003\" complete_cpuset=\"0x00000003\" gp_index=\"" << gp++ << "\" cache_size=\"1048576\" depth=\"2\" cache_linesize=\"64\" cache_associativity=\"16\" cache_type=\"0\">\n";
+            f << "          <info name=\"Inclusive\" value=\"0\"/>\n";
+            f << "          <object type=\"L1Cache\" cpuset=\"0x00000003\" complete_cpuset=\"0x00000003\" gp_index=\"" << gp++ << "\" cache_size=\"32768\" depth=\"1\" cache_linesize=\"64\" cache_associativity=\"8\" cache_type=\"1\">\n";
+            f << "            <object type=\"Core\" os_index=\"" << c << "\" cpuset=\"0x00000003\" complete_cpuset=\"0x00000003\" gp_index=\"" << gp++ << "\">\n";
+            for(int t = 0; t < 2; t++)
+                f << "              <object type=\"PU\" os_index=\"" << pu++ << "\" cpuset=\"0x00000001\" complete_cpuset=\"0x00000001\" gp_index=\"" << gp++ << "\"/>\n";
+            f << "            </object>\n          </object>\n        </object>\n";
+            objects += 5;
+        }
+        f << "      </object>\n    </object>\n";
+    }
+    f << "  </object>\n  <support name=\"discovery.pu\"/>\n</topology>\n";
+    return objects;
+}
+
+//this file benchmarks parsing a synthetic hwloc XML with ~10k objects: parseHwlocOutput (streaming, xmlTextReader) vs. parseHwlocOutputDOM (whole document loaded first)
+int main(int argc, char *argv[])
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    string path = std::filesystem::temp_directory_path() / "sys-sage-hwloc-parser-benchmark.xml";
+    int objects = WriteHwlocXml(path);
+
+    uint64_t time_stream = 0, time_dom = 0;
+    int components = 0;
+    long rss_start = GetMaxRssKb(), rss_stream = 0, rss_dom = 0;
+    //streaming first: the peak RSS only grows, so the DOM peak is measured on top of it
+    for(int i = 0; i < NUM_REPEATS; i++)
+    {
+        Topology* t = new Topology();
+        Node* n = new Node(t, 0);
+        t_start = high_resolution_clock::now();
+        int ret = parseHwlocOutput(n, path);
+        t_end = high_resolution_clock::now();
+        time_stream += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+        if(ret != 0)
+        {
+            cout << "parseHwlocOutput failed" << endl;
+            return 1;
+        }
+        components = n->CountAllSubcomponents();
+        t->Delete(true);
+    }
+    rss_stream = GetMaxRssKb();
+    for(int i = 0; i < NUM_REPEATS; i++)
+    {
+        Topology* t = new Topology();
+        Node* n = new Node(t, 0);
+        t_start = high_resolution_clock::now();
+        int ret = parseHwlocOutputDOM(n, path);
+        t_end = high_resolution_clock::now();
+        time_dom += t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+        if(ret != 0 || n->CountAllSubcomponents() != components)
+        {
+            cout << "parseHwlocOutputDOM failed or produced a different topology" << endl;
+            return 1;
+        }
+        t->Delete(true);
+    }
+    rss_dom = GetMaxRssKb();
+    std::filesystem::remove(path);
+
+    cout << "repeats, " << NUM_REPEATS << ", xml_objects, " << objects << ", components, " << components;
+    cout << ", time_parseHwlocOutput, " << time_stream / NUM_REPEATS;
+    cout << ", time_parseHwlocOutputDOM, " << time_dom / NUM_REPEATS;
+    cout << ", max_rss_kb_start, " << rss_start << ", max_rss_kb_stream, " << rss_stream << ", max_rss_kb_dom, " << rss_dom << endl;
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <chrono>
+#include <unordered_set>
+
+#include "sys-sage.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//PARAMS TO SET
+#define TIMER_WARMUP 32
+#define TIMER_REPEATS 128
+#define NUM_NODES 2000
+
+////////////////////////////////////////////////////////////////////////
+using namespace std::chrono;
+
+uint64_t get_timer_overhead(int repeats, int warmup);
+
+//number of distinct Component objects in the subtree of root (each shared component counted once)
+size_t count_unique_components(Component* root)
+{
+    vector<Component*> components;
+    root->GetSubtreeNodeList(&components);
+    return std::unordered_set<Component*>(components.begin(), components.end()).size();
+}
+
+//this file benchmarks a homogeneous cluster of NUM_NODES identical Nodes: parsing the hwloc XML for each Node vs parsing it once and sharing the Chip subtrees
+int main(int argc, char *argv[])
+{
+    std::string path_prefix(argv[0]);
+    std::size_t found = path_prefix.find_last_of("/\\");
+    path_prefix=path_prefix.substr(0,found) + "/";
+    string topoPath = path_prefix + "example_data/skylake_hwloc.xml";
+
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t timer_overhead = get_timer_overhead(TIMER_REPEATS, TIMER_WARMUP);
+
+    //parse each Node
+    t_start = high_resolution_clock::now();
+    Topology* t = new Topology();
+    for(int i = 0; i < NUM_NODES; i++)
+    {
+        if(parseHwlocOutput(new Node(t, i), topoPath) != 0)
+        {
+            cout << "failed parsing hwloc output" << endl;
+            return 1;
+        }
+    }
+    t_end = high_resolution_clock::now();
+    uint64_t time_parse_all = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    int num_components = t->CountAllSubcomponents();
+    size_t unique_parse_all = count_unique_components(t);
+
+    //deduplicate the parsed topology
+    t_start = high_resolution_clock::now();
+    int deleted = t->ShareIdenticalSubtrees();
+    t_end = high_resolution_clock::now();
+    uint64_t time_share = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    size_t unique_shared = count_unique_components(t);
+    int num_components_shared = t->CountAllSubcomponents();
+    t->Delete(true);
+
+    //parse once, share the subtrees of the first Node
+    t_start = high_resolution_clock::now();
+    t = new Topology();
+    Node* first = new Node(t, 0);
+    if(parseHwlocOutput(first, topoPath) != 0)
+    {
+        cout << "failed parsing hwloc output" << endl;
+        return 1;
+    }
+    for(int i = 1; i < NUM_NODES; i++)
+    {
+        Node* n = new Node(t, i);
+        for(Component* c : *first->GetChildren())
+            n->InsertSharedChild(c);
+    }
+    t_end = high_resolution_clock::now();
+    uint64_t time_parse_once = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    size_t unique_parse_once = count_unique_components(t);
+
+    //copy-on-write of a single Thread of the last Node
+    Node* last = (Node*)t->GetChild(NUM_NODES - 1);
+    t_start = high_resolution_clock::now();
+    Component* thread = last->Unshare(last->GetSubcomponentById(0, SYS_SAGE_COMPONENT_THREAD));
+    t_end = high_resolution_clock::now();
+    uint64_t time_unshare = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+    if(thread == NULL)
+        return 1;
+
+    t_start = high_resolution_clock::now();
+    t->Delete(true);
+    t_end = high_resolution_clock::now();
+    uint64_t time_teardown_shared = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
+
+    cout << "nodes, " << NUM_NODES << ", components, " << num_components << ", components_shared, " << num_components_shared;
+    cout << ", unique_components_parse_all, " << unique_parse_all << ", unique_components_shared, " << unique_shared << ", unique_components_parse_once, " << unique_parse_once << ", deleted, " << deleted;
+    cout << ", time_parse_all, " << time_parse_all;
+    cout << ", time_share, " << time_share;
+    cout << ", time_parse_once, " << time_parse_once;
+    cout << ", time_unshare, " << time_unshare;
+    cout << ", time_teardown_shared, " << time_teardown_shared << endl;
+
+    return 0;
+}
+
+uint64_t get_timer_overhead(int repeats, int warmup)
+{
+    high_resolution_clock::time_point t_start, t_end;
+    uint64_t time = 0;
+    for(int i=0; i<repeats+warmup; i++)
+    {
+        t_start = high_resolution_clock::now();
+        t_end = high_resolution_clock::now();
+        if(i>=warmup)
+            time += t_end.time_since_epoch().count()-t_start.time_since_epoch().count();
+    }
+    time = time/repeats;
+    return time;
+}
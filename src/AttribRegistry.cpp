@@ -0,0 +1,267 @@
+#include "AttribRegistry.hpp"
+
+#include <deque>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+//descriptors of the built-in types; the value pointers are as returned by AttribStore::Entry::GetData()
+
+template<class T> static std::string NumberToString(void* value) { return std::to_string(*(T*)value); }
+template<class T> static size_t NumberSize(void*) { return sizeof(T); }
+template<class T> static void NumberSerialize(void* value, char* dst) { memcpy(dst, value, sizeof(T)); }
+template<class T> static void NumberDeserialize(AttribStore* store, const AttribKey& key, const char* src, size_t size)
+{
+    T val;
+    memcpy(&val, src, sizeof(T));
+    store->Set(key, val);
+}
+
+static std::string StringToString(void* value) { return *(std::string*)value; }
+static size_t StringSize(void* value) { return ((std::string*)value)->size(); }
+static void StringSerialize(void* value, char* dst) { memcpy(dst, ((std::string*)value)->data(), ((std::string*)value)->size()); }
+static void StringDeserialize(AttribStore* store, const AttribKey& key, const char* src, size_t size) { store->Set(key, std::string(src, size)); }
+
+static std::string FreqHistoryToString(void* value)
+{
+    std::string ret;
+    for(auto [ ts,freq ] : *(AttribFreqHistory*)value)
+        ret += "(" + std::to_string(ts) + "," + std::to_string(freq) + ")";
+    return ret;
+}
+static void FreqHistoryToXml(const std::string& key, void* value, xmlNodePtr n)
+{
+    xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
+    xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
+    xmlAddChild(n, attrib_node);
+    for(auto [ ts,freq ] : *(AttribFreqHistory*)value)
+    {
+        xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
+        xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(ts).c_str());
+        xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
+        xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)"MHz");
+        xmlAddChild(attrib_node, attrib);
+    }
+}
+static size_t FreqHistorySize(void* value) { return ((AttribFreqHistory*)value)->size() * (sizeof(long long) + sizeof(double)); }
+static void FreqHistorySerialize(void* value, char* dst)
+{
+    for(auto [ ts,freq ] : *(AttribFreqHistory*)value)
+    {
+        memcpy(dst, &ts, sizeof(long long));
+        memcpy(dst + sizeof(long long), &freq, sizeof(double));
+        dst += sizeof(long long) + sizeof(double);
+    }
+}
+static void FreqHistoryDeserialize(AttribStore* store, const AttribKey& key, const char* src, size_t size)
+{
+    AttribFreqHistory val;
+    for(size_t i = 0; i + sizeof(long long) + sizeof(double) <= size; i += sizeof(long long) + sizeof(double))
+    {
+        long long ts;
+        double freq;
+        memcpy(&ts, src + i, sizeof(long long));
+        memcpy(&freq, src + i + sizeof(long long), sizeof(double));
+        val.push_back(std::make_tuple(ts, freq));
+    }
+    store->Set(key, std::move(val));
+}
+
+static std::string ValueUnitToString(void* value)
+{
+    auto& [ val, unit ] = *(AttribValueUnit*)value;
+    return std::to_string(val) + " " + unit;
+}
+static void ValueUnitToXml(const std::string& key, void* value, xmlNodePtr n)
+{
+    xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
+    xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
+    xmlAddChild(n, attrib_node);
+
+    auto& [ freq, unit ] = *(AttribValueUnit*)value;
+    xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
+    xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
+    xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)unit.c_str());
+    xmlAddChild(attrib_node, attrib);
+}
+static size_t ValueUnitSize(void* value) { return sizeof(double) + std::get<1>(*(AttribValueUnit*)value).size(); }
+static void ValueUnitSerialize(void* value, char* dst)
+{
+    auto& [ val, unit ] = *(AttribValueUnit*)value;
+    memcpy(dst, &val, sizeof(double));
+    memcpy(dst + sizeof(double), unit.data(), unit.size());
+}
+static void ValueUnitDeserialize(AttribStore* store, const AttribKey& key, const char* src, size_t size)
+{
+    double val;
+    memcpy(&val, src, sizeof(double));
+    store->Set(key, AttribValueUnit(val, std::string(src + sizeof(double), size - sizeof(double))));
+}
+
+static std::string TimeSeriesToString(void* value)
+{
+    std::vector<AttribTimeSeries::Sample> samples;
+    ((AttribTimeSeries*)value)->GetSamples(&samples);
+    std::string ret;
+    for(const AttribTimeSeries::Sample& s : samples)
+        ret += "(" + std::to_string(s.timestamp) + "," + std::to_string(s.value) + ")";
+    return ret;
+}
+static void TimeSeriesToXml(const std::string& key, void* value, xmlNodePtr n)
+{
+    AttribTimeSeries* ts = (AttribTimeSeries*)value;
+    xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
+    xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
+    xmlNewProp(attrib_node, (const unsigned char *)"capacity", (const unsigned char *)std::to_string(ts->GetCapacity()).c_str());
+    xmlAddChild(n, attrib_node);
+    std::vector<AttribTimeSeries::Sample> samples;
+    ts->GetSamples(&samples);
+    for(const AttribTimeSeries::Sample& s : samples)
+    {
+        xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
+        xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(s.timestamp).c_str());
+        xmlNewProp(attrib, (const unsigned char *)"value", (const unsigned char *)std::to_string(s.value).c_str());
+        xmlAddChild(attrib_node, attrib);
+    }
+}
+//layout: capacity (size_t) | number of samples n (size_t) | capacity slots of (timestamp, value), the first n hold the samples, oldest first
+//the space is reserved for the capacity, so that the size does not depend on the number of samples -- Append() may run concurrently (and a history that is refreshed periodically is full most of the time anyway)
+#define TIME_SERIES_SAMPLE_SIZE (sizeof(long long) + sizeof(double))
+static size_t TimeSeriesSize(void* value) { return 2 * sizeof(size_t) + ((AttribTimeSeries*)value)->GetCapacity() * TIME_SERIES_SAMPLE_SIZE; }
+static void TimeSeriesSerialize(void* value, char* dst)
+{
+    AttribTimeSeries* ts = (AttribTimeSeries*)value;
+    size_t capacity = ts->GetCapacity();
+    std::vector<AttribTimeSeries::Sample> samples;
+    size_t n = ts->GetSamples(&samples); //one snapshot, at most capacity samples
+    memcpy(dst, &capacity, sizeof(size_t));
+    memcpy(dst + sizeof(size_t), &n, sizeof(size_t));
+    dst += 2 * sizeof(size_t);
+    for(const AttribTimeSeries::Sample& s : samples)
+    {
+        memcpy(dst, &s.timestamp, sizeof(long long));
+        memcpy(dst + sizeof(long long), &s.value, sizeof(double));
+        dst += TIME_SERIES_SAMPLE_SIZE;
+    }
+    memset(dst, 0, (capacity - n) * TIME_SERIES_SAMPLE_SIZE);
+}
+static void TimeSeriesDeserialize(AttribStore* store, const AttribKey& key, const char* src, size_t size)
+{
+    if(size < 2 * sizeof(size_t))
+        return;
+    size_t capacity, n;
+    memcpy(&capacity, src, sizeof(size_t));
+    memcpy(&n, src + sizeof(size_t), sizeof(size_t));
+    n = std::min(n, (size - 2 * sizeof(size_t)) / TIME_SERIES_SAMPLE_SIZE);
+    AttribTimeSeries val(capacity);
+    src += 2 * sizeof(size_t);
+    for(size_t i = 0; i < n; i++, src += TIME_SERIES_SAMPLE_SIZE)
+    {
+        long long ts;
+        double v;
+        memcpy(&ts, src, sizeof(long long));
+        memcpy(&v, src + sizeof(long long), sizeof(double));
+        val.Append(ts, v);
+    }
+    store->Set(key, std::move(val));
+}
+
+//index = SYS_SAGE_ATTRIB_TYPE_*
+static const AttribTypeDescriptor typeDescriptors[] = {
+    {SYS_SAGE_ATTRIB_TYPE_NONE, NULL, NULL, NULL, NULL, NULL},
+    {SYS_SAGE_ATTRIB_TYPE_VOIDPTR, NULL, NULL, NULL, NULL, NULL},
+    {SYS_SAGE_ATTRIB_TYPE_INT, NumberToString<int>, NULL, NumberSize<int>, NumberSerialize<int>, NumberDeserialize<int>},
+    {SYS_SAGE_ATTRIB_TYPE_LONGLONG, NumberToString<long long>, NULL, NumberSize<long long>, NumberSerialize<long long>, NumberDeserialize<long long>},
+    {SYS_SAGE_ATTRIB_TYPE_UINT64, NumberToString<uint64_t>, NULL, NumberSize<uint64_t>, NumberSerialize<uint64_t>, NumberDeserialize<uint64_t>},
+    {SYS_SAGE_ATTRIB_TYPE_DOUBLE, NumberToString<double>, NULL, NumberSize<double>, NumberSerialize<double>, NumberDeserialize<double>},
+    {SYS_SAGE_ATTRIB_TYPE_FLOAT, NumberToString<float>, NULL, NumberSize<float>, NumberSerialize<float>, NumberDeserialize<float>},
+    {SYS_SAGE_ATTRIB_TYPE_STRING, StringToString, NULL, StringSize, StringSerialize, StringDeserialize},
+    {SYS_SAGE_ATTRIB_TYPE_FREQ_HISTORY, FreqHistoryToString, FreqHistoryToXml, FreqHistorySize, FreqHistorySerialize, FreqHistoryDeserialize},
+    {SYS_SAGE_ATTRIB_TYPE_VALUE_UNIT, ValueUnitToString, ValueUnitToXml, ValueUnitSize, ValueUnitSerialize, ValueUnitDeserialize},
+    {SYS_SAGE_ATTRIB_TYPE_TIME_SERIES, TimeSeriesToString, TimeSeriesToXml, TimeSeriesSize, TimeSeriesSerialize, TimeSeriesDeserialize},
+};
+static const int numTypeDescriptors = sizeof(typeDescriptors) / sizeof(typeDescriptors[0]);
+
+struct KeyDescriptors {
+    std::vector<const AttribTypeDescriptor*> byKey; /**< index = interned key id */
+    std::deque<AttribTypeDescriptor> custom; /**< storage of user-registered descriptors */
+
+    void Set(unsigned int keyId, const AttribTypeDescriptor* descriptor)
+    {
+        if(keyId >= byKey.size())
+            byKey.resize(keyId + 1, NULL);
+        byKey[keyId] = descriptor;
+    }
+};
+
+//function-local static -- initialized (with the keys used by sys-sage) on first use
+static KeyDescriptors& GetKeyDescriptors()
+{
+    static KeyDescriptors descriptors = []{
+        KeyDescriptors d;
+        for(const char* key : {"CATcos", "CATL3mask"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_UINT64]);
+        for(const char* key : {"mig_size"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_LONGLONG]);
+        for(const char* key : {"Number_of_streaming_multiprocessors", "Number_of_cores_in_GPU", "Number_of_cores_per_SM", "Bus_Width_bit"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_INT]);
+        for(const char* key : {"Clock_Frequency"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_DOUBLE]);
+        for(const char* key : {"latency", "latency_min", "latency_max"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_FLOAT]);
+        for(const char* key : {"CUDA_compute_capability", "mig_uuid"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_STRING]);
+        for(const char* key : {"freq_history", "CATL3mask_history", "mig_size_history"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_TIME_SERIES]);
+        for(const char* key : {"GPU_Clock_Rate"})
+            d.Set(AttribKey(key).GetId(), &typeDescriptors[SYS_SAGE_ATTRIB_TYPE_VALUE_UNIT]);
+        return d;
+    }();
+    return descriptors;
+}
+
+void AttribRegistry::RegisterKey(const AttribKey& key, const AttribTypeDescriptor& descriptor)
+{
+    KeyDescriptors& d = GetKeyDescriptors();
+    d.custom.push_back(descriptor);
+    d.Set(key.GetId(), &d.custom.back());
+}
+
+int AttribRegistry::RegisterKey(const AttribKey& key, int type)
+{
+    if(type <= SYS_SAGE_ATTRIB_TYPE_VOIDPTR || type >= numTypeDescriptors)
+        return 1;
+    GetKeyDescriptors().Set(key.GetId(), &typeDescriptors[type]);
+    return 0;
+}
+
+const AttribTypeDescriptor* AttribRegistry::GetKeyDescriptor(unsigned int keyId)
+{
+    KeyDescriptors& d = GetKeyDescriptors();
+    return keyId < d.byKey.size() ? d.byKey[keyId] : NULL;
+}
+
+const AttribTypeDescriptor* AttribRegistry::GetTypeDescriptor(int type)
+{
+    if(type <= SYS_SAGE_ATTRIB_TYPE_VOIDPTR || type >= numTypeDescriptors)
+        return NULL;
+    return &typeDescriptors[type];
+}
+
+void AttribRegistry::CloneAttribs(const AttribStore& src, AttribStore* dst)
+{
+    *dst = src;
+    for(const AttribStore::Entry& e : src.GetEntries())
+    {
+        if(e.GetType() != SYS_SAGE_ATTRIB_TYPE_VOIDPTR || e.GetData() == NULL)
+            continue;
+        const AttribTypeDescriptor* d = GetKeyDescriptor(e.key);
+        if(d == NULL || d->size == NULL || d->serialize == NULL || d->deserialize == NULL)
+            continue;
+        std::vector<char> buf(d->size(e.GetData()));
+        d->serialize(e.GetData(), buf.data());
+        AttribKey key(*e.name);
+        dst->Remove(key);
+        d->deserialize(dst, key, buf.data(), buf.size());
+    }
+}
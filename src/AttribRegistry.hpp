@@ -0,0 +1,69 @@
+#ifndef ATTRIB_REGISTRY
+#define ATTRIB_REGISTRY
+
+#include <string>
+
+#include <libxml/tree.h>
+
+#include "AttribStore.hpp"
+
+/**
+Describes how attribute values of one type are printed and (de)serialized. Used by exportToXml(), export_topology()/import_topology() (shared memory) and DataPath::Print().
+\n All callbacks receive a pointer to the value (as returned by AttribStore::Entry::GetData()).
+*/
+struct AttribTypeDescriptor {
+    int type; /**< SYS_SAGE_ATTRIB_TYPE_* of the values; SYS_SAGE_ATTRIB_TYPE_VOIDPTR for user-defined types stored as untyped pointers */
+    std::string (*toString)(void* value); /**< value as a string (XML "value" attribute, Print()); required */
+    void (*toXml)(const std::string& key, void* value, xmlNodePtr n); /**< (optional) adds an <Attribute> node with child nodes to n; if NULL, toString() is used for the XML export */
+    size_t (*size)(void* value); /**< (optional) serialized size in bytes; if NULL, the attribute is not exported to shared memory */
+    void (*serialize)(void* value, char* dst); /**< (optional) writes size(value) bytes to dst */
+    void (*deserialize)(AttribStore* store, const AttribKey& key, const char* src, size_t size); /**< (optional) re-creates the attribute in store from the serialized bytes */
+};
+
+/**
+Class AttribRegistry - process-wide mapping of attribute value types and attribute keys to their AttribTypeDescriptor.
+\n Typed attributes (see AttribStore::Set()) are handled by the descriptor of their type. Attributes stored as untyped pointers are handled by the descriptor registered for their key -- the keys used by sys-sage itself (e.g. "CATcos", "mig_size", "freq_history") are registered by default; custom keys should be registered once at startup with RegisterKey().
+\n Lookups are O(1) (indexed by the type or the interned key id). Registration is not thread-safe and should happen before the topology is used concurrently.
+*/
+class AttribRegistry {
+public:
+    /**
+    Registers (or replaces) the descriptor of an attribute key. Affects untyped (void*) attributes with this key.
+    @param key - the attribute key
+    @param descriptor - how to print and (de)serialize the values of this key
+    */
+    static void RegisterKey(const AttribKey& key, const AttribTypeDescriptor& descriptor);
+    /**
+    Registers an attribute key whose untyped (void*) values are of one of the built-in types (e.g. RegisterKey("rack_no", SYS_SAGE_ATTRIB_TYPE_INT)). Imported values are re-created as typed values.
+    @param key - the attribute key
+    @param type - SYS_SAGE_ATTRIB_TYPE_* (not SYS_SAGE_ATTRIB_TYPE_VOIDPTR)
+    @return 0 on success, 1 if the type is unknown
+    */
+    static int RegisterKey(const AttribKey& key, int type);
+    /**
+    @returns the descriptor registered for the key, or NULL
+    */
+    static const AttribTypeDescriptor* GetKeyDescriptor(unsigned int keyId);
+    /**
+    @returns the descriptor of a built-in type (SYS_SAGE_ATTRIB_TYPE_*), or NULL
+    */
+    static const AttribTypeDescriptor* GetTypeDescriptor(int type);
+    /**
+    Copies all attributes of src to dst (replacing the attributes of dst). Typed values are deep-copied; untyped pointers whose key has a descriptor with serialize() and deserialize() are re-created as owned values through the descriptor, other untyped pointers are copied as pointers (i.e. shared with src).
+    @param src - the attributes to copy
+    @param dst - the destination
+    */
+    static void CloneAttribs(const AttribStore& src, AttribStore* dst);
+    /**
+    @returns the descriptor handling the attribute: the type descriptor for typed values, the key descriptor for untyped pointers; NULL if there is none
+    */
+    static const AttribTypeDescriptor* GetDescriptor(const AttribStore::Entry& entry)
+    {
+        int type = entry.GetType();
+        if(type == SYS_SAGE_ATTRIB_TYPE_VOIDPTR)
+            return GetKeyDescriptor(entry.key);
+        return GetTypeDescriptor(type);
+    }
+};
+
+#endif
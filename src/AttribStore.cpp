@@ -0,0 +1,201 @@
+#include "AttribStore.hpp"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <algorithm>
+
+//function-local statics, so that static AttribKey objects in other translation units can be initialized in any order
+static std::shared_mutex& InternMutex()
+{
+    static std::shared_mutex m;
+    return m;
+}
+static std::unordered_map<std::string, unsigned int>& InternIds()
+{
+    static std::unordered_map<std::string, unsigned int> ids;
+    return ids;
+}
+static std::deque<std::string>& InternNames()
+{
+    static std::deque<std::string> names; //deque -- references stay valid when new keys are added
+    return names;
+}
+
+AttribKey::AttribKey(const std::string& _name)
+{
+    {
+        //keys are mostly interned already -- look them up under the shared lock first
+        std::shared_lock<std::shared_mutex> lock(InternMutex());
+        auto it = InternIds().find(_name);
+        if(it != InternIds().end())
+        {
+            id = it->second;
+            name = &InternNames()[id];
+            return;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(InternMutex());
+    auto [it, inserted] = InternIds().try_emplace(_name, InternNames().size());
+    if(inserted)
+        InternNames().push_back(_name);
+    id = it->second;
+    name = &InternNames()[id];
+}
+AttribKey::AttribKey(const char* _name): AttribKey(std::string(_name)) {}
+
+bool AttribKey::Find(const std::string& name, unsigned int* id)
+{
+    std::shared_lock<std::shared_mutex> lock(InternMutex());
+    auto it = InternIds().find(name);
+    if(it == InternIds().end())
+        return false;
+    *id = it->second;
+    return true;
+}
+
+void* AttribStore::Entry::GetData() const
+{
+    return std::visit([](auto& v) -> void* {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, std::monostate>)
+            return NULL;
+        else if constexpr (std::is_same_v<V, void*>)
+            return v;
+        else if constexpr (std::is_arithmetic_v<V>)
+            return (void*)&v;
+        else
+            return (void*)v.get();
+    }, value);
+}
+
+AttribStore::AttribStore(const AttribStore& other)
+{
+    *this = other;
+}
+
+AttribStore& AttribStore::operator=(const AttribStore& other)
+{
+    if(this == &other)
+        return *this;
+    entries.clear();
+    entries.reserve(other.entries.size());
+    for(const Entry& e : other.entries)
+    {
+        Value v = std::visit([](auto& x) -> Value {
+            using V = std::decay_t<decltype(x)>;
+            if constexpr (std::is_same_v<V, std::monostate> || std::is_same_v<V, void*> || std::is_arithmetic_v<V>)
+                return x;
+            else
+                return std::make_unique<typename V::element_type>(*x);
+        }, e.value);
+        entries.push_back({e.key, e.name, std::move(v)});
+    }
+    return *this;
+}
+
+int AttribStore::FindIndex(unsigned int key) const
+{
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        if(entries[i].key == key)
+            return i;
+    }
+    return -1;
+}
+
+int AttribStore::FindIndex(const std::string& key) const
+{
+    unsigned int id;
+    if(entries.empty() || !AttribKey::Find(key, &id))
+        return -1;
+    return FindIndex(id);
+}
+
+size_t AttribStore::FindOrInsert(const AttribKey& key)
+{
+    int idx = FindIndex(key.GetId());
+    if(idx >= 0)
+        return idx;
+    auto it = std::lower_bound(entries.begin(), entries.end(), key.GetName(), [](const Entry& e, const std::string& name){ return *e.name < name; });
+    it = entries.insert(it, Entry{key.GetId(), &key.GetName(), std::monostate()});
+    return it - entries.begin();
+}
+
+AttribTimeSeries* AttribStore::AppendSample(const AttribKey& key, long long timestamp, double value, size_t capacity)
+{
+    AttribTimeSeries* ts = Get<AttribTimeSeries>(key);
+    if(ts == NULL)
+    {
+        Entry& e = entries[FindOrInsert(key)];
+        e.value = std::make_unique<AttribTimeSeries>(capacity);
+        ts = std::get<std::unique_ptr<AttribTimeSeries> >(e.value).get();
+    }
+    ts->Append(timestamp, value);
+    return ts;
+}
+
+int AttribStore::GetType(const AttribKey& key)
+{
+    int idx = FindIndex(key.GetId());
+    if(idx < 0)
+        return SYS_SAGE_ATTRIB_TYPE_NONE;
+    return entries[idx].GetType();
+}
+
+int AttribStore::GetType(const std::string& key)
+{
+    int idx = FindIndex(key);
+    if(idx < 0)
+        return SYS_SAGE_ATTRIB_TYPE_NONE;
+    return entries[idx].GetType();
+}
+
+int AttribStore::Remove(const AttribKey& key)
+{
+    int idx = FindIndex(key.GetId());
+    if(idx < 0)
+        return 0;
+    entries.erase(entries.begin() + idx);
+    return 1;
+}
+
+AttribStore::reference AttribStore::operator[](const std::string& key)
+{
+    size_t idx = FindOrInsert(AttribKey(key));
+    if(entries[idx].GetType() == SYS_SAGE_ATTRIB_TYPE_NONE)
+        entries[idx].value = (void*)NULL;
+    return reference(this, idx);
+}
+
+std::pair<AttribStore::iterator,bool> AttribStore::insert(const std::pair<std::string, void*>& kv)
+{
+    size_t idx = FindOrInsert(AttribKey(kv.first));
+    bool inserted = entries[idx].GetType() == SYS_SAGE_ATTRIB_TYPE_NONE;
+    if(inserted)
+        entries[idx].value = kv.second;
+    return {iterator(entries.begin() + idx), inserted};
+}
+
+AttribStore::iterator AttribStore::find(const std::string& key) const
+{
+    int idx = FindIndex(key);
+    if(idx < 0)
+        return end();
+    return iterator(entries.begin() + idx);
+}
+
+size_t AttribStore::count(const std::string& key) const
+{
+    return FindIndex(key) < 0 ? 0 : 1;
+}
+
+size_t AttribStore::erase(const std::string& key)
+{
+    int idx = FindIndex(key);
+    if(idx < 0)
+        return 0;
+    entries.erase(entries.begin() + idx);
+    return 1;
+}
@@ -0,0 +1,269 @@
+#ifndef ATTRIB_STORE
+#define ATTRIB_STORE
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <variant>
+#include <utility>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+
+#include "AttribTimeSeries.hpp"
+
+#define SYS_SAGE_ATTRIB_TYPE_NONE 0 /**< No value (key not present). */
+#define SYS_SAGE_ATTRIB_TYPE_VOIDPTR 1 /**< Untyped pointer stored through the map-like (void*) API. The pointee is owned by the user. */
+#define SYS_SAGE_ATTRIB_TYPE_INT 2 /**< int */
+#define SYS_SAGE_ATTRIB_TYPE_LONGLONG 3 /**< long long */
+#define SYS_SAGE_ATTRIB_TYPE_UINT64 4 /**< uint64_t */
+#define SYS_SAGE_ATTRIB_TYPE_DOUBLE 5 /**< double */
+#define SYS_SAGE_ATTRIB_TYPE_FLOAT 6 /**< float */
+#define SYS_SAGE_ATTRIB_TYPE_STRING 7 /**< std::string */
+#define SYS_SAGE_ATTRIB_TYPE_FREQ_HISTORY 8 /**< AttribFreqHistory, i.e. std::vector<std::tuple<long long,double>> (timestamp, value) */
+#define SYS_SAGE_ATTRIB_TYPE_VALUE_UNIT 9 /**< AttribValueUnit, i.e. std::tuple<double,std::string> (value, unit) */
+#define SYS_SAGE_ATTRIB_TYPE_TIME_SERIES 10 /**< AttribTimeSeries (fixed-capacity ring buffer of timestamped values) */
+
+using AttribFreqHistory = std::vector<std::tuple<long long,double> >;
+using AttribValueUnit = std::tuple<double,std::string>;
+
+/**
+Interned attribute key. Each distinct key string is mapped to a small integer id once (process-wide), so that attribute lookups compare integers instead of strings.
+\n Creating an AttribKey takes a process-wide lock and a hash lookup, so keys that are used often should be created once (e.g. as a static const AttribKey) and reused. Lookups by a key string (e.g. attrib.Get<int>("key")) do not intern the key; setting an attribute does.
+*/
+class AttribKey {
+public:
+    /**
+    Interns the key (if not interned yet).
+    @param name - the key string
+    */
+    AttribKey(const std::string& name);
+    AttribKey(const char* name);
+    /**
+    @returns the interned id of the key
+    */
+    unsigned int GetId() const { return id; }
+    /**
+    @returns the key string
+    */
+    const std::string& GetName() const { return *name; }
+    bool operator==(const AttribKey& other) const { return id == other.id; }
+    /**
+    Looks up an already interned key without interning it.
+    @param name - the key string
+    @param id - output parameter; the id of the key, if found
+    @returns true if the key has been interned before
+    */
+    static bool Find(const std::string& name, unsigned int* id);
+
+private:
+    unsigned int id;
+    const std::string* name; /**< points to the process-wide interned string */
+};
+
+/**
+@private
+Maps the supported value types to SYS_SAGE_ATTRIB_TYPE_*; non-arithmetic values are stored boxed (owned by the AttribStore).
+*/
+template<class T> struct AttribTraits { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_NONE; };
+template<> struct AttribTraits<int> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_INT; };
+template<> struct AttribTraits<long long> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_LONGLONG; };
+template<> struct AttribTraits<uint64_t> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_UINT64; };
+template<> struct AttribTraits<double> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_DOUBLE; };
+template<> struct AttribTraits<float> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_FLOAT; };
+template<> struct AttribTraits<std::string> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_STRING; };
+template<> struct AttribTraits<AttribFreqHistory> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_FREQ_HISTORY; };
+template<> struct AttribTraits<AttribValueUnit> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_VALUE_UNIT; };
+template<> struct AttribTraits<AttribTimeSeries> { static constexpr int type = SYS_SAGE_ATTRIB_TYPE_TIME_SERIES; };
+
+/**
+Class AttribStore - typed attribute storage of Components and DataPaths (Component::attrib, DataPath::attrib).
+\n The attributes are kept in a small flat array ordered by the key string (i.e. iterated in the same order as a std::map<string,void*>). Keys are interned (see AttribKey) and looked up by their integer id.
+\n Values of the types int, long long, uint64_t, double, float, std::string, AttribFreqHistory, AttribValueUnit and AttribTimeSeries are stored typed and owned by the store (set with Set(), read with Get()). Numeric values are stored inline, the others in an owned heap object.
+\n For compatibility, the store also provides the std::map<string,void*> interface (operator[], insert, find, count, erase, iteration yielding std::pair<const string&, void*>). Values set through it are stored as untyped pointers (SYS_SAGE_ATTRIB_TYPE_VOIDPTR) which are not owned by the store; typed values are returned as a pointer to the stored value.
+\n WARNING: unlike with the std::map used before, pointers to numeric values (returned by Set(), Get() or the map-like API for int, long long, uint64_t, double and float) are only valid until an attribute is added to or removed from the same store -- the values are stored inline in the array, which is reallocated/shifted on insertion and removal. Do not keep such pointers across Set() of a new key, AppendSample() creating a time series, Remove(), operator[] or insert(); copy the value instead. Pointers to the other (boxed) typed values and untyped (void*) pointers stay valid until their own attribute is removed or replaced by a value of another type.
+*/
+class AttribStore {
+public:
+    /**
+    @private
+    Stored value; the alternative index equals the SYS_SAGE_ATTRIB_TYPE_* of the value.
+    */
+    using Value = std::variant<std::monostate, void*, int, long long, uint64_t, double, float, std::unique_ptr<std::string>, std::unique_ptr<AttribFreqHistory>, std::unique_ptr<AttribValueUnit>, std::unique_ptr<AttribTimeSeries> >;
+
+    /**
+    One attribute (key and value).
+    */
+    struct Entry {
+        unsigned int key; /**< interned key id */
+        const std::string* name; /**< key string */
+        Value value;
+
+        /**
+        @returns SYS_SAGE_ATTRIB_TYPE_* of the value
+        */
+        int GetType() const { return value.index(); }
+        /**
+        @returns pointer to the value (for SYS_SAGE_ATTRIB_TYPE_VOIDPTR the stored pointer itself)
+        */
+        void* GetData() const;
+    };
+
+    AttribStore() = default;
+    AttribStore(const AttribStore& other);
+    AttribStore& operator=(const AttribStore& other);
+    AttribStore(AttribStore&& other) = default;
+    AttribStore& operator=(AttribStore&& other) = default;
+
+    /**
+    Sets a typed attribute. An existing attribute with the same key is replaced; if it has the same type, its value is overwritten in place (pointers to it stay valid).
+    @param key - the key
+    @param value - the value (int, long long, uint64_t, double, float, std::string, AttribFreqHistory, AttribValueUnit or AttribTimeSeries)
+    @returns pointer to the stored value
+    */
+    template<class T> T* Set(const AttribKey& key, T value)
+    {
+        static_assert(AttribTraits<T>::type != SYS_SAGE_ATTRIB_TYPE_NONE, "unsupported attribute type; use the map-like (void*) interface for custom types");
+        Entry& e = entries[FindOrInsert(key)];
+        if constexpr (std::is_arithmetic_v<T>) {
+            e.value = value;
+            return &std::get<T>(e.value);
+        } else if (std::holds_alternative<std::unique_ptr<T> >(e.value)) {
+            //same type -- reuse the owned object (e.g. the string buffer) instead of allocating a new one
+            T* stored = std::get<std::unique_ptr<T> >(e.value).get();
+            *stored = std::move(value);
+            return stored;
+        } else {
+            e.value = std::make_unique<T>(std::move(value));
+            return std::get<std::unique_ptr<T> >(e.value).get();
+        }
+    }
+    /**
+    Sets a std::string attribute.
+    */
+    std::string* Set(const AttribKey& key, const char* value) { return Set(key, std::string(value)); }
+    /**
+    Appends a sample to the AttribTimeSeries attribute; creates the time series if there is none (an attribute of another type with the same key is replaced).
+    @param key - the key
+    @param timestamp - timestamp of the sample
+    @param value - value of the sample
+    @param capacity - (optional) capacity of a newly created time series
+    @returns pointer to the stored time series
+    @see AttribTimeSeries::Append()
+    */
+    AttribTimeSeries* AppendSample(const AttribKey& key, long long timestamp, double value, size_t capacity = SYS_SAGE_TIME_SERIES_DEFAULT_CAPACITY);
+    /**
+    Returns a typed attribute.
+    @param key - the key
+    @returns pointer to the stored value, or NULL if there is no attribute with this key or the value is of a different type
+    */
+    template<class T> T* Get(const AttribKey& key) { return GetAt<T>(FindIndex(key.GetId())); }
+    /**
+    Returns a typed attribute; the key string is looked up without interning it (use a static const AttribKey for frequent lookups).
+    */
+    template<class T> T* Get(const std::string& key) { return GetAt<T>(FindIndex(key)); }
+    template<class T> T* Get(const char* key) { return GetAt<T>(FindIndex(std::string(key))); }
+    /**
+    @returns SYS_SAGE_ATTRIB_TYPE_* of the attribute, or SYS_SAGE_ATTRIB_TYPE_NONE if there is no attribute with this key
+    */
+    int GetType(const AttribKey& key);
+    int GetType(const std::string& key);
+    int GetType(const char* key) { return GetType(std::string(key)); }
+    /**
+    Removes an attribute. Typed values are destroyed; untyped pointers are not freed.
+    @returns 1 if the attribute was removed, 0 if there was none
+    */
+    int Remove(const AttribKey& key);
+    int Remove(const std::string& key) { return erase(key); }
+    int Remove(const char* key) { return erase(std::string(key)); }
+    /**
+    @returns all attributes, ordered by the key string
+    */
+    const std::vector<Entry>& GetEntries() const { return entries; }
+
+    //std::map<string,void*>-like interface
+
+    using key_type = std::string;
+    using mapped_type = void*;
+    using value_type = std::pair<const std::string&, void*>;
+    using size_type = size_t;
+
+    /**
+    Proxy returned by operator[]; converts to any pointer type and accepts a (void*) assignment.
+    */
+    class reference {
+    public:
+        reference(AttribStore* _store, size_t _idx): store(_store), idx(_idx) {}
+        template<class T> operator T*() const { return (T*)store->entries[idx].GetData(); }
+        reference& operator=(void* ptr) { store->entries[idx].value = ptr; return *this; }
+        reference& operator=(const reference& other) { return *this = (void*)other; }
+    private:
+        AttribStore* store;
+        size_t idx;
+    };
+
+    class iterator {
+    public:
+        using value_type = AttribStore::value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+        struct arrow {
+            value_type p;
+            const value_type* operator->() const { return &p; }
+        };
+
+        iterator() = default;
+        iterator(std::vector<Entry>::const_iterator _it): it(_it) {}
+        value_type operator*() const { return value_type(*it->name, it->GetData()); }
+        arrow operator->() const { return arrow{**this}; }
+        iterator& operator++() { ++it; return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++it; return tmp; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+        /**
+        @returns the attribute this iterator points to
+        */
+        const Entry& GetEntry() const { return *it; }
+    private:
+        std::vector<Entry>::const_iterator it;
+    };
+    using const_iterator = iterator;
+
+    /**
+    Like std::map::operator[]: inserts an attribute with a NULL untyped pointer if the key is not present.
+    */
+    reference operator[](const std::string& key);
+    /**
+    Like std::map::insert: inserts the (untyped) attribute if the key is not present yet.
+    @returns the iterator to the attribute with the key and whether the attribute was inserted
+    */
+    std::pair<iterator,bool> insert(const std::pair<std::string, void*>& kv);
+    iterator find(const std::string& key) const;
+    size_t count(const std::string& key) const;
+    size_t erase(const std::string& key);
+    iterator begin() const { return iterator(entries.begin()); }
+    iterator end() const { return iterator(entries.end()); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void clear() { entries.clear(); }
+
+private:
+    template<class T> T* GetAt(int idx)
+    {
+        static_assert(AttribTraits<T>::type != SYS_SAGE_ATTRIB_TYPE_NONE, "unsupported attribute type; use the map-like (void*) interface for custom types");
+        if(idx < 0 || entries[idx].value.index() != AttribTraits<T>::type)
+            return NULL;
+        if constexpr (std::is_arithmetic_v<T>)
+            return &std::get<T>(entries[idx].value);
+        else
+            return std::get<std::unique_ptr<T> >(entries[idx].value).get();
+    }
+    int FindIndex(unsigned int key) const;
+    int FindIndex(const std::string& key) const;
+    size_t FindOrInsert(const AttribKey& key);
+
+    std::vector<Entry> entries; /**< ordered by *name */
+};
+
+#endif
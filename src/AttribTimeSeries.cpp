@@ -0,0 +1,127 @@
+#include "AttribTimeSeries.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AttribTimeSeries::AttribTimeSeries(size_t _capacity): capacity(std::max<size_t>(_capacity, 1)), slots(new Slot[capacity]) {}
+
+AttribTimeSeries::AttribTimeSeries(const AttribTimeSeries& other): AttribTimeSeries(other.capacity)
+{
+    *this = other;
+}
+
+AttribTimeSeries& AttribTimeSeries::operator=(const AttribTimeSeries& other)
+{
+    if(this == &other)
+        return *this;
+    std::vector<Sample> samples;
+    other.GetSamples(&samples);
+    if(capacity != other.capacity)
+    {
+        capacity = other.capacity;
+        slots.reset(new Slot[capacity]);
+    }
+    claimed.store(0, std::memory_order_relaxed);
+    published.store(0, std::memory_order_relaxed);
+    for(const Sample& s : samples)
+        Append(s.timestamp, s.value);
+    return *this;
+}
+
+void AttribTimeSeries::Append(long long timestamp, double value)
+{
+    //single writer: mark the slot as being written before touching it, publish the sample afterwards
+    unsigned long long n = published.load(std::memory_order_relaxed);
+    claimed.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = slots[n % capacity];
+    slot.timestamp.store(timestamp, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    published.store(n + 1, std::memory_order_release);
+}
+
+size_t AttribTimeSeries::GetSize() const
+{
+    return std::min<unsigned long long>(published.load(std::memory_order_acquire), capacity);
+}
+
+size_t AttribTimeSeries::GetSamples(std::vector<Sample>* out, long long from, long long to) const
+{
+    unsigned long long end = published.load(std::memory_order_acquire);
+    unsigned long long begin = end > capacity ? end - capacity : 0;
+    size_t first = out->size();
+    out->reserve(first + (end - begin));
+    for(unsigned long long i = begin; i < end; i++)
+    {
+        const Slot& slot = slots[i % capacity];
+        out->push_back({slot.timestamp.load(std::memory_order_relaxed), slot.value.load(std::memory_order_relaxed)});
+    }
+    //samples whose slot has been (or is being) overwritten by the writer in the meantime are dropped
+    std::atomic_thread_fence(std::memory_order_acquire);
+    unsigned long long written = claimed.load(std::memory_order_relaxed);
+    unsigned long long valid = written > capacity ? written - capacity : 0;
+    size_t dropped = valid > begin ? std::min(valid - begin, end - begin) : 0;
+    out->erase(out->begin() + first, out->begin() + first + dropped);
+    if(from != LLONG_MIN || to != LLONG_MAX)
+        out->erase(std::remove_if(out->begin() + first, out->end(), [=](const Sample& s){ return s.timestamp < from || s.timestamp > to; }), out->end());
+    return out->size() - first;
+}
+
+bool AttribTimeSeries::GetLast(Sample* s) const
+{
+    while(true)
+    {
+        unsigned long long end = published.load(std::memory_order_acquire);
+        if(end == 0)
+            return false;
+        const Slot& slot = slots[(end - 1) % capacity];
+        Sample last = {slot.timestamp.load(std::memory_order_relaxed), slot.value.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        //retry if the writer has wrapped around the whole buffer in the meantime
+        if(claimed.load(std::memory_order_relaxed) < end + capacity)
+        {
+            *s = last;
+            return true;
+        }
+    }
+}
+
+double AttribTimeSeries::GetMin(long long from, long long to) const
+{
+    std::vector<Sample> samples;
+    if(GetSamples(&samples, from, to) == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return std::min_element(samples.begin(), samples.end(), [](const Sample& a, const Sample& b){ return a.value < b.value; })->value;
+}
+
+double AttribTimeSeries::GetMax(long long from, long long to) const
+{
+    std::vector<Sample> samples;
+    if(GetSamples(&samples, from, to) == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return std::max_element(samples.begin(), samples.end(), [](const Sample& a, const Sample& b){ return a.value < b.value; })->value;
+}
+
+double AttribTimeSeries::GetMean(long long from, long long to) const
+{
+    std::vector<Sample> samples;
+    if(GetSamples(&samples, from, to) == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    double sum = 0;
+    for(const Sample& s : samples)
+        sum += s.value;
+    return sum / samples.size();
+}
+
+double AttribTimeSeries::GetPercentile(double percentile, long long from, long long to) const
+{
+    std::vector<Sample> samples;
+    if(GetSamples(&samples, from, to) == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    //nearest rank: the smallest value such that at least percentile % of the values are <= it
+    double rank = std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * samples.size());
+    size_t idx = rank < 1 ? 0 : (size_t)rank - 1;
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end(), [](const Sample& a, const Sample& b){ return a.value < b.value; });
+    return samples[idx].value;
+}
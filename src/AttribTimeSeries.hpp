@@ -0,0 +1,101 @@
+#ifndef ATTRIB_TIME_SERIES
+#define ATTRIB_TIME_SERIES
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <climits>
+#include <cstddef>
+
+#define SYS_SAGE_TIME_SERIES_DEFAULT_CAPACITY 1024 /**< Default number of samples kept by an AttribTimeSeries. */
+
+/**
+Class AttribTimeSeries - fixed-capacity ring buffer of timestamped samples, used as an attribute value (see AttribStore::AppendSample()) for metrics that are refreshed periodically, e.g. "freq_history" of Core (see Core::RefreshFreq()) or the CAT and MIG settings stored on DataPaths.
+\n Appending takes constant time and does not allocate; once the buffer is full, each new sample replaces the oldest one.
+\n The buffer is lock-free for one writer and any number of concurrent readers: Append() may be called by one thread while other threads call the Get*() methods, which then see a consistent snapshot of the samples (samples overwritten during the read are left out). Copying or assigning a time series is not synchronized with concurrent Append() calls on the destination.
+*/
+class AttribTimeSeries {
+public:
+    /**
+    One sample.
+    */
+    struct Sample {
+        long long timestamp; /**< e.g. std::chrono::high_resolution_clock::now().time_since_epoch().count() */
+        double value;
+    };
+
+    /**
+    Creates an empty time series.
+    @param _capacity - maximum number of samples kept (at least 1)
+    */
+    AttribTimeSeries(size_t _capacity = SYS_SAGE_TIME_SERIES_DEFAULT_CAPACITY);
+    /**
+    Copies the samples (and the capacity) of other.
+    */
+    AttribTimeSeries(const AttribTimeSeries& other);
+    AttribTimeSeries& operator=(const AttribTimeSeries& other);
+
+    /**
+    Appends a sample; if the buffer is full, the oldest sample is dropped. Must only be called by one thread at a time.
+    @param timestamp - timestamp of the sample
+    @param value - value of the sample
+    */
+    void Append(long long timestamp, double value);
+
+    /**
+    @returns the maximum number of samples kept
+    */
+    size_t GetCapacity() const { return capacity; }
+    /**
+    @returns the number of samples currently kept (at most GetCapacity())
+    */
+    size_t GetSize() const;
+    /**
+    @returns the number of samples appended since the time series was created (including the dropped ones)
+    */
+    unsigned long long GetCount() const { return published.load(std::memory_order_acquire); }
+    /**
+    Copies the kept samples with from <= timestamp <= to, oldest first.
+    @param out - output parameter; the samples are appended to it
+    @param from - (optional) start of the time window
+    @param to - (optional) end of the time window
+    @return number of samples copied
+    */
+    size_t GetSamples(std::vector<Sample>* out, long long from = LLONG_MIN, long long to = LLONG_MAX) const;
+    /**
+    @param s - output parameter; the most recent sample
+    @return false if the time series is empty
+    */
+    bool GetLast(Sample* s) const;
+    /**
+    @returns the minimum value of the samples with from <= timestamp <= to; NaN if there is none
+    */
+    double GetMin(long long from = LLONG_MIN, long long to = LLONG_MAX) const;
+    /**
+    @returns the maximum value of the samples with from <= timestamp <= to; NaN if there is none
+    */
+    double GetMax(long long from = LLONG_MIN, long long to = LLONG_MAX) const;
+    /**
+    @returns the mean value of the samples with from <= timestamp <= to; NaN if there is none
+    */
+    double GetMean(long long from = LLONG_MIN, long long to = LLONG_MAX) const;
+    /**
+    Percentile (nearest-rank method) of the values of the samples with from <= timestamp <= to.
+    @param percentile - in [0,100]; e.g. 50 for the median
+    @returns the percentile; NaN if there is no sample
+    */
+    double GetPercentile(double percentile, long long from = LLONG_MIN, long long to = LLONG_MAX) const;
+
+private:
+    struct Slot {
+        std::atomic<long long> timestamp;
+        std::atomic<double> value;
+    };
+
+    size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<unsigned long long> claimed {0}; /**< number of the sample being written + 1, i.e. its slot may be inconsistent */
+    std::atomic<unsigned long long> published {0}; /**< number of samples appended */
+};
+
+#endif
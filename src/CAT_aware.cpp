@@ -8,11 +8,17 @@
 #include <pqos.h>
 #include <cstring> //memset
 #include <limits> //numeric_limits
+#include <chrono>
 
 #include "Topology.hpp"
 
 using namespace std;
 
+//attribute keys of the L3CAT DataPaths (interned once)
+static const AttribKey CATcos_key("CATcos");
+static const AttribKey CATL3mask_key("CATL3mask");
+static const AttribKey CATL3mask_history_key("CATL3mask_history");
+
 //l3cat_ids, l3cat_id_count
 uint64_t getCOSL3Bitmask(unsigned int socketId, unsigned int catCosId, unsigned * socketIdArray, unsigned socketIdArraySz)
 {
@@ -114,6 +120,8 @@ int Node::UpdateL3CATCoreCOS(){
             return 0;
     }
 
+    //the masks are also recorded in "CATL3mask_history" (ring buffer of <timestamp,mask>)
+    long long ts = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     vector<Chip*> sockets;
     GetSubcomponentsByType((vector<Component*>*)&sockets, SYS_SAGE_COMPONENT_CHIP);
     for(auto it = std::begin(sockets); it != std::end(sockets); ++it)
@@ -126,15 +134,13 @@ int Node::UpdateL3CATCoreCOS(){
         {
             Thread* thread = *it_threads;
             //std::cout << "  thread " << thread->GetComponentTypeStr() << " id " << thread->GetId() << std::endl;
-            uint64_t* cos = new uint64_t();
-            uint64_t* mask = new uint64_t();
-            *cos = getCoreCOS(socket->GetId(), thread->GetId(), p_l3cat_ids, l3cat_id_count, p_cpu);
-            if(*cos == std::numeric_limits<uint64_t>::max()){
+            uint64_t cos = getCoreCOS(socket->GetId(), thread->GetId(), p_l3cat_ids, l3cat_id_count, p_cpu);
+            if(cos == std::numeric_limits<uint64_t>::max()){
                 cerr << "getCoreCOS failed" << endl;
                 continue;
             }
-            *mask = getCOSL3Bitmask(socket->GetId(), *cos, p_l3cat_ids, l3cat_id_count);
-            if(*mask == std::numeric_limits<uint64_t>::max()){
+            uint64_t mask = getCOSL3Bitmask(socket->GetId(), cos, p_l3cat_ids, l3cat_id_count);
+            if(mask == std::numeric_limits<uint64_t>::max()){
                 cerr << "getCOSL3Bitmask failed" << endl;
                 continue;
             }
@@ -151,12 +157,11 @@ int Node::UpdateL3CATCoreCOS(){
                 cerr << "L3 cache not found" << endl; continue;
             }
 
-            //TODO check if exists -> overwrite
-
-            //add DataPath to thread and L3
-            DataPath* d = NewDataPath(thread, c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
-            d->attrib.insert({"CATcos", (void*)cos});
-            d->attrib.insert({"CATL3mask", (void*)mask});
+            //add DataPath to thread and L3, or update the one from a previous call in place
+            DataPath* d = UpsertDataPath(thread, c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+            d->attrib.Set(CATcos_key, cos);
+            d->attrib.Set(CATL3mask_key, mask);
+            d->attrib.AppendSample(CATL3mask_history_key, ts, mask);
         }
     }
     return 1;
@@ -164,15 +169,13 @@ int Node::UpdateL3CATCoreCOS(){
 
 long long Thread::GetCATAwareL3Size()
 {
-    //look for dp_outgoing where attrib contains "CATL3mask"
-    for(auto it = std::begin(dp_outgoing); it != std::end(dp_outgoing); ++it)
+    //look for the L3CAT DataPaths where attrib contains "CATL3mask"
+    for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING))
     {
-        DataPath* dp = *it;
-        auto search = dp->attrib.find("CATL3mask");
-        if (search == dp->attrib.end()) {
+        uint64_t* mask = dp->attrib.Get<uint64_t>(CATL3mask_key);
+        if (mask == NULL) {
             continue;
         }
-        uint64_t* mask = (uint64_t*)search->second;
 
         Cache* c = (Cache*)dp->GetTarget();
         int available_cache_associativity_ways = 0;
@@ -0,0 +1,469 @@
+#include "ComponentQuery.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+
+#include "AttribRegistry.hpp"
+
+#define SYS_SAGE_QUERY_KEY_ID 1
+#define SYS_SAGE_QUERY_KEY_NAME 2
+#define SYS_SAGE_QUERY_KEY_TYPE 3
+#define SYS_SAGE_QUERY_KEY_LEVEL 4
+#define SYS_SAGE_QUERY_KEY_ATTRIB 5
+
+#define SYS_SAGE_QUERY_OP_EXISTS 0
+#define SYS_SAGE_QUERY_OP_EQ 1
+#define SYS_SAGE_QUERY_OP_NE 2
+#define SYS_SAGE_QUERY_OP_LT 3
+#define SYS_SAGE_QUERY_OP_LE 4
+#define SYS_SAGE_QUERY_OP_GT 5
+#define SYS_SAGE_QUERY_OP_GE 6
+
+#define SYS_SAGE_QUERY_PLAN_CACHE_SIZE 256 /**< maximum number of compiled expressions kept by Component::Query() */
+
+static string ToLower(string s)
+{
+    for(char& ch : s)
+        ch = tolower((unsigned char)ch);
+    return s;
+}
+
+//SYS_SAGE_COMPONENT_* by its name, 0 if unknown
+static int ComponentTypeByName(const string& name)
+{
+    static const unordered_map<string, int> types = {
+        {"component", SYS_SAGE_COMPONENT_NONE},
+        {"thread", SYS_SAGE_COMPONENT_THREAD},
+        {"core", SYS_SAGE_COMPONENT_CORE},
+        {"cache", SYS_SAGE_COMPONENT_CACHE},
+        {"subdivision", SYS_SAGE_COMPONENT_SUBDIVISION},
+        {"numa", SYS_SAGE_COMPONENT_NUMA},
+        {"chip", SYS_SAGE_COMPONENT_CHIP},
+        {"memory", SYS_SAGE_COMPONENT_MEMORY},
+        {"storage", SYS_SAGE_COMPONENT_STORAGE},
+        {"node", SYS_SAGE_COMPONENT_NODE},
+        {"topology", SYS_SAGE_COMPONENT_TOPOLOGY},
+    };
+    auto it = types.find(ToLower(name));
+    return it == types.end() ? 0 : it->second;
+}
+
+static bool ParseNumber(const string& s, double* out)
+{
+    if(s.empty())
+        return false;
+    char* end;
+    *out = strtod(s.c_str(), &end);
+    return *end == '\0';
+}
+
+static bool CompareResult(int cmp, int op)
+{
+    switch(op)
+    {
+        case SYS_SAGE_QUERY_OP_EQ: return cmp == 0;
+        case SYS_SAGE_QUERY_OP_NE: return cmp != 0;
+        case SYS_SAGE_QUERY_OP_LT: return cmp < 0;
+        case SYS_SAGE_QUERY_OP_LE: return cmp <= 0;
+        case SYS_SAGE_QUERY_OP_GT: return cmp > 0;
+        case SYS_SAGE_QUERY_OP_GE: return cmp >= 0;
+    }
+    return false;
+}
+static bool CompareNumbers(double a, double b, int op){ return CompareResult(a < b ? -1 : (a > b ? 1 : 0), op); }
+
+//value of a numeric attribute (SYS_SAGE_ATTRIB_TYPE_INT .. SYS_SAGE_ATTRIB_TYPE_FLOAT)
+static bool AttribNumber(int type, void* value, double* out)
+{
+    switch(type)
+    {
+        case SYS_SAGE_ATTRIB_TYPE_INT: *out = *(int*)value; return true;
+        case SYS_SAGE_ATTRIB_TYPE_LONGLONG: *out = *(long long*)value; return true;
+        case SYS_SAGE_ATTRIB_TYPE_UINT64: *out = *(uint64_t*)value; return true;
+        case SYS_SAGE_ATTRIB_TYPE_DOUBLE: *out = *(double*)value; return true;
+        case SYS_SAGE_ATTRIB_TYPE_FLOAT: *out = *(float*)value; return true;
+    }
+    return false;
+}
+
+ComponentQuery::ComponentQuery(const string& _expression): expression(_expression)
+{
+    Compile();
+}
+
+bool ComponentQuery::IsValid(){ return error.empty(); }
+string ComponentQuery::GetError(){ return error; }
+string ComponentQuery::GetExpression(){ return expression; }
+
+int ComponentQuery::Compile()
+{
+    const string& e = expression;
+    size_t pos = 0;
+    auto fail = [&](const string& msg) {
+        error = msg + " at position " + to_string(pos) + " of \"" + e + "\"";
+        steps.clear();
+        return 1;
+    };
+    auto skipSpaces = [&]() {
+        while(pos < e.size() && isspace((unsigned char)e[pos]))
+            pos++;
+    };
+    auto readWord = [&]() {
+        size_t start = pos;
+        while(pos < e.size() && (isalnum((unsigned char)e[pos]) || e[pos] == '_'))
+            pos++;
+        return e.substr(start, pos - start);
+    };
+
+    bool descendants = false;
+    skipSpaces();
+    if(e.compare(pos, 2, "//") == 0)
+    {
+        descendants = true;
+        pos += 2;
+    }
+    else if(pos < e.size() && e[pos] == '/')
+        pos++;
+
+    while(true)
+    {
+        Step step{descendants, 0, {}};
+
+        //component types
+        while(true)
+        {
+            skipSpaces();
+            if(pos < e.size() && e[pos] == '*')
+            {
+                step.componentTypeMask = ~0;
+                pos++;
+            }
+            else
+            {
+                size_t start = pos;
+                string name = readWord();
+                if(name.empty())
+                    return fail("expected a component type");
+                int type = ComponentTypeByName(name);
+                if(type == 0)
+                {
+                    pos = start;
+                    return fail("unknown component type \"" + name + "\"");
+                }
+                step.componentTypeMask |= type;
+            }
+            skipSpaces();
+            if(pos < e.size() && e[pos] == '|')
+            {
+                pos++;
+                continue;
+            }
+            break;
+        }
+
+        //predicates
+        while(pos < e.size() && e[pos] == '[')
+        {
+            pos++;
+            skipSpaces();
+            Predicate p{};
+            p.chipType = -1;
+            p.subdivisionType = -1;
+            if(pos < e.size() && e[pos] == '@')
+            {
+                pos++;
+                size_t start = pos;
+                while(pos < e.size() && !isspace((unsigned char)e[pos]) && string("=!<>]").find(e[pos]) == string::npos)
+                    pos++;
+                if(start == pos)
+                    return fail("expected an attribute key");
+                p.key = SYS_SAGE_QUERY_KEY_ATTRIB;
+                p.attribKey = e.substr(start, pos - start);
+            }
+            else
+            {
+                size_t start = pos;
+                string key = ToLower(readWord());
+                if(key == "id")
+                    p.key = SYS_SAGE_QUERY_KEY_ID;
+                else if(key == "name")
+                    p.key = SYS_SAGE_QUERY_KEY_NAME;
+                else if(key == "type")
+                    p.key = SYS_SAGE_QUERY_KEY_TYPE;
+                else if(key == "level")
+                    p.key = SYS_SAGE_QUERY_KEY_LEVEL;
+                else
+                {
+                    pos = start;
+                    return fail("unknown predicate key");
+                }
+            }
+            skipSpaces();
+
+            if(pos < e.size() && e[pos] == ']')
+            {
+                if(p.key != SYS_SAGE_QUERY_KEY_ATTRIB)
+                    return fail("expected a comparison operator");
+                p.op = SYS_SAGE_QUERY_OP_EXISTS;
+            }
+            else
+            {
+                if(e.compare(pos, 2, "!=") == 0)
+                    p.op = SYS_SAGE_QUERY_OP_NE;
+                else if(e.compare(pos, 2, "<=") == 0)
+                    p.op = SYS_SAGE_QUERY_OP_LE;
+                else if(e.compare(pos, 2, ">=") == 0)
+                    p.op = SYS_SAGE_QUERY_OP_GE;
+                else if(e.compare(pos, 1, "=") == 0)
+                    p.op = SYS_SAGE_QUERY_OP_EQ;
+                else if(e.compare(pos, 1, "<") == 0)
+                    p.op = SYS_SAGE_QUERY_OP_LT;
+                else if(e.compare(pos, 1, ">") == 0)
+                    p.op = SYS_SAGE_QUERY_OP_GT;
+                else
+                    return fail("expected a comparison operator");
+                pos += (p.op == SYS_SAGE_QUERY_OP_EQ || p.op == SYS_SAGE_QUERY_OP_LT || p.op == SYS_SAGE_QUERY_OP_GT) ? 1 : 2;
+                skipSpaces();
+
+                if(pos < e.size() && (e[pos] == '\'' || e[pos] == '"'))
+                {
+                    size_t end = e.find(e[pos], pos + 1);
+                    if(end == string::npos)
+                        return fail("unterminated string");
+                    p.strValue = e.substr(pos + 1, end - pos - 1);
+                    pos = end + 1;
+                }
+                else
+                {
+                    size_t start = pos;
+                    while(pos < e.size() && e[pos] != ']')
+                        pos++;
+                    size_t end = pos;
+                    while(end > start && isspace((unsigned char)e[end - 1]))
+                        end--;
+                    p.strValue = e.substr(start, end - start);
+                    if(p.strValue.empty())
+                        return fail("expected a value");
+                }
+                p.isNumber = ParseNumber(p.strValue, &p.numValue);
+
+                bool equalityOnly = p.key == SYS_SAGE_QUERY_KEY_NAME || p.key == SYS_SAGE_QUERY_KEY_TYPE;
+                if(equalityOnly && p.op != SYS_SAGE_QUERY_OP_EQ && p.op != SYS_SAGE_QUERY_OP_NE)
+                    return fail("only = and != are supported for name and type");
+                if(p.key == SYS_SAGE_QUERY_KEY_ID && !p.isNumber)
+                    return fail("expected a numeric id");
+                if(p.key == SYS_SAGE_QUERY_KEY_LEVEL)
+                {
+                    string level = p.strValue;
+                    if(!level.empty() && (level[0] == 'L' || level[0] == 'l'))
+                        level = level.substr(1);
+                    p.isNumber = ParseNumber(level, &p.numValue);
+                    if(!p.isNumber)
+                        return fail("expected a cache level");
+                }
+                if(p.key == SYS_SAGE_QUERY_KEY_TYPE)
+                {
+                    string type = ToLower(p.strValue);
+                    if(p.isNumber)
+                        p.chipType = p.subdivisionType = (int)p.numValue;
+                    else if(type == "none")
+                        p.chipType = p.subdivisionType = 1;
+                    else if(type == "cpu")
+                        p.chipType = SYS_SAGE_CHIP_TYPE_CPU;
+                    else if(type == "cpu_socket")
+                        p.chipType = SYS_SAGE_CHIP_TYPE_CPU_SOCKET;
+                    else if(type == "gpu")
+                        p.chipType = SYS_SAGE_CHIP_TYPE_GPU;
+                    else if(type == "gpu_sm")
+                        p.subdivisionType = SYS_SAGE_SUBDIVISION_TYPE_GPU_SM;
+                    else
+                        return fail("unknown Chip or Subdivision type \"" + p.strValue + "\"");
+                }
+            }
+            skipSpaces();
+            if(pos >= e.size() || e[pos] != ']')
+                return fail("expected ']'");
+            pos++;
+            //names, Chip/Subdivision types and attributes can change without a change of the tree version
+            if(p.key != SYS_SAGE_QUERY_KEY_ID && p.key != SYS_SAGE_QUERY_KEY_LEVEL)
+                memoizable = false;
+            step.predicates.push_back(p);
+            skipSpaces();
+        }
+        steps.push_back(step);
+
+        skipSpaces();
+        if(pos >= e.size())
+            break;
+        if(e.compare(pos, 2, "//") == 0)
+        {
+            descendants = true;
+            pos += 2;
+        }
+        else if(e[pos] == '/')
+        {
+            descendants = false;
+            pos++;
+        }
+        else
+            return fail("expected '/' or '//'");
+    }
+    return 0;
+}
+
+bool ComponentQuery::Matches(Component* c, const Predicate& p)
+{
+    switch(p.key)
+    {
+        case SYS_SAGE_QUERY_KEY_ID:
+            return CompareNumbers(c->GetId(), p.numValue, p.op);
+        case SYS_SAGE_QUERY_KEY_NAME:
+            return CompareResult(c->GetName().compare(p.strValue), p.op);
+        case SYS_SAGE_QUERY_KEY_TYPE:
+        {
+            int type, expected;
+            if(c->GetComponentType() == SYS_SAGE_COMPONENT_CHIP)
+            {
+                type = ((Chip*)c)->GetChipType();
+                expected = p.chipType;
+            }
+            else if(c->GetComponentType() == SYS_SAGE_COMPONENT_SUBDIVISION || c->GetComponentType() == SYS_SAGE_COMPONENT_NUMA)
+            {
+                type = ((Subdivision*)c)->GetSubdivisionType();
+                expected = p.subdivisionType;
+            }
+            else
+                return false;
+            return CompareResult(type == expected ? 0 : 1, p.op);
+        }
+        case SYS_SAGE_QUERY_KEY_LEVEL:
+            if(c->GetComponentType() != SYS_SAGE_COMPONENT_CACHE)
+                return false;
+            return CompareNumbers(((Cache*)c)->GetCacheLevel(), p.numValue, p.op);
+        case SYS_SAGE_QUERY_KEY_ATTRIB:
+        {
+            auto it = c->attrib.find(p.attribKey);
+            if(it == c->attrib.end())
+                return false;
+            if(p.op == SYS_SAGE_QUERY_OP_EXISTS)
+                return true;
+            const AttribStore::Entry& entry = it.GetEntry();
+            const AttribTypeDescriptor* d = AttribRegistry::GetDescriptor(entry);
+            if(d == NULL)
+                return false;
+            double value;
+            if(p.isNumber && AttribNumber(d->type, entry.GetData(), &value))
+                return CompareNumbers(value, p.numValue, p.op);
+            if(d->toString == NULL)
+                return false;
+            return CompareResult(d->toString(entry.GetData()).compare(p.strValue), p.op);
+        }
+    }
+    return false;
+}
+
+bool ComponentQuery::Matches(Component* c, const Step& step)
+{
+    for(const Predicate& p : step.predicates)
+    {
+        if(!Matches(c, p))
+            return false;
+    }
+    return true;
+}
+
+vector<Component*> ComponentQuery::Evaluate(Component* root)
+{
+    if(steps.empty() || root == NULL)
+        return {};
+    if(memoizable && root == cachedRoot && cachedVersion == Component::GetTreeVersion())
+        return cachedResult;
+
+    vector<Component*> current{root}, next;
+    for(const Step& step : steps)
+    {
+        next.clear();
+        if(step.descendants)
+        {
+            unordered_set<Component*> selected;
+            Component* lastContext = NULL;
+            for(Component* context : current)
+            {
+                //the subtree of a context nested in the previous one has been visited already
+                if(lastContext != NULL && lastContext->IsAncestorOf(context))
+                    continue;
+                lastContext = context;
+                for(Component* c : context->SubtreeOfType(step.componentTypeMask))
+                {
+                    if(c != context && Matches(c, step) && (current.size() == 1 || selected.insert(c).second))
+                        next.push_back(c);
+                }
+            }
+        }
+        else
+        {
+            for(Component* context : current)
+            {
+                for(Component* child : *(context->GetChildren()))
+                {
+                    if((child->GetComponentType() & step.componentTypeMask) && Matches(child, step))
+                        next.push_back(child);
+                }
+            }
+        }
+        swap(current, next);
+        if(current.empty())
+            break;
+    }
+
+    if(memoizable)
+    {
+        cachedRoot = root;
+        cachedVersion = Component::GetTreeVersion();
+        cachedResult = current;
+    }
+    return current;
+}
+
+void ComponentQuery::Invalidate()
+{
+    cachedRoot = NULL;
+    cachedResult.clear();
+}
+
+//compiled plan of an expression used by Component::Query(); the mutex guards the memoized result of the plan
+struct CachedQuery {
+    CachedQuery(const string& expression): query(expression) {}
+    ComponentQuery query;
+    mutex m;
+};
+
+vector<Component*> Component::Query(const string& expression)
+{
+    //compiled plans of the expressions used so far; when the cache is full, an arbitrary plan is dropped
+    static mutex queriesMutex;
+    static unordered_map<string, shared_ptr<CachedQuery> > queries;
+    shared_ptr<CachedQuery> cached;
+    {
+        lock_guard<mutex> lock(queriesMutex);
+        auto it = queries.find(expression);
+        if(it == queries.end())
+        {
+            if(queries.size() >= SYS_SAGE_QUERY_PLAN_CACHE_SIZE)
+                queries.erase(queries.begin());
+            it = queries.emplace(expression, make_shared<CachedQuery>(expression)).first;
+        }
+        cached = it->second;
+    }
+    lock_guard<mutex> lock(cached->m);
+    if(!cached->query.IsValid())
+    {
+        cerr << "Component::Query: " << cached->query.GetError() << endl;
+        return {};
+    }
+    return cached->query.Evaluate(this);
+}
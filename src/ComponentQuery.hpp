@@ -0,0 +1,89 @@
+#ifndef COMPONENT_QUERY
+#define COMPONENT_QUERY
+
+#include <string>
+#include <vector>
+
+#include "Topology.hpp"
+
+using namespace std;
+
+/**
+Class ComponentQuery - a compiled path expression selecting Components of a Component Tree, e.g. "Node/Chip[type=GPU]//Cache[level=L2]".
+\n The expression is parsed once (in the constructor) into a plan of steps, which can be evaluated repeatedly on different Component Trees.
+\n Syntax:
+\n   path      := ['/' | '//'] step (('/' | '//') step)*
+\n   step      := types predicate*
+\n   types     := '*' | type ('|' type)*          -- Thread, Core, Cache, Subdivision, Numa, Chip, Memory, Storage, Node, Topology, Component (case-insensitive)
+\n   predicate := '[' key [op value] ']'          -- op is one of = != < <= > >=; a predicate without op tests for the presence of an attribute
+\n   key       := id | name | type | level | @attribute_key
+\n '/' selects children, '//' all descendants of the components selected so far (the first step is relative to the component the query is evaluated on).
+\n Predicate keys: id (Component id), name (Component name), type (Chip type CPU, CPU_SOCKET, GPU, NONE or Subdivision type GPU_SM, NONE, or a number), level (Cache level, e.g. 2 or L2), @key (attribute; numeric attributes are compared as numbers, others by their string representation, see AttribRegistry).
+\n Values may be quoted with ' or ".
+\n If the predicates only test the id and the Cache level, the result of the last evaluation is memoized against Component::GetTreeVersion(), so repeating the query on an unchanged Component Tree costs O(result). Queries with name, type or attribute predicates are re-evaluated each time (names, Chip/Subdivision types and attributes can change without a change of the tree version); only their compiled plan is reused.
+\n A ComponentQuery object must not be evaluated by several threads at the same time.
+@see Component::Query(const string& expression)
+*/
+class ComponentQuery {
+public:
+    /**
+    Compiles the path expression.
+    @param expression - the path expression
+    @see IsValid()
+    */
+    ComponentQuery(const string& expression);
+    /**
+    @returns true if the expression was compiled successfully
+    */
+    bool IsValid();
+    /**
+    @returns the description of the syntax error (empty if the expression is valid)
+    */
+    string GetError();
+    /**
+    @returns the expression of the query
+    */
+    string GetExpression();
+    /**
+    Evaluates the query.
+    @param root - the component to evaluate the query on
+    @return the selected components (each at most once); the components selected from one component are in DFS pre-order. Empty if the expression is not valid.
+    */
+    vector<Component*> Evaluate(Component* root);
+    /**
+    Drops the memoized result (if any), so that the next Evaluate() re-evaluates the query.
+    */
+    void Invalidate();
+
+private:
+    struct Predicate {
+        int key; /**< SYS_SAGE_QUERY_KEY_* (ComponentQuery.cpp) */
+        int op; /**< SYS_SAGE_QUERY_OP_* (ComponentQuery.cpp) */
+        string attribKey; /**< for @key predicates */
+        string strValue;
+        bool isNumber; /**< strValue parsed as a number */
+        double numValue;
+        int chipType; /**< type= value resolved for Chips, -1 if it names no Chip type */
+        int subdivisionType; /**< type= value resolved for Subdivisions, -1 if it names no Subdivision type */
+    };
+    struct Step {
+        bool descendants; /**< '//' (all descendants) or '/' (children) */
+        int componentTypeMask;
+        vector<Predicate> predicates;
+    };
+
+    int Compile();
+    bool Matches(Component* c, const Step& step);
+    bool Matches(Component* c, const Predicate& p);
+
+    string expression;
+    string error;
+    vector<Step> steps;
+    bool memoizable { true }; /**< no predicate depends on fields that change without a change of the tree version */
+
+    Component* cachedRoot { nullptr };
+    unsigned long long cachedVersion { 0 };
+    vector<Component*> cachedResult;
+};
+
+#endif
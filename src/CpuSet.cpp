@@ -0,0 +1,237 @@
+#include "CpuSet.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+CpuSet::CpuSet(const std::vector<int>& ids)
+{
+    for(int id : ids)
+        Set(id);
+}
+
+void CpuSet::Set(int id)
+{
+    if(id < 0)
+        return;
+    size_t w = id / 64;
+    if(w >= words.size())
+        words.resize(w + 1, 0);
+    words[w] |= (uint64_t)1 << (id % 64);
+}
+
+void CpuSet::Clear(int id)
+{
+    if(id < 0 || (size_t)id / 64 >= words.size())
+        return;
+    words[id / 64] &= ~((uint64_t)1 << (id % 64));
+}
+
+bool CpuSet::IsSet(int id) const
+{
+    if(id < 0 || (size_t)id / 64 >= words.size())
+        return false;
+    return (words[id / 64] >> (id % 64)) & 1;
+}
+
+int CpuSet::Count() const
+{
+    int count = 0;
+    for(uint64_t w : words)
+        count += __builtin_popcountll(w);
+    return count;
+}
+
+bool CpuSet::IsEmpty() const
+{
+    return std::all_of(words.begin(), words.end(), [](uint64_t w){ return w == 0; });
+}
+
+int CpuSet::First() const
+{
+    return Next(-1);
+}
+
+int CpuSet::Next(int id) const
+{
+    int start = id + 1;
+    if(start < 0)
+        start = 0;
+    size_t w = start / 64;
+    if(w >= words.size())
+        return -1;
+    uint64_t bits = words[w] & (~(uint64_t)0 << (start % 64));
+    while(bits == 0)
+    {
+        if(++w >= words.size())
+            return -1;
+        bits = words[w];
+    }
+    return w * 64 + __builtin_ctzll(bits);
+}
+
+std::vector<int> CpuSet::GetIds() const
+{
+    std::vector<int> ids;
+    ids.reserve(Count());
+    for(int id = First(); id >= 0; id = Next(id))
+        ids.push_back(id);
+    return ids;
+}
+
+CpuSet& CpuSet::operator|=(const CpuSet& other)
+{
+    if(other.words.size() > words.size())
+        words.resize(other.words.size(), 0);
+    for(size_t i = 0; i < other.words.size(); i++)
+        words[i] |= other.words[i];
+    return *this;
+}
+
+CpuSet& CpuSet::operator&=(const CpuSet& other)
+{
+    if(words.size() > other.words.size())
+        words.resize(other.words.size());
+    for(size_t i = 0; i < words.size(); i++)
+        words[i] &= other.words[i];
+    return *this;
+}
+
+CpuSet& CpuSet::AndNot(const CpuSet& other)
+{
+    size_t n = std::min(words.size(), other.words.size());
+    for(size_t i = 0; i < n; i++)
+        words[i] &= ~other.words[i];
+    return *this;
+}
+
+CpuSet CpuSet::operator|(const CpuSet& other) const
+{
+    CpuSet ret = *this;
+    ret |= other;
+    return ret;
+}
+
+CpuSet CpuSet::operator&(const CpuSet& other) const
+{
+    CpuSet ret = *this;
+    ret &= other;
+    return ret;
+}
+
+bool CpuSet::operator==(const CpuSet& other) const
+{
+    const std::vector<uint64_t>& shorter = words.size() < other.words.size() ? words : other.words;
+    const std::vector<uint64_t>& longer = words.size() < other.words.size() ? other.words : words;
+    if(!std::equal(shorter.begin(), shorter.end(), longer.begin()))
+        return false;
+    return std::all_of(longer.begin() + shorter.size(), longer.end(), [](uint64_t w){ return w == 0; });
+}
+
+bool CpuSet::IsSubsetOf(const CpuSet& other) const
+{
+    for(size_t i = 0; i < words.size(); i++)
+    {
+        uint64_t o = i < other.words.size() ? other.words[i] : 0;
+        if((words[i] & ~o) != 0)
+            return false;
+    }
+    return true;
+}
+
+bool CpuSet::Intersects(const CpuSet& other) const
+{
+    size_t n = std::min(words.size(), other.words.size());
+    for(size_t i = 0; i < n; i++)
+    {
+        if((words[i] & other.words[i]) != 0)
+            return true;
+    }
+    return false;
+}
+
+std::string CpuSet::ToString() const
+{
+    std::string ret;
+    for(int first = First(); first >= 0; )
+    {
+        int last = first;
+        int next;
+        while((next = Next(last)) == last + 1)
+            last = next;
+        if(!ret.empty())
+            ret += ",";
+        ret += std::to_string(first);
+        if(last > first)
+            ret += "-" + std::to_string(last);
+        first = next;
+    }
+    return ret;
+}
+
+//parses a thread id of the list format (decimal digits only); false if it is malformed or larger than SYS_SAGE_CPUSET_MAX_ID
+static bool ParseId(const std::string& str, int* id)
+{
+    if(str.empty() || str.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    errno = 0;
+    long value = strtol(str.c_str(), NULL, 10);
+    if(errno == ERANGE || value > SYS_SAGE_CPUSET_MAX_ID)
+        return false;
+    *id = value;
+    return true;
+}
+
+int CpuSet::Parse(const std::string& list)
+{
+    words.clear();
+    size_t pos = list.find_first_not_of(" \t\n");
+    size_t end = list.find_last_not_of(" \t\n");
+    if(pos == std::string::npos)
+        return 0;
+    std::string s = list.substr(pos, end - pos + 1);
+    pos = 0;
+    while(pos <= s.size())
+    {
+        size_t comma = s.find(',', pos);
+        if(comma == std::string::npos)
+            comma = s.size();
+        std::string range = s.substr(pos, comma - pos);
+        size_t dash = range.find('-');
+        std::string firstStr = range.substr(0, dash);
+        std::string lastStr = dash == std::string::npos ? firstStr : range.substr(dash + 1);
+        int first, last;
+        if(!ParseId(firstStr, &first) || !ParseId(lastStr, &last) || first > last)
+        {
+            words.clear();
+            return 1;
+        }
+        for(int id = first; id <= last; id++)
+            Set(id);
+        pos = comma + 1;
+    }
+    return 0;
+}
+
+int CpuSet::ApplyAffinity(int pid) const
+{
+#ifdef __linux__
+    if(IsEmpty())
+        return -1;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for(int id = First(); id >= 0; id = Next(id))
+    {
+        if(id >= CPU_SETSIZE)
+            return -1;
+        CPU_SET(id, &mask);
+    }
+    return sched_setaffinity(pid, sizeof(mask), &mask) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,99 @@
+#ifndef CPUSET
+#define CPUSET
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#define SYS_SAGE_CPUSET_MAX_ID 65535 /**< Largest thread id accepted by CpuSet::Parse() (Linux supports at most 8192 CPUs). */
+
+/**
+Class CpuSet - a set of hardware thread ids (the ids of the Thread components), stored as a bitmask similar to hwloc cpusets.
+\n The set operations work on whole 64-bit words (plain loops the compiler can vectorize). Sets of different lengths are treated as padded with zeros.
+@see Component::GetCpuSet()
+*/
+class CpuSet {
+public:
+    CpuSet() = default;
+    /**
+    @param ids - the thread ids in the set (negative ids are ignored)
+    */
+    CpuSet(const std::vector<int>& ids);
+
+    /**
+    Adds a thread id (negative ids are ignored).
+    */
+    void Set(int id);
+    /**
+    Removes a thread id.
+    */
+    void Clear(int id);
+    /**
+    @returns true if the thread id is in the set
+    */
+    bool IsSet(int id) const;
+    /**
+    @returns the number of thread ids in the set (popcount)
+    */
+    int Count() const;
+    /**
+    @returns true if the set contains no thread id
+    */
+    bool IsEmpty() const;
+    /**
+    @returns the smallest thread id in the set, or -1 if the set is empty
+    */
+    int First() const;
+    /**
+    @returns the smallest thread id in the set greater than id, or -1 if there is none
+    */
+    int Next(int id) const;
+    /**
+    @returns the thread ids in the set in ascending order
+    */
+    std::vector<int> GetIds() const;
+
+    CpuSet& operator|=(const CpuSet& other);
+    CpuSet& operator&=(const CpuSet& other);
+    /**
+    Removes the thread ids of other from this set (this AND NOT other).
+    */
+    CpuSet& AndNot(const CpuSet& other);
+    CpuSet operator|(const CpuSet& other) const;
+    CpuSet operator&(const CpuSet& other) const;
+    bool operator==(const CpuSet& other) const;
+    /**
+    @returns true if all thread ids of this set are in other
+    */
+    bool IsSubsetOf(const CpuSet& other) const;
+    /**
+    @returns true if the sets have a thread id in common
+    */
+    bool Intersects(const CpuSet& other) const;
+
+    /**
+    @returns the set in the Linux list format, e.g. "0-3,8,10-11" (empty string for an empty set)
+    */
+    std::string ToString() const;
+    /**
+    Replaces the content of the set by a set in the Linux list format, e.g. the content of /sys/fs/cgroup/cpuset.cpus.effective ("0-3,8,10-11"; surrounding whitespace is ignored).
+    @param list - the set in the list format
+    @return 0 on success, 1 if the list could not be parsed, contains a reversed range (e.g. "5-2") or an id larger than SYS_SAGE_CPUSET_MAX_ID (the set is left empty)
+    */
+    int Parse(const std::string& list);
+    /**
+    @returns the 64-bit words of the bitmask (bit i of word w is thread id 64*w+i)
+    */
+    const std::vector<uint64_t>& GetWords() const { return words; }
+    /**
+    Pins a process/thread to the hardware threads of the set (sched_setaffinity; only available on Linux).
+    @param pid - the process or thread id, 0 for the calling thread
+    @return 0 on success, -1 on failure (empty set, ids not supported by cpu_set_t or sched_setaffinity failed)
+    */
+    int ApplyAffinity(int pid = 0) const;
+
+private:
+    std::vector<uint64_t> words;
+};
+
+#endif
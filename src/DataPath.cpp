@@ -1,4 +1,5 @@
 #include "DataPath.hpp"
+#include "AttribRegistry.hpp"
 
 #include <cstdint>
 #include <algorithm>
@@ -15,6 +16,33 @@ DataPath* NewDataPath(Component* _source, Component* _target, int _oriented, int
     return p;
 }
 
+DataPath* FindDataPath(Component* _source, Component* _target, int _type, const std::function<bool(DataPath*)>& filter)
+{
+    //bidirectional DataPaths are in the outgoing list of both endpoints
+    for(DataPath* dp : _source->GetDataPathsByType(_type, SYS_SAGE_DATAPATH_OUTGOING))
+    {
+        Component* other = dp->GetSource() == _source ? dp->GetTarget() : dp->GetSource();
+        if(other == _target && (filter == NULL || filter(dp)))
+            return dp;
+    }
+    return NULL;
+}
+
+DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, bool* created)
+{
+    DataPath* dp = FindDataPath(_source, _target, _type);
+    if(created != NULL)
+        *created = (dp == NULL);
+    if(dp == NULL)
+        dp = new DataPath(_source, _target, _oriented, _type);
+    return dp;
+}
+
+DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, const AttribKey& discriminatorKey, const char* discriminatorValue, bool* created)
+{
+    return UpsertDataPath(_source, _target, _oriented, _type, discriminatorKey, std::string(discriminatorValue), created);
+}
+
 Component * DataPath::GetSource() {return source;}
 Component * DataPath::GetTarget() {return target;}
 double DataPath::GetBw() {return bw;}
@@ -22,6 +50,28 @@ double DataPath::GetLatency() {return latency;}
 int DataPath::GetDpType() {return dp_type;}
 int DataPath::GetOriented() {return oriented;}
 
+void DataPath::SetBw(double _bw)
+{
+    bw = _bw;
+    source->NotifyDataPathChange();
+    target->NotifyDataPathChange();
+}
+void DataPath::SetLatency(double _latency)
+{
+    latency = _latency;
+    source->NotifyDataPathChange();
+    target->NotifyDataPathChange();
+}
+
+bool DataPath::GetMembership(int m, Component** c, int* orientation)
+{
+    if(m > 1 && oriented != SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        return false;
+    *c = (m == 0 || m == 3) ? source : target;
+    *orientation = (m == 0 || m == 2) ? SYS_SAGE_DATAPATH_OUTGOING : SYS_SAGE_DATAPATH_INCOMING;
+    return true;
+}
+
 DataPath::DataPath(Component* _source, Component* _target, int _oriented, int _type): DataPath(_source, _target, _oriented, _type, -1, -1) {}
 DataPath::DataPath(Component* _source, Component* _target, int _oriented, double _bw, double _latency): DataPath(_source, _target, _oriented, SYS_SAGE_DATAPATH_TYPE_NONE, _bw, _latency) {}
 DataPath::DataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency): source(_source), target(_target), oriented(_oriented), dp_type(_type), bw(_bw), latency(_latency)
@@ -49,22 +99,15 @@ void DataPath::DeleteDataPath()
 {
     if(oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
     {
-        std::vector<DataPath*>* source_dp_outgoing = source->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        std::vector<DataPath*>* source_dp_incoming = source->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-        std::vector<DataPath*>* target_dp_outgoing = target->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        std::vector<DataPath*>* target_dp_incoming = target->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-
-        source_dp_outgoing->erase(std::remove(source_dp_outgoing->begin(), source_dp_outgoing->end(), this), source_dp_outgoing->end());
-        target_dp_outgoing->erase(std::remove(target_dp_outgoing->begin(), target_dp_outgoing->end(), this), target_dp_outgoing->end());
-        source_dp_incoming->erase(std::remove(source_dp_incoming->begin(), source_dp_incoming->end(), this), source_dp_incoming->end());
-        target_dp_incoming->erase(std::remove(target_dp_incoming->begin(), target_dp_incoming->end(), this), target_dp_incoming->end());
+        source->RemoveDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
+        target->RemoveDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
+        source->RemoveDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
+        target->RemoveDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
     }
     else if(oriented == SYS_SAGE_DATAPATH_ORIENTED)
     {
-        std::vector<DataPath*>* source_dp_outgoing = source->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        std::vector<DataPath*>* target_dp_incoming = target->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-        source_dp_outgoing->erase(std::remove(source_dp_outgoing->begin(), source_dp_outgoing->end(), this), source_dp_outgoing->end());
-        target_dp_incoming->erase(std::remove(target_dp_incoming->begin(), target_dp_incoming->end(), this), target_dp_incoming->end());
+        source->RemoveDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
+        target->RemoveDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
     }
     delete this;
 }
@@ -76,9 +119,12 @@ void DataPath::Print()
     if(!attrib.empty())
     {
         cout << " - attrib: ";
-        for (const auto& n : attrib) {
-            uint64_t* val = (uint64_t*)n.second;
-            std::cout << n.first << " = " << *val << "; ";
+        for (const AttribStore::Entry& e : attrib.GetEntries()) {
+            const AttribTypeDescriptor* d = AttribRegistry::GetDescriptor(e);
+            if(d != NULL && d->toString != NULL)
+                cout << *e.name << " = " << d->toString(e.GetData()) << "; ";
+            else
+                cout << *e.name << " = " << e.GetData() << "; ";
         }
     }
     cout << endl;
@@ -2,8 +2,10 @@
 #define DATAPATH
 
 #include <map>
+#include <functional>
 
 #include "defines.hpp"
+#include "AttribStore.hpp"
 #include "Topology.hpp"
 
 //Component pointing to a DataPath
@@ -44,6 +46,37 @@ Obsolete; use DataPath() constructors directly instead
 */
 DataPath* NewDataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency);
 
+/**
+Finds a DataPath between two components.
+\n The DataPaths of dp_type _type of _source are searched (see Component::GetDataPathsByType()), i.e. the cost does not depend on the number of DataPaths of other types.
+@param _source - the source Component
+@param _target - the target Component
+@param _type - dp_type of the DataPath
+@param filter - (optional) additional condition the DataPath has to fulfil, e.g. a value of an attribute
+@return the first oriented DataPath from _source to _target, or bidirectional DataPath between them, that matches; NULL if there is none
+*/
+DataPath* FindDataPath(Component* _source, Component* _target, int _type, const std::function<bool(DataPath*)>& filter = NULL);
+/**
+Insert-or-update: returns the DataPath from _source to _target of dp_type _type (see FindDataPath()), and creates it (without bandwidth and latency) if there is none.
+\n Meant for data that is refreshed periodically (e.g. Node::UpdateL3CATCoreCOS()): the existing DataPath is updated in place -- with DataPath::SetBw(), DataPath::SetLatency() and attrib.Set() -- instead of adding another DataPath on every refresh.
+@param _oriented - orientation of a newly created DataPath (an existing DataPath keeps its orientation)
+@param created - (optional) output parameter; set to true if the DataPath was created, false if it existed
+@return the found or created DataPath
+*/
+DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, bool* created = NULL);
+/**
+Insert-or-update keyed by (source, target, dp_type, discriminator attribute): returns the DataPath from _source to _target of dp_type _type whose attribute discriminatorKey equals discriminatorValue, and creates it (with this attribute set) if there is none.
+\n E.g. the DataPaths of several MIG partitions between the same components are told apart by their "mig_uuid" attribute.
+@param discriminatorKey - key of the attribute that tells DataPaths between the same components apart
+@param discriminatorValue - (typed) value of the attribute
+@see UpsertDataPath(Component*, Component*, int, int, bool*)
+*/
+template<class T> DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, const AttribKey& discriminatorKey, const T& discriminatorValue, bool* created = NULL);
+/**
+Insert-or-update with a std::string discriminator given as a C string.
+*/
+DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, const AttribKey& discriminatorKey, const char* discriminatorValue, bool* created = NULL);
+
 /**
 Class DataPath represents Data Paths in the topology -- Data Paths represent an arbitrary relation (or data movement) between two Components from the Component Tree.
 \n Data Paths create a Data-Path graph, which is a structure orthogonal to the Component Tree.
@@ -81,6 +114,16 @@ public:
     @param _latency - Data load latency from the source(provides the data) to the target(requests the data)
     */
     DataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency);
+    /**
+    Allocates the DataPath in the TopologyArena of the current TopologyArena::Scope, or on the heap if there is none.
+    @see TopologyArena
+    */
+    static void* operator new(size_t size);
+    /**
+    Frees a heap-allocated DataPath; DataPaths living in a TopologyArena are released together with the arena.
+    @see TopologyArena
+    */
+    static void operator delete(void* ptr);
 
     /**
     @returns Pointer to the source Component
@@ -107,27 +150,48 @@ public:
      * TODO
     */
     int GetOriented();
+    /**
+    Sets the bandwidth (e.g. when refreshing measured values). Counts as a change of the DataPaths of both endpoints (see Component::GetDataPathChangeVersion()).
+    */
+    void SetBw(double _bw);
+    /**
+    Sets the latency (e.g. when refreshing measured values). Counts as a change of the DataPaths of both endpoints (see Component::GetDataPathChangeVersion()).
+    */
+    void SetLatency(double _latency);
 
     /**
-    Prints basic information about the Data Path to stdout. Prints componentType and Id of the source and target Components, the bandwidth, load latency, and the attributes; for each attribute, the name and value are printed, however the value is only retyped to uint64_t (therefore will print nonsensical values for other data types).
+    Prints basic information about the Data Path to stdout. Prints componentType and Id of the source and target Components, the bandwidth, load latency, and the attributes. Each attribute is printed as name = value, formatted by the toString() of its AttribTypeDescriptor (see AttribRegistry::GetDescriptor()): typed values and untyped pointers with a registered key print their value; untyped pointers without a registered key print the pointer (address) itself.
     */
     void Print();
 
     /**
     Deletes and de-allocated the DataPath pointer from the list(std::vector) of outgoing and incoming DataPaths of source and target Components.
+    \n Each DataPath knows its position in these lists, so the removal takes constant time: the last DataPath of each list is moved to the freed position (i.e. the order of the remaining DataPaths changes).
     @see dp_incoming
     @see dp_outgoing
     */
     void DeleteDataPath();
 
     /**
-     * TODO
+    Attributes of the Data Path. Typed values are set/read with attrib.Set() and attrib.Get<T>(); the std::map<string,void*>-like interface stores untyped pointers owned by the user.
+    @see AttribStore
     */
-    map<string,void*> attrib;
+    AttribStore attrib;
 private:
+    /**
+    Component (source or target) and orientation of membership m of this DataPath: 0 = outgoing of the source, 1 = incoming of the target, and for bidirectional DataPaths additionally 2 = outgoing of the target, 3 = incoming of the source.
+    @return false if the DataPath has no membership m
+    */
+    bool GetMembership(int m, Component** c, int* orientation);
+
     Component * source; /**< TODO */
     Component * target; /**< TODO */
 
+    int listSlot[4] { -1, -1, -1, -1 }; /**< per membership (see GetMembership()): index in dp_outgoing/dp_incoming of the Component; -1 if not stored */
+    int bucketSlot[4] { -1, -1, -1, -1 }; /**< per membership: index in the dp_type bucket of the Component */
+
+    friend class Component;
+
     const int oriented; /**< TODO */
     const int dp_type; /**< TODO */
 
@@ -136,4 +200,20 @@ private:
 
 };
 
+template<class T> DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, const AttribKey& discriminatorKey, const T& discriminatorValue, bool* created)
+{
+    DataPath* dp = FindDataPath(_source, _target, _type, [&](DataPath* d){
+        T* value = d->attrib.Get<T>(discriminatorKey);
+        return value != NULL && *value == discriminatorValue;
+    });
+    if(created != NULL)
+        *created = (dp == NULL);
+    if(dp == NULL)
+    {
+        dp = new DataPath(_source, _target, _oriented, _type);
+        dp->attrib.Set(discriminatorKey, discriminatorValue);
+    }
+    return dp;
+}
+
 #endif
@@ -0,0 +1,333 @@
+#include "DataPathGraph.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <limits>
+
+DataPathGraph::DataPathGraph(Component* _root, int _dpTypeMask): root(_root), dpTypeMask(_dpTypeMask)
+{
+    Build();
+}
+
+void DataPathGraph::Build()
+{
+    treeVersion = Component::GetTreeVersion();
+    dataPathVersion = Component::GetDataPathVersion();
+    components.clear();
+    indexOf.clear();
+    rowOffsets.clear();
+    targets.clear();
+    bandwidths.clear();
+    latencies.clear();
+    dataPaths.clear();
+    routeCache.clear();
+    if(root == NULL)
+    {
+        rowOffsets.push_back(0);
+        return;
+    }
+
+    root->GetSubtreeNodeList(&components);
+    indexOf.reserve(components.size());
+    for(size_t v = 0; v < components.size(); v++)
+        indexOf.insert({components[v], (int)v});
+
+    rowOffsets.reserve(components.size() + 1);
+    rowOffsets.push_back(0);
+    for(size_t v = 0; v < components.size(); v++)
+    {
+        AppendRow(v);
+        rowOffsets.push_back(targets.size());
+    }
+}
+
+void DataPathGraph::AppendRow(int v)
+{
+    Component* c = components[v];
+    size_t rowBegin = targets.size();
+    for(DataPath* dp : *(c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)))
+    {
+        if(!(dp->GetDpType() & dpTypeMask))
+            continue;
+        //bidirectional DataPaths are in the outgoing list of both endpoints (twice for a loop, which becomes a single edge)
+        Component* other = dp->GetSource() == c ? dp->GetTarget() : dp->GetSource();
+        if(other == c && dp->GetOriented() == SYS_SAGE_DATAPATH_BIDIRECTIONAL && std::find(dataPaths.begin() + rowBegin, dataPaths.end(), dp) != dataPaths.end())
+            continue;
+        auto it = indexOf.find(other);
+        if(it == indexOf.end())
+            continue;
+        targets.push_back(it->second);
+        bandwidths.push_back(dp->GetBw());
+        latencies.push_back(dp->GetLatency());
+        dataPaths.push_back(dp);
+    }
+}
+
+bool DataPathGraph::IsUpToDate()
+{
+    return treeVersion == Component::GetTreeVersion() && dataPathVersion == Component::GetDataPathVersion();
+}
+
+int DataPathGraph::Update()
+{
+    if(treeVersion != Component::GetTreeVersion())
+    {
+        Build();
+        return components.size();
+    }
+    if(dataPathVersion == Component::GetDataPathVersion())
+        return 0;
+
+    //rows of clean vertices are copied from the old arrays, rows of vertices whose DataPaths changed are recomputed
+    vector<int> oldOffsets = std::move(rowOffsets);
+    vector<int> oldTargets = std::move(targets);
+    vector<double> oldBandwidths = std::move(bandwidths);
+    vector<double> oldLatencies = std::move(latencies);
+    vector<DataPath*> oldDataPaths = std::move(dataPaths);
+    rowOffsets.clear();
+    targets.clear();
+    bandwidths.clear();
+    latencies.clear();
+    dataPaths.clear();
+    targets.reserve(oldTargets.size());
+    bandwidths.reserve(oldTargets.size());
+    latencies.reserve(oldTargets.size());
+    dataPaths.reserve(oldTargets.size());
+
+    int rebuilt = 0;
+    rowOffsets.push_back(0);
+    for(size_t v = 0; v < components.size(); v++)
+    {
+        if(components[v]->GetDataPathChangeVersion() > dataPathVersion)
+        {
+            AppendRow(v);
+            rebuilt++;
+        }
+        else
+        {
+            int b = oldOffsets[v], e = oldOffsets[v + 1];
+            targets.insert(targets.end(), oldTargets.begin() + b, oldTargets.begin() + e);
+            bandwidths.insert(bandwidths.end(), oldBandwidths.begin() + b, oldBandwidths.begin() + e);
+            latencies.insert(latencies.end(), oldLatencies.begin() + b, oldLatencies.begin() + e);
+            dataPaths.insert(dataPaths.end(), oldDataPaths.begin() + b, oldDataPaths.begin() + e);
+        }
+        rowOffsets.push_back(targets.size());
+    }
+    dataPathVersion = Component::GetDataPathVersion();
+    routeCache.clear();
+    return rebuilt;
+}
+
+int DataPathGraph::GetNumVertices(){ return components.size(); }
+int DataPathGraph::GetNumEdges(){ return targets.size(); }
+int DataPathGraph::GetDpTypeMask(){ return dpTypeMask; }
+
+Component* DataPathGraph::GetComponent(int v)
+{
+    if(v < 0 || v >= (int)components.size())
+        return NULL;
+    return components[v];
+}
+
+int DataPathGraph::GetIndex(Component* c)
+{
+    auto it = indexOf.find(c);
+    return it == indexOf.end() ? -1 : it->second;
+}
+
+const vector<int>& DataPathGraph::GetRowOffsets(){ return rowOffsets; }
+const vector<int>& DataPathGraph::GetTargets(){ return targets; }
+const vector<double>& DataPathGraph::GetBandwidths(){ return bandwidths; }
+const vector<double>& DataPathGraph::GetLatencies(){ return latencies; }
+const vector<DataPath*>& DataPathGraph::GetEdgeDataPaths(){ return dataPaths; }
+
+span<const int> DataPathGraph::GetNeighbors(int v)
+{
+    return span<const int>(targets.data() + rowOffsets[v], rowOffsets[v + 1] - rowOffsets[v]);
+}
+
+void DataPathGraph::Refresh()
+{
+    if(!IsUpToDate())
+        Update();
+}
+
+bool DataPathGraph::FindRoute(int source, int target, int metric, const vector<char>& bannedEdges, const vector<char>& bannedVertices, vector<int>* edges)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    int n = components.size();
+    vector<double> dist(n, inf);
+    vector<double> width(n, -inf);
+    vector<int> viaEdge(n, -1);
+    vector<int> viaVertex(n, -1);
+    vector<char> done(n, 0);
+    //min-heap of (primary key, secondary key, vertex): (latency, 0) or (-bottleneck bandwidth, latency)
+    using Entry = tuple<double, double, int>;
+    priority_queue<Entry, vector<Entry>, std::greater<Entry> > heap;
+    dist[source] = 0;
+    width[source] = inf;
+    heap.push({metric == SYS_SAGE_ROUTE_MAX_BANDWIDTH ? -inf : 0.0, 0.0, source});
+    while(!heap.empty())
+    {
+        int v = std::get<2>(heap.top());
+        heap.pop();
+        if(done[v])
+            continue;
+        done[v] = 1;
+        if(v == target)
+            break;
+        for(int e = rowOffsets[v]; e < rowOffsets[v + 1]; e++)
+        {
+            int u = targets[e];
+            if(done[u] || bannedEdges[e] || bannedVertices[u])
+                continue;
+            if(metric == SYS_SAGE_ROUTE_MAX_BANDWIDTH)
+            {
+                if(bandwidths[e] < 0)
+                    continue;
+                double w = std::min(width[v], bandwidths[e]);
+                double d = dist[v] + std::max(latencies[e], 0.0);
+                if(w > width[u] || (w == width[u] && d < dist[u]))
+                {
+                    width[u] = w;
+                    dist[u] = d;
+                    viaEdge[u] = e;
+                    viaVertex[u] = v;
+                    heap.push({-w, d, u});
+                }
+            }
+            else
+            {
+                if(latencies[e] < 0)
+                    continue;
+                double d = dist[v] + latencies[e];
+                if(d < dist[u])
+                {
+                    dist[u] = d;
+                    viaEdge[u] = e;
+                    viaVertex[u] = v;
+                    heap.push({d, 0.0, u});
+                }
+            }
+        }
+    }
+    if(!done[target])
+        return false;
+    edges->clear();
+    for(int v = target; v != source; v = viaVertex[v])
+        edges->push_back(viaEdge[v]);
+    std::reverse(edges->begin(), edges->end());
+    return true;
+}
+
+DataPathGraph::Route DataPathGraph::MakeRoute(int source, const vector<int>& edges)
+{
+    Route r;
+    r.bw = std::numeric_limits<double>::infinity();
+    r.components.push_back(components[source]);
+    for(int e : edges)
+    {
+        r.components.push_back(components[targets[e]]);
+        r.dataPaths.push_back(dataPaths[e]);
+        r.latency += std::max(latencies[e], 0.0);
+        r.bw = std::min(r.bw, bandwidths[e]);
+    }
+    return r;
+}
+
+int DataPathGraph::GetRoute(Component* source, Component* target, int metric, Route* out)
+{
+    Refresh();
+    int s = GetIndex(source), t = GetIndex(target);
+    if(s < 0 || t < 0)
+        return 1;
+    auto key = std::make_tuple(s, t, metric);
+    auto it = routeCache.find(key);
+    if(it == routeCache.end())
+    {
+        vector<Route> routes;
+        vector<int> edges;
+        if(FindRoute(s, t, metric, vector<char>(targets.size(), 0), vector<char>(components.size(), 0), &edges))
+            routes.push_back(MakeRoute(s, edges));
+        it = routeCache.insert({key, std::move(routes)}).first;
+    }
+    if(it->second.empty())
+        return 1;
+    *out = it->second[0];
+    return 0;
+}
+
+int DataPathGraph::GetKShortestRoutes(Component* source, Component* target, int k, vector<Route>* out)
+{
+    Refresh();
+    int s = GetIndex(source), t = GetIndex(target);
+    if(s < 0 || t < 0 || k <= 0)
+        return 0;
+    auto key = std::make_tuple(s, t, -k);
+    auto it = routeCache.find(key);
+    if(it != routeCache.end())
+    {
+        out->insert(out->end(), it->second.begin(), it->second.end());
+        return it->second.size();
+    }
+
+    //Yen's algorithm: each next route deviates from one of the previous ones at a spur vertex
+    vector<char> bannedEdges(targets.size(), 0);
+    vector<char> bannedVertices(components.size(), 0);
+    vector<vector<int> > found;
+    set<pair<double, vector<int> > > candidates;
+    vector<int> edges;
+    if(FindRoute(s, t, SYS_SAGE_ROUTE_MIN_LATENCY, bannedEdges, bannedVertices, &edges))
+        found.push_back(edges);
+    while(!found.empty() && (int)found.size() < k)
+    {
+        const vector<int> prev = found.back();
+        vector<int> vertices{s};
+        for(int e : prev)
+            vertices.push_back(targets[e]);
+        for(size_t i = 0; i < prev.size(); i++)
+        {
+            //the routes sharing the root prefix must not continue with the same edge; the root must not be revisited
+            for(const vector<int>& p : found)
+            {
+                if(p.size() > i && std::equal(p.begin(), p.begin() + i, prev.begin()))
+                    bannedEdges[p[i]] = 1;
+            }
+            for(size_t j = 0; j < i; j++)
+                bannedVertices[vertices[j]] = 1;
+
+            vector<int> spur;
+            if(FindRoute(vertices[i], t, SYS_SAGE_ROUTE_MIN_LATENCY, bannedEdges, bannedVertices, &spur))
+            {
+                vector<int> route(prev.begin(), prev.begin() + i);
+                route.insert(route.end(), spur.begin(), spur.end());
+                double latency = 0;
+                for(int e : route)
+                    latency += latencies[e];
+                candidates.insert({latency, route});
+            }
+
+            for(const vector<int>& p : found)
+            {
+                if(p.size() > i)
+                    bannedEdges[p[i]] = 0;
+            }
+            for(size_t j = 0; j < i; j++)
+                bannedVertices[vertices[j]] = 0;
+        }
+        while(!candidates.empty() && std::find(found.begin(), found.end(), candidates.begin()->second) != found.end())
+            candidates.erase(candidates.begin());
+        if(candidates.empty())
+            break;
+        found.push_back(candidates.begin()->second);
+        candidates.erase(candidates.begin());
+    }
+
+    vector<Route> routes;
+    for(const vector<int>& route : found)
+        routes.push_back(MakeRoute(s, route));
+    out->insert(out->end(), routes.begin(), routes.end());
+    routeCache.insert({key, std::move(routes)});
+    return found.size();
+}
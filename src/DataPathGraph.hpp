@@ -0,0 +1,152 @@
+#ifndef DATAPATH_GRAPH
+#define DATAPATH_GRAPH
+
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include <map>
+#include <tuple>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+using namespace std;
+
+#define SYS_SAGE_ROUTE_MIN_LATENCY 1 /**< route with the minimal sum of latencies (DataPath::GetLatency()) */
+#define SYS_SAGE_ROUTE_MAX_BANDWIDTH 2 /**< route with the maximal bottleneck bandwidth (minimum of DataPath::GetBw() along the route) */
+
+/**
+Class DataPathGraph - a snapshot of the DataPath graph of a Component subtree in compressed sparse row (CSR) form, as the base for whole-graph algorithms (shortest paths, clustering, matrix export).
+\n The vertices are the components of the subtree in DFS pre-order (index 0 is the root). The edges of vertex v are stored contiguously at [GetRowOffsets()[v], GetRowOffsets()[v+1]) of the edge arrays (target vertex, bandwidth, latency, DataPath). An oriented DataPath is an edge from its source to its target; a bidirectional DataPath is an edge in both directions. Only DataPaths whose dp_type matches the mask and whose both endpoints lie in the subtree are included; the entries of DataPathMatrices are not (e.g. for the cccbench core-to-core latencies, parse them with SYS_SAGE_CCCBENCH_DATAPATHS).
+\n Routing queries (GetRoute(), GetKShortestRoutes()) find multi-hop routes over the DataPaths. Their results are cached per (source, target, metric) and dropped when the snapshot is updated; the queries call Update() themselves if DataPaths changed.
+\n Update() brings the snapshot up to date: if only DataPaths changed, just the rows of the components whose DataPaths changed are recomputed (see Component::GetDataPathChangeVersion()); if the structure of the Component Tree changed, the snapshot is rebuilt.
+*/
+class DataPathGraph {
+public:
+    /**
+    A route between two components: a sequence of DataPaths (edges of the snapshot).
+    */
+    struct Route {
+        vector<Component*> components; /**< the components along the route, from the source to the target */
+        vector<DataPath*> dataPaths; /**< the DataPaths of the hops (components.size()-1 entries) */
+        double latency { 0 }; /**< sum of the latencies of the hops (unknown, i.e. negative, latencies count as 0) */
+        double bw { 0 }; /**< minimal bandwidth of the hops (infinity for a route without hops) */
+    };
+
+    /**
+    Builds the snapshot.
+    @param root - the root of the subtree (vertex 0)
+    @param dpTypeMask - bitwise OR of the SYS_SAGE_DATAPATH_TYPE_* types to include (default: all)
+    */
+    DataPathGraph(Component* root, int dpTypeMask = -1);
+
+    /**
+    Updates the snapshot after DataPaths were added or removed, or the Component Tree changed.
+    @return the number of recomputed rows (0 if the snapshot was up to date, GetNumVertices() after a full rebuild)
+    */
+    int Update();
+    /**
+    @returns true if neither the DataPaths nor the Component Trees changed since the snapshot was built or updated
+    */
+    bool IsUpToDate();
+
+    /**
+    @returns the number of vertices (components of the subtree)
+    */
+    int GetNumVertices();
+    /**
+    @returns the number of edges
+    */
+    int GetNumEdges();
+    /**
+    @returns the Component of vertex v (or NULL if v is out of range)
+    */
+    Component* GetComponent(int v);
+    /**
+    @returns the vertex of Component c, or -1 if c is not part of the snapshot
+    */
+    int GetIndex(Component* c);
+    /**
+    @returns the dpTypeMask the snapshot was built with
+    */
+    int GetDpTypeMask();
+
+    /**
+    @returns the row offsets (GetNumVertices()+1 entries); the edges of vertex v are [offsets[v], offsets[v+1])
+    */
+    const vector<int>& GetRowOffsets();
+    /**
+    @returns the target vertex of each edge
+    */
+    const vector<int>& GetTargets();
+    /**
+    @returns the bandwidth (DataPath::GetBw()) of each edge
+    */
+    const vector<double>& GetBandwidths();
+    /**
+    @returns the latency (DataPath::GetLatency()) of each edge
+    */
+    const vector<double>& GetLatencies();
+    /**
+    @returns the DataPath of each edge
+    */
+    const vector<DataPath*>& GetEdgeDataPaths();
+    /**
+    @returns the target vertices of the edges of vertex v
+    */
+    span<const int> GetNeighbors(int v);
+
+    /**
+    Finds the best route from source to target. Edges with a negative (i.e. unknown) latency are not used for SYS_SAGE_ROUTE_MIN_LATENCY, edges with a negative bandwidth are not used for SYS_SAGE_ROUTE_MAX_BANDWIDTH.
+    \n E.g. the cheapest way to move data from a GPU memory to a NUMA node: DataPathGraph(topo, SYS_SAGE_DATAPATH_TYPE_PHYSICAL).GetRoute(gpuMem, numa, SYS_SAGE_ROUTE_MIN_LATENCY, &route).
+    @param source - the start of the route
+    @param target - the end of the route
+    @param metric - SYS_SAGE_ROUTE_MIN_LATENCY (Dijkstra) or SYS_SAGE_ROUTE_MAX_BANDWIDTH (widest path; ties are broken by the lower latency)
+    @param out - output parameter; the route
+    @return 0 if a route was found, 1 if there is none (or source or target is not part of the snapshot)
+    */
+    int GetRoute(Component* source, Component* target, int metric, Route* out);
+    /**
+    Finds up to k loopless routes from source to target with the lowest latencies (Yen's algorithm), e.g. as alternatives to the fastest route.
+    @param source - the start of the routes
+    @param target - the end of the routes
+    @param k - the maximal number of routes
+    @param out - output parameter; the routes are pushed back ordered by their latency
+    @return the number of routes found
+    */
+    int GetKShortestRoutes(Component* source, Component* target, int k, vector<Route>* out);
+
+private:
+    void Build();
+    /**
+    Appends the edges of vertex v (computed from the DataPaths of its component) to the edge arrays.
+    */
+    void AppendRow(int v);
+    /**
+    Shortest (or widest) route from source to target as a list of edges, avoiding banned edges and vertices.
+    @return false if target is not reachable
+    */
+    bool FindRoute(int source, int target, int metric, const vector<char>& bannedEdges, const vector<char>& bannedVertices, vector<int>* edges);
+    Route MakeRoute(int source, const vector<int>& edges);
+    /**
+    Calls Update() if the snapshot is not up to date.
+    */
+    void Refresh();
+
+    Component* root;
+    int dpTypeMask;
+    unsigned long long treeVersion { 0 }; /**< Component::GetTreeVersion() the snapshot was built for */
+    unsigned long long dataPathVersion { 0 }; /**< Component::GetDataPathVersion() the snapshot was updated for */
+
+    vector<Component*> components; /**< Component of each vertex (DFS pre-order) */
+    unordered_map<Component*, int> indexOf; /**< maps Component pointers to their vertex */
+    vector<int> rowOffsets;
+    vector<int> targets;
+    vector<double> bandwidths;
+    vector<double> latencies;
+    vector<DataPath*> dataPaths;
+
+    map<tuple<int,int,int>, vector<Route> > routeCache; /**< (source, target, metric or -k for GetKShortestRoutes()) -> routes */
+};
+
+#endif
@@ -0,0 +1,196 @@
+#include "DataPathMatrix.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+Component* MatrixDataPath::GetSource(){ return matrix == NULL ? NULL : matrix->GetComponent(i); }
+Component* MatrixDataPath::GetTarget(){ return matrix == NULL ? NULL : matrix->GetComponent(j); }
+int MatrixDataPath::GetDpType(){ return matrix == NULL ? SYS_SAGE_DATAPATH_TYPE_NONE : matrix->GetDpType(); }
+int MatrixDataPath::GetOriented(){ return matrix == NULL ? SYS_SAGE_DATAPATH_ORIENTED : matrix->GetOriented(); }
+DataPathMatrix* MatrixDataPath::GetMatrix(){ return matrix; }
+
+double MatrixDataPath::GetMetric(const string& metric)
+{
+    if(matrix == NULL)
+        return std::numeric_limits<double>::quiet_NaN();
+    int m = matrix->GetMetricIndex(metric);
+    if(m < 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return matrix->Get(i, j, m);
+}
+
+double MatrixDataPath::GetBw()
+{
+    double value = GetMetric("bw");
+    return std::isnan(value) ? -1 : value;
+}
+
+double MatrixDataPath::GetLatency()
+{
+    double value = GetMetric("latency");
+    return std::isnan(value) ? -1 : value;
+}
+
+DataPathMatrix::DataPathMatrix(const vector<Component*>& _components, int _dp_type, const vector<string>& _metrics, int _oriented): components(_components), dp_type(_dp_type), oriented(_oriented), metrics(_metrics)
+{
+    size_t n = components.size();
+    values.assign(metrics.size() * n * n, std::numeric_limits<double>::quiet_NaN());
+    indexOf.reserve(n);
+    for(size_t i = 0; i < n; i++)
+    {
+        Component* c = components[i];
+        if(c == NULL)
+            continue;
+        //a duplicate keeps the first slot; the others stay empty
+        if(!indexOf.insert({c, (int)i}).second)
+        {
+            components[i] = NULL;
+            continue;
+        }
+        c->dp_matrices.push_back(this);
+    }
+}
+
+void DataPathMatrix::DeleteDataPathMatrix()
+{
+    for(Component* c : components)
+    {
+        if(c == NULL)
+            continue;
+        vector<DataPathMatrix*>& list = c->dp_matrices;
+        list.erase(std::find(list.begin(), list.end(), this));
+    }
+    delete this;
+}
+
+int DataPathMatrix::RemoveComponent(Component* c)
+{
+    auto it = indexOf.find(c);
+    if(it == indexOf.end())
+        return 0;
+    int i = it->second;
+    indexOf.erase(it);
+    components[i] = NULL;
+    vector<DataPathMatrix*>& list = c->dp_matrices;
+    list.erase(std::find(list.begin(), list.end(), this));
+    if(indexOf.empty())
+    {
+        delete this;
+        return 1;
+    }
+
+    size_t n = components.size();
+    for(size_t m = 0; m < metrics.size(); m++)
+    {
+        double* block = values.data() + m * n * n;
+        std::fill(block + i * n, block + (i + 1) * n, std::numeric_limits<double>::quiet_NaN());
+        for(size_t r = 0; r < n; r++)
+            block[r * n + i] = std::numeric_limits<double>::quiet_NaN();
+    }
+    return 0;
+}
+
+int DataPathMatrix::GetSize(){ return components.size(); }
+const vector<Component*>& DataPathMatrix::GetComponents(){ return components; }
+int DataPathMatrix::GetDpType(){ return dp_type; }
+int DataPathMatrix::GetOriented(){ return oriented; }
+const vector<string>& DataPathMatrix::GetMetrics(){ return metrics; }
+double* DataPathMatrix::GetData(){ return values.data(); }
+
+Component* DataPathMatrix::GetComponent(int i)
+{
+    if(i < 0 || i >= (int)components.size())
+        return NULL;
+    return components[i];
+}
+
+int DataPathMatrix::GetIndex(Component* c)
+{
+    auto it = indexOf.find(c);
+    return it == indexOf.end() ? -1 : it->second;
+}
+
+int DataPathMatrix::GetMetricIndex(const string& metric)
+{
+    for(size_t m = 0; m < metrics.size(); m++)
+    {
+        if(metrics[m] == metric)
+            return m;
+    }
+    return -1;
+}
+
+double DataPathMatrix::Get(int i, int j, int metric)
+{
+    size_t n = components.size();
+    return values[(metric * n + i) * n + j];
+}
+
+void DataPathMatrix::Set(int i, int j, int metric, double value)
+{
+    size_t n = components.size();
+    values[(metric * n + i) * n + j] = value;
+    if(oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        values[(metric * n + j) * n + i] = value;
+}
+
+double DataPathMatrix::Get(Component* source, Component* target, const string& metric)
+{
+    int i = GetIndex(source), j = GetIndex(target), m = GetMetricIndex(metric);
+    if(i < 0 || j < 0 || m < 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return Get(i, j, m);
+}
+
+int DataPathMatrix::Set(Component* source, Component* target, const string& metric, double value)
+{
+    int i = GetIndex(source), j = GetIndex(target), m = GetMetricIndex(metric);
+    if(i < 0 || j < 0 || m < 0)
+        return 1;
+    Set(i, j, m, value);
+    return 0;
+}
+
+double DataPathMatrix::GetLatency(Component* source, Component* target)
+{
+    double value = Get(source, target, "latency");
+    return std::isnan(value) ? -1 : value;
+}
+
+double DataPathMatrix::GetBw(Component* source, Component* target)
+{
+    double value = Get(source, target, "bw");
+    return std::isnan(value) ? -1 : value;
+}
+
+int DataPathMatrix::GetDataPath(Component* source, Component* target, MatrixDataPath* out)
+{
+    int i = GetIndex(source), j = GetIndex(target);
+    if(i < 0 || j < 0)
+        return 1;
+    *out = MatrixDataPath(this, i, j);
+    return 0;
+}
+
+void DataPathMatrix::Print()
+{
+    cout << "DataPathMatrix of " << components.size() << " components, dp_type " << dp_type << (oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL ? ", bidirectional" : ", oriented") << endl;
+    for(size_t m = 0; m < metrics.size(); m++)
+    {
+        cout << "  " << metrics[m] << ":" << endl;
+        for(size_t i = 0; i < components.size(); i++)
+        {
+            if(components[i] == NULL)
+                continue;
+            cout << "    " << components[i]->GetComponentTypeStr() << " (id " << components[i]->GetId() << "):";
+            for(size_t j = 0; j < components.size(); j++)
+            {
+                if(components[j] != NULL)
+                    cout << " " << Get(i, j, m);
+            }
+            cout << endl;
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef DATAPATH_MATRIX
+#define DATAPATH_MATRIX
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+using namespace std;
+
+class DataPathMatrix;
+
+/**
+Class MatrixDataPath - a virtual DataPath: one (source, target) entry of a DataPathMatrix, queried like a DataPath. It is a lightweight value referring to the matrix; it stays valid as long as the matrix exists.
+@see DataPathMatrix::GetDataPath()
+*/
+class MatrixDataPath {
+public:
+    MatrixDataPath(): matrix(NULL), i(-1), j(-1) {}
+    MatrixDataPath(DataPathMatrix* _matrix, int _i, int _j): matrix(_matrix), i(_i), j(_j) {}
+
+    /**
+    @returns Pointer to the source Component
+    */
+    Component* GetSource();
+    /**
+    @returns Pointer to the target Component
+    */
+    Component* GetTarget();
+    /**
+    @returns the "bw" metric of the entry, -1 if the matrix has no such metric or the value is not set (as for a DataPath without a bandwidth)
+    */
+    double GetBw();
+    /**
+    @returns the "latency" metric of the entry, -1 if the matrix has no such metric or the value is not set (as for a DataPath without a latency)
+    */
+    double GetLatency();
+    /**
+    @returns Type of the Data Path (the dp_type of the matrix)
+    */
+    int GetDpType();
+    /**
+    @returns SYS_SAGE_DATAPATH_ORIENTED or SYS_SAGE_DATAPATH_BIDIRECTIONAL (of the matrix)
+    */
+    int GetOriented();
+    /**
+    The counterpart of DataPath::attrib for the metrics of the matrix, e.g. GetMetric("latency_min").
+    @returns the value of the metric, NaN if the matrix has no such metric or the value is not set
+    */
+    double GetMetric(const string& metric);
+    /**
+    @returns the matrix this entry belongs to (NULL for a default-constructed MatrixDataPath)
+    */
+    DataPathMatrix* GetMatrix();
+
+private:
+    DataPathMatrix* matrix;
+    int i;
+    int j;
+};
+
+/**
+Class DataPathMatrix - a dense relation between all pairs of a set of N components, e.g. the all-to-all core-to-core latencies measured by cccbench.
+\n It replaces N*N DataPaths (each with its own heap allocations for the attributes) by one contiguous buffer of N*N values per metric. The metrics are named (e.g. "latency", "latency_min", "latency_max", "bw"); each metric is a row-major N*N block, the blocks are stored one after another (see GetData()). Values that are not set are NaN.
+\n The entries are queried like DataPaths through GetDataPath() (MatrixDataPath), or directly through Get()/GetLatency()/GetBw().
+\n Each component of the matrix knows the matrices it is part of (Component::GetDataPathMatrices()). Component::DeleteAllDataPaths() (and thus deleting a component) removes the component from its matrices; its row and column are cleared. A matrix without components left deletes itself.
+\n DataPathMatrices are exported by exportToXml() (as <datapath-matrix> elements) and by export_topology()/import_topology().
+*/
+class DataPathMatrix {
+public:
+    /**
+    DataPathMatrix constructor. Registers the matrix in all its components.
+    @param components - the components of the rows and columns (in this order); NULL entries are allowed and stay empty. Each component should occur once.
+    @param dp_type - DataPath type of the relation (e.g. SYS_SAGE_DATAPATH_TYPE_C2C)
+    @param metrics - the names of the metrics stored per entry
+    @param oriented - SYS_SAGE_DATAPATH_ORIENTED (entry (i,j) is from component i to component j) or SYS_SAGE_DATAPATH_BIDIRECTIONAL (Set() writes both (i,j) and (j,i))
+    */
+    DataPathMatrix(const vector<Component*>& components, int dp_type, const vector<string>& metrics, int oriented = SYS_SAGE_DATAPATH_ORIENTED);
+    DataPathMatrix(const DataPathMatrix&) = delete;
+    DataPathMatrix& operator=(const DataPathMatrix&) = delete;
+
+    /**
+    Removes the matrix from all its components and deletes it.
+    */
+    void DeleteDataPathMatrix();
+    /**
+    !!Normally should not be called; Use Component::DeleteAllDataPaths() instead!!
+    Removes Component c from the matrix: its row and column are cleared and it is no longer part of the matrix. Deletes the matrix if it has no components left.
+    @return 1 if the matrix was deleted, 0 otherwise
+    */
+    int RemoveComponent(Component* c);
+
+    /**
+    @returns the number of components N (including empty slots)
+    */
+    int GetSize();
+    /**
+    @returns the Component of row/column i (NULL for an empty slot or if i is out of range)
+    */
+    Component* GetComponent(int i);
+    /**
+    @returns the row/column of Component c, or -1 if c is not part of the matrix
+    */
+    int GetIndex(Component* c);
+    /**
+    @returns the components of the rows/columns (NULL for empty slots)
+    */
+    const vector<Component*>& GetComponents();
+    /**
+    @returns Type of the Data Paths of the matrix.
+    */
+    int GetDpType();
+    /**
+    @returns SYS_SAGE_DATAPATH_ORIENTED or SYS_SAGE_DATAPATH_BIDIRECTIONAL
+    */
+    int GetOriented();
+    /**
+    @returns the names of the metrics
+    */
+    const vector<string>& GetMetrics();
+    /**
+    @returns the position of the metric in GetMetrics(), -1 if there is no such metric
+    */
+    int GetMetricIndex(const string& metric);
+
+    /**
+    @returns the value of the metric (by its position) for entry (i,j), NaN if it is not set. No range checks are performed.
+    */
+    double Get(int i, int j, int metric);
+    /**
+    Sets the value of the metric (by its position) for entry (i,j) (and (j,i) for bidirectional matrices). No range checks are performed.
+    */
+    void Set(int i, int j, int metric, double value);
+    /**
+    @returns the value of the metric from source to target, NaN if it is not set, or if a component or the metric is not part of the matrix
+    */
+    double Get(Component* source, Component* target, const string& metric);
+    /**
+    Sets the value of the metric from source to target (and from target to source for bidirectional matrices).
+    @return 0 on success, 1 if a component or the metric is not part of the matrix
+    */
+    int Set(Component* source, Component* target, const string& metric, double value);
+    /**
+    @returns the "latency" metric from source to target, -1 if it is not known (as for a DataPath without a latency)
+    */
+    double GetLatency(Component* source, Component* target);
+    /**
+    @returns the "bw" metric from source to target, -1 if it is not known (as for a DataPath without a bandwidth)
+    */
+    double GetBw(Component* source, Component* target);
+    /**
+    Retrieves the virtual DataPath between two components.
+    @param out - output parameter; the entry
+    @return 0 if both components are part of the matrix, 1 otherwise (out is not changed)
+    */
+    int GetDataPath(Component* source, Component* target, MatrixDataPath* out);
+    /**
+    @returns the whole buffer of GetMetrics().size() * N * N values; the N*N block of metric m starts at GetData() + m*N*N (row-major)
+    */
+    double* GetData();
+
+    /**
+    Prints the dp_type, the components and the values of all metrics to stdout.
+    */
+    void Print();
+
+private:
+    ~DataPathMatrix() = default;
+
+    vector<Component*> components;
+    unordered_map<Component*, int> indexOf;
+    const int dp_type;
+    const int oriented;
+    vector<string> metrics;
+    vector<double> values; /**< metrics.size() blocks of N*N values */
+};
+
+#endif
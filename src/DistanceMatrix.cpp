@@ -0,0 +1,198 @@
+#include "DistanceMatrix.hpp"
+
+#include <new>
+#include <algorithm>
+#include <limits>
+
+#define DISTANCE_MATRIX_ALIGNMENT 64
+
+DistanceMatrix* BuildDistanceMatrix(Component* root, int srcTypeMask, int dstTypeMask, int dpType, int metric)
+{
+    return new DistanceMatrix(root, srcTypeMask, dstTypeMask, dpType, metric);
+}
+
+DistanceMatrix::DistanceMatrix(Component* _root, int _srcTypeMask, int _dstTypeMask, int _dpType, int _metric): root(_root), srcTypeMask(_srcTypeMask), dstTypeMask(_dstTypeMask), dpType(_dpType), metric(_metric)
+{
+    Build();
+}
+
+DistanceMatrix::~DistanceMatrix()
+{
+    if(values != nullptr)
+        ::operator delete[](values, std::align_val_t(DISTANCE_MATRIX_ALIGNMENT));
+}
+
+void DistanceMatrix::Build()
+{
+    treeVersion = Component::GetTreeVersion();
+    dataPathVersion = Component::GetDataPathVersion();
+    rows.clear();
+    cols.clear();
+    rowOf.clear();
+    colOf.clear();
+    if(values != nullptr)
+    {
+        ::operator delete[](values, std::align_val_t(DISTANCE_MATRIX_ALIGNMENT));
+        values = nullptr;
+    }
+    if(root == NULL)
+        return;
+
+    vector<Component*> subtree;
+    root->GetSubtreeNodeList(&subtree);
+    for(Component* c : subtree)
+    {
+        if((c->GetComponentType() & srcTypeMask) && rowOf.insert({c, (int)rows.size()}).second)
+            rows.push_back(c);
+        if((c->GetComponentType() & dstTypeMask) && colOf.insert({c, (int)cols.size()}).second)
+            cols.push_back(c);
+    }
+    //rows start at cache line boundaries
+    const int perLine = DISTANCE_MATRIX_ALIGNMENT / sizeof(double);
+    stride = (cols.size() + perLine - 1) / perLine * perLine;
+    size_t n = rows.size() * stride;
+    values = (double*)::operator new[](std::max<size_t>(n, 1) * sizeof(double), std::align_val_t(DISTANCE_MATRIX_ALIGNMENT));
+    for(size_t i = 0; i < rows.size(); i++)
+        ComputeRow(i);
+}
+
+void DistanceMatrix::ComputeRow(int i)
+{
+    double* row = values + (size_t)i * stride;
+    std::fill(row, row + stride, std::numeric_limits<double>::quiet_NaN());
+    Component* c = rows[i];
+    //bidirectional DataPaths are in the outgoing list of both endpoints
+    for(DataPath* dp : c->GetDataPathsByType(dpType, SYS_SAGE_DATAPATH_OUTGOING))
+    {
+        auto it = colOf.find(dp->GetSource() == c ? dp->GetTarget() : dp->GetSource());
+        if(it == colOf.end())
+            continue;
+        //the last DataPath wins (without deletions, the most recently added one); negative values mean unknown
+        double value = metric == SYS_SAGE_DISTANCE_BW ? dp->GetBw() : dp->GetLatency();
+        row[it->second] = value < 0 ? std::numeric_limits<double>::quiet_NaN() : value;
+    }
+}
+
+int DistanceMatrix::Refresh()
+{
+    if(treeVersion != Component::GetTreeVersion())
+    {
+        Build();
+        return rows.size();
+    }
+    if(dataPathVersion == Component::GetDataPathVersion())
+        return 0;
+    int refreshed = 0;
+    for(size_t i = 0; i < rows.size(); i++)
+    {
+        if(rows[i]->GetDataPathChangeVersion() > dataPathVersion)
+        {
+            ComputeRow(i);
+            refreshed++;
+        }
+    }
+    dataPathVersion = Component::GetDataPathVersion();
+    return refreshed;
+}
+
+int DistanceMatrix::GetNumRows(){ return rows.size(); }
+int DistanceMatrix::GetNumCols(){ return cols.size(); }
+int DistanceMatrix::GetStride(){ return stride; }
+
+Component* DistanceMatrix::GetRowComponent(int i)
+{
+    if(i < 0 || i >= (int)rows.size())
+        return NULL;
+    return rows[i];
+}
+Component* DistanceMatrix::GetColComponent(int j)
+{
+    if(j < 0 || j >= (int)cols.size())
+        return NULL;
+    return cols[j];
+}
+int DistanceMatrix::GetRowIndex(Component* c)
+{
+    auto it = rowOf.find(c);
+    return it == rowOf.end() ? -1 : it->second;
+}
+int DistanceMatrix::GetColIndex(Component* c)
+{
+    auto it = colOf.find(c);
+    return it == colOf.end() ? -1 : it->second;
+}
+
+double DistanceMatrix::Get(int i, int j){ return values[(size_t)i * stride + j]; }
+
+double DistanceMatrix::Get(Component* src, Component* dst)
+{
+    int i = GetRowIndex(src), j = GetColIndex(dst);
+    if(i < 0 || j < 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return Get(i, j);
+}
+
+const double* DistanceMatrix::GetRow(int i){ return values + (size_t)i * stride; }
+
+//two values of a row; GCC vector extension, so that the row scans use packed instructions (e.g. minpd/maxpd with SSE2) independently of the optimization flags -- the compiler does not vectorize floating point min/max reductions on its own without -ffast-math
+typedef double RowLanes __attribute__((vector_size(16)));
+#define ROW_LANES (sizeof(RowLanes) / sizeof(double))
+
+//minimum of row[0 .. stride); stride is a multiple of 8 and row is aligned to a cache line. "v < m ? v : m" is false for NaN, so missing entries (and the NaN padding) are skipped without a branch of their own
+static double RowMin(const double* row, int stride)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    RowLanes m0 = {inf, inf}, m1 = m0, m2 = m0, m3 = m0;
+    for(int j = 0; j < stride; j += 4 * ROW_LANES)
+    {
+        const RowLanes* v = (const RowLanes*)(row + j);
+        m0 = v[0] < m0 ? v[0] : m0;
+        m1 = v[1] < m1 ? v[1] : m1;
+        m2 = v[2] < m2 ? v[2] : m2;
+        m3 = v[3] < m3 ? v[3] : m3;
+    }
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    m0 = m2 < m0 ? m2 : m0;
+    return std::min(m0[0], m0[1]);
+}
+//maximum of row[0 .. stride), see RowMin()
+static double RowMax(const double* row, int stride)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    RowLanes m0 = {-inf, -inf}, m1 = m0, m2 = m0, m3 = m0;
+    for(int j = 0; j < stride; j += 4 * ROW_LANES)
+    {
+        const RowLanes* v = (const RowLanes*)(row + j);
+        m0 = v[0] > m0 ? v[0] : m0;
+        m1 = v[1] > m1 ? v[1] : m1;
+        m2 = v[2] > m2 ? v[2] : m2;
+        m3 = v[3] > m3 ? v[3] : m3;
+    }
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    m0 = m2 > m0 ? m2 : m0;
+    return std::max(m0[0], m0[1]);
+}
+//first column holding value (never one holding NaN), -1 if there is none
+static int RowFind(const double* row, int numCols, double value)
+{
+    for(int j = 0; j < numCols; j++)
+    {
+        if(row[j] == value)
+            return j;
+    }
+    return -1;
+}
+
+int DistanceMatrix::RowArgMin(int i)
+{
+    const double* row = GetRow(i);
+    return RowFind(row, cols.size(), RowMin(row, stride));
+}
+
+int DistanceMatrix::RowArgMax(int i)
+{
+    const double* row = GetRow(i);
+    return RowFind(row, cols.size(), RowMax(row, stride));
+}
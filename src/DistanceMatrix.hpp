@@ -0,0 +1,119 @@
+#ifndef DISTANCE_MATRIX
+#define DISTANCE_MATRIX
+
+#include <vector>
+#include <unordered_map>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+using namespace std;
+
+#define SYS_SAGE_DISTANCE_LATENCY 1 /**< DistanceMatrix of DataPath::GetLatency() */
+#define SYS_SAGE_DISTANCE_BW 2 /**< DistanceMatrix of DataPath::GetBw() */
+
+/**
+Class DistanceMatrix - dense matrix of the latencies or bandwidths of the DataPaths of one dp_type between two sets of components, e.g. "latency from thread i to NUMA node j" (SYS_SAGE_DATAPATH_TYPE_DATATRANSFER DataPaths from parseCapsNumaBenchmark()) for placement decisions in tight loops.
+\n The rows are the components of the subtree matching srcTypeMask, the columns the components matching dstTypeMask (both in DFS pre-order, with compact indices 0..n-1). Entry (i,j) holds the value of the DataPath from row component i to column component j (an oriented DataPath from i to j, or a bidirectional one between them); if there are several, the last one in Component::GetDataPathsByType() is used (i.e. the most recently added one, unless DataPaths of this type were deleted). Entries without a DataPath, or with an unknown (negative) value, are NaN. The entries of DataPathMatrices are not read (e.g. for the cccbench core-to-core latencies, parse them with SYS_SAGE_CCCBENCH_DATAPATHS, or use the DataPathMatrix directly).
+\n Each row is stored contiguously and aligned to a cache line (the stride is padded to a multiple of 8 values), so that the row scans of RowArgMin() and RowArgMax() process whole cache lines with packed instructions: the minimum (maximum) is reduced over the row first, with missing entries and the padding skipped as NaN, and then the first column holding it is searched.
+\n Refresh() brings the matrix up to date: if only DataPaths changed, just the rows of the components whose DataPaths changed are recomputed; if the structure of the Component Tree changed, the matrix is rebuilt.
+@see BuildDistanceMatrix()
+*/
+class DistanceMatrix {
+public:
+    /**
+    Builds the matrix.
+    @param root - the root of the subtree
+    @param srcTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types of the rows
+    @param dstTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types of the columns
+    @param dpType - the dp_type of the DataPaths
+    @param metric - SYS_SAGE_DISTANCE_LATENCY or SYS_SAGE_DISTANCE_BW
+    */
+    DistanceMatrix(Component* root, int srcTypeMask, int dstTypeMask, int dpType, int metric);
+    ~DistanceMatrix();
+    DistanceMatrix(const DistanceMatrix&) = delete;
+    DistanceMatrix& operator=(const DistanceMatrix&) = delete;
+
+    /**
+    Updates the matrix after DataPaths were added or removed, or the Component Tree changed.
+    @return the number of recomputed rows (0 if the matrix was up to date, GetNumRows() after a full rebuild)
+    */
+    int Refresh();
+
+    /**
+    @returns the number of rows (source components)
+    */
+    int GetNumRows();
+    /**
+    @returns the number of columns (destination components)
+    */
+    int GetNumCols();
+    /**
+    @returns the distance in values between the starts of two consecutive rows (GetNumCols() rounded up to a multiple of 8)
+    */
+    int GetStride();
+    /**
+    @returns the Component of row i (or NULL if i is out of range)
+    */
+    Component* GetRowComponent(int i);
+    /**
+    @returns the Component of column j (or NULL if j is out of range)
+    */
+    Component* GetColComponent(int j);
+    /**
+    @returns the row of Component c, or -1 if c is not a row of the matrix
+    */
+    int GetRowIndex(Component* c);
+    /**
+    @returns the column of Component c, or -1 if c is not a column of the matrix
+    */
+    int GetColIndex(Component* c);
+
+    /**
+    @returns the value of entry (i,j), NaN if there is no DataPath
+    */
+    double Get(int i, int j);
+    /**
+    @returns the value between two components, NaN if there is no DataPath or a component is not part of the matrix
+    */
+    double Get(Component* src, Component* dst);
+    /**
+    @returns pointer to the (cache-line aligned) row i with GetNumCols() values
+    */
+    const double* GetRow(int i);
+    /**
+    @returns the (first) column with the minimal value in row i (e.g. the closest NUMA node), -1 if the row has no values
+    */
+    int RowArgMin(int i);
+    /**
+    @returns the (first) column with the maximal value in row i (e.g. the NUMA node with the highest bandwidth), -1 if the row has no values
+    */
+    int RowArgMax(int i);
+
+private:
+    void Build();
+    void ComputeRow(int i);
+
+    Component* root;
+    int srcTypeMask;
+    int dstTypeMask;
+    int dpType;
+    int metric;
+    unsigned long long treeVersion { 0 }; /**< Component::GetTreeVersion() the matrix was built for */
+    unsigned long long dataPathVersion { 0 }; /**< Component::GetDataPathVersion() the matrix was refreshed for */
+
+    vector<Component*> rows;
+    vector<Component*> cols;
+    unordered_map<Component*, int> rowOf;
+    unordered_map<Component*, int> colOf;
+    int stride { 0 };
+    double* values { nullptr }; /**< rows.size() * stride values, aligned to 64 bytes */
+};
+
+/**
+Builds a DistanceMatrix (to be deleted by the caller).
+@see DistanceMatrix::DistanceMatrix()
+*/
+DistanceMatrix* BuildDistanceMatrix(Component* root, int srcTypeMask, int dstTypeMask, int dpType, int metric);
+
+#endif
@@ -0,0 +1,139 @@
+#include "FrozenTopology.hpp"
+
+#include <algorithm>
+
+FrozenTopology* Component::Freeze()
+{
+    return new FrozenTopology(this);
+}
+
+FrozenTopology::FrozenTopology(Component* root)
+{
+    if(root == NULL)
+        return;
+
+    //iterative DFS (pre-order); children are pushed in reverse so that they are visited in the order of the children vector
+    vector<pair<Component*, int> > stack;
+    vector<int> lastChildIdx;
+    stack.push_back({root, -1});
+    while(!stack.empty())
+    {
+        auto [c, p] = stack.back();
+        stack.pop_back();
+
+        int idx = components.size();
+        components.push_back(c);
+        ids.push_back(c->GetId());
+        componentTypes.push_back(c->GetComponentType());
+        parentIdx.push_back(p);
+        firstChildIdx.push_back(-1);
+        nextSiblingIdx.push_back(-1);
+        lastChildIdx.push_back(-1);
+        depth.push_back(p == -1 ? 0 : depth[p] + 1);
+        indexOf[c] = idx;
+
+        if(p != -1)
+        {
+            if(lastChildIdx[p] == -1)
+                firstChildIdx[p] = idx;
+            else
+                nextSiblingIdx[lastChildIdx[p]] = idx;
+            lastChildIdx[p] = idx;
+        }
+
+        vector<Component*>* children = c->GetChildren();
+        for(auto it = children->rbegin(); it != children->rend(); ++it)
+            stack.push_back({*it, idx});
+    }
+
+    //subtree ranges and heights are accumulated bottom-up (reverse pre-order visits children before parents)
+    int n = components.size();
+    subtreeEnd.resize(n);
+    height.assign(n, 0);
+    for(int i = 0; i < n; i++)
+        subtreeEnd[i] = i + 1;
+    for(int i = n - 1; i > 0; i--)
+    {
+        int p = parentIdx[i];
+        subtreeEnd[p] = std::max(subtreeEnd[p], subtreeEnd[i]);
+        height[p] = std::max(height[p], height[i] + 1);
+    }
+}
+
+int FrozenTopology::GetNumComponents(){return components.size();}
+Component* FrozenTopology::GetComponent(int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return NULL;
+    return components[idx];
+}
+int FrozenTopology::GetIndex(Component* c)
+{
+    auto it = indexOf.find(c);
+    if(it == indexOf.end())
+        return -1;
+    return it->second;
+}
+int FrozenTopology::GetId(int idx){return ids[idx];}
+int FrozenTopology::GetComponentType(int idx){return componentTypes[idx];}
+int FrozenTopology::GetParentIdx(int idx){return parentIdx[idx];}
+int FrozenTopology::GetFirstChildIdx(int idx){return firstChildIdx[idx];}
+int FrozenTopology::GetNextSiblingIdx(int idx){return nextSiblingIdx[idx];}
+int FrozenTopology::GetSubtreeEnd(int idx){return subtreeEnd[idx];}
+int FrozenTopology::GetDepth(int idx){return depth[idx];}
+
+void FrozenTopology::GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return;
+    const int* types = componentTypes.data();
+    int end = subtreeEnd[idx];
+    for(int i = idx; i < end; i++)
+    {
+        if(types[i] == _componentType)
+            outArray->push_back(components[i]);
+    }
+}
+vector<Component*> FrozenTopology::GetAllSubcomponentsByType(int _componentType, int idx)
+{
+    vector<Component*> ret;
+    GetAllSubcomponentsByType(&ret, _componentType, idx);
+    return ret;
+}
+
+Component* FrozenTopology::GetSubcomponentById(int _id, int _componentType, int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return NULL;
+    const int* types = componentTypes.data();
+    const int* id = ids.data();
+    int end = subtreeEnd[idx];
+    for(int i = idx; i < end; i++)
+    {
+        if(id[i] == _id && types[i] == _componentType)
+            return components[i];
+    }
+    return NULL;
+}
+
+Component* FrozenTopology::GetAncestorType(int idx, int _componentType)
+{
+    while(idx >= 0 && idx < (int)components.size())
+    {
+        if(componentTypes[idx] == _componentType)
+            return components[idx];
+        idx = parentIdx[idx];
+    }
+    return NULL;
+}
+Component* FrozenTopology::GetAncestorType(Component* c, int _componentType)
+{
+    return GetAncestorType(GetIndex(c), _componentType);
+}
+
+int FrozenTopology::GetTopoTreeDepth(int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return 0;
+    return height[idx];
+}
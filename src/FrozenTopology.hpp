@@ -0,0 +1,114 @@
+#ifndef FROZEN_TOPOLOGY
+#define FROZEN_TOPOLOGY
+
+#include <vector>
+#include <unordered_map>
+
+#include "Topology.hpp"
+
+using namespace std;
+
+/**
+Class FrozenTopology - a read-only snapshot of a Component subtree, stored as contiguous structure-of-arrays.
+\n The components are stored in DFS pre-order, i.e. the subtree of the component at index i occupies the index range [i, GetSubtreeEnd(i)). Therefore, subtree queries are linear scans over contiguous arrays rather than pointer chasing over the Component Tree.
+\n The snapshot is not updated when the Component Tree changes -- call Component::Freeze() again after modifying the tree.
+@see Component::Freeze()
+*/
+class FrozenTopology {
+public:
+    /**
+    Builds the snapshot of the subtree of root (including root itself, which is stored at index 0).
+    @param root - the root of the subtree to freeze
+    */
+    FrozenTopology(Component* root);
+    /**
+    @returns the number of components stored in the snapshot
+    */
+    int GetNumComponents();
+    /**
+    @returns the Component stored at index idx (or NULL if the index is out of range)
+    */
+    Component* GetComponent(int idx);
+    /**
+    @returns the index of Component c in the snapshot, or -1 if c is not part of the snapshot
+    */
+    int GetIndex(Component* c);
+    /**
+    @returns the id of the component at index idx
+    */
+    int GetId(int idx);
+    /**
+    @returns the componentType of the component at index idx
+    */
+    int GetComponentType(int idx);
+    /**
+    @returns the index of the parent of the component at index idx, -1 for the root of the snapshot
+    */
+    int GetParentIdx(int idx);
+    /**
+    @returns the index of the first child of the component at index idx, -1 if it is a leaf
+    */
+    int GetFirstChildIdx(int idx);
+    /**
+    @returns the index of the next sibling of the component at index idx, -1 if it is the last child
+    */
+    int GetNextSiblingIdx(int idx);
+    /**
+    @returns the (exclusive) end of the subtree range of the component at index idx, i.e. the subtree is [idx, GetSubtreeEnd(idx))
+    */
+    int GetSubtreeEnd(int idx);
+    /**
+    @returns the distance of the component at index idx from the root of the snapshot (the root has depth 0)
+    */
+    int GetDepth(int idx);
+
+    /**
+    Equivalent of Component::GetAllSubcomponentsByType(vector<Component*>*, int) on the snapshot. The results are pushed back in DFS order (incl. the component at index idx itself, if it matches).
+    @param outArray - output parameter (vector with results); must be allocated before the call.
+    @param _componentType - the component type to look for
+    @param idx - index of the component whose subtree is searched, default 0 (the whole snapshot)
+    */
+    void GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, int idx = 0);
+    /**
+    Equivalent of Component::GetAllSubcomponentsByType(int) on the snapshot.
+    @see GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, int idx)
+    */
+    vector<Component*> GetAllSubcomponentsByType(int _componentType, int idx = 0);
+    /**
+    Equivalent of Component::GetSubcomponentById on the snapshot. Returns the first match in DFS order.
+    @param _id - the id to look for
+    @param _componentType - the component type where to look for the id
+    @param idx - index of the component whose subtree is searched, default 0 (the whole snapshot)
+    @return Component * matching the criteria. NULL if no match found
+    */
+    Component* GetSubcomponentById(int _id, int _componentType, int idx = 0);
+    /**
+    Equivalent of Component::GetAncestorType on the snapshot. Moves up the snapshot (starting with the component at index idx itself) until a component of the given type is found.
+    @return Component * matching the criteria. NULL if no match found within the snapshot
+    */
+    Component* GetAncestorType(int idx, int _componentType);
+    /**
+    Equivalent of Component::GetAncestorType(int) for a Component that is part of the snapshot.
+    @return Component * matching the criteria. NULL if no match found or if c is not part of the snapshot
+    */
+    Component* GetAncestorType(Component* c, int _componentType);
+    /**
+    Equivalent of Component::GetTopoTreeDepth on the snapshot (0=leaf, 1=children are leaves, ...).
+    @param idx - index of the component, default 0 (the root of the snapshot)
+    */
+    int GetTopoTreeDepth(int idx = 0);
+
+private:
+    vector<Component*> components; /**< Component pointers in DFS pre-order; used to map the indices back to the Component Tree. */
+    vector<int> ids; /**< id of each component */
+    vector<int> componentTypes; /**< componentType of each component */
+    vector<int> parentIdx; /**< index of the parent, -1 for the root */
+    vector<int> firstChildIdx; /**< index of the first child, -1 for leaves */
+    vector<int> nextSiblingIdx; /**< index of the next sibling, -1 for the last child */
+    vector<int> subtreeEnd; /**< exclusive end of the subtree range */
+    vector<int> depth; /**< distance from the root of the snapshot */
+    vector<int> height; /**< maximal distance to a leaf (GetTopoTreeDepth) */
+    unordered_map<Component*, int> indexOf; /**< maps Component pointers to their index */
+};
+
+#endif
@@ -1,6 +1,105 @@
 #include "Topology.hpp"
+#include "AttribRegistry.hpp"
+#include "DataPathMatrix.hpp"
 
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <numeric>
+#include <functional>
+#include <atomic>
+#include <mutex>
+
+//GetChild only consults the index for components with more children than this; short lists are faster to scan
+#define SYS_SAGE_INDEX_MIN_CHILDREN 16
+
+/**
+(componentType, id) -> components hash index of one Component Tree. Stored in the root component.
+@see Component::EnableSubcomponentIndex()
+*/
+class ComponentIndex {
+public:
+    static long long Key(int _componentType, int _id){ return ((long long)_componentType << 32) | (unsigned int)_id; }
+    static bool IsKnownType(int _componentType){ return _componentType >= SYS_SAGE_COMPONENT_NONE && _componentType <= SYS_SAGE_COMPONENT_TOPOLOGY && (_componentType & (_componentType - 1)) == 0; }
+
+    void Add(Component* c)
+    {
+        entries[Key(c->GetComponentType(), c->GetId())].push_back(c);
+        if(!IsKnownType(c->GetComponentType()))
+            customTypes = true;
+    }
+    void Remove(Component* c)
+    {
+        auto it = entries.find(Key(c->GetComponentType(), c->GetId()));
+        if(it == entries.end())
+            return;
+        vector<Component*>& v = it->second;
+        v.erase(std::remove(v.begin(), v.end(), c), v.end());
+        if(v.empty())
+            entries.erase(it);
+    }
+    void AddSubtree(Component* c)
+    {
+        Add(c);
+        for(Component* child : *(c->GetChildren()))
+            AddSubtree(child);
+    }
+    void RemoveSubtree(Component* c)
+    {
+        Remove(c);
+        for(Component* child : *(c->GetChildren()))
+            RemoveSubtree(child);
+    }
+
+    //returns false if the index cannot answer unambiguously (more matches -- the DFS order decides) and the caller has to search the tree
+    bool FindInSubtree(Component* subtreeRoot, int _id, int _componentType, Component** out)
+    {
+        *out = NULL;
+        auto it = entries.find(Key(_componentType, _id));
+        if(it == entries.end())
+            return true;
+        int matches = 0;
+        for(Component* candidate : it->second)
+        {
+            Component* c = candidate;
+            while(c != NULL && c != subtreeRoot)
+                c = c->GetParent();
+            if(c == subtreeRoot)
+            {
+                *out = candidate;
+                matches++;
+            }
+        }
+        return matches <= 1;
+    }
+    bool FindChild(Component* parent, int _id, Component** out)
+    {
+        *out = NULL;
+        if(customTypes)
+            return false;
+        int matches = 0;
+        for(int type = SYS_SAGE_COMPONENT_NONE; type <= SYS_SAGE_COMPONENT_TOPOLOGY; type <<= 1)
+        {
+            auto it = entries.find(Key(type, _id));
+            if(it == entries.end())
+                continue;
+            for(Component* candidate : it->second)
+            {
+                if(candidate->GetParent() == parent)
+                {
+                    *out = candidate;
+                    matches++;
+                }
+            }
+        }
+        return matches <= 1;
+    }
+
+private:
+    unordered_map<long long, vector<Component*> > entries;
+    bool customTypes = false; /**< set when a component with a user-defined componentType is indexed; GetChild then has to scan */
+};
 
 void Component::PrintSubtree() { PrintSubtree(0); }
 void Component::PrintSubtree(int level)
@@ -44,20 +143,745 @@ void Component::PrintAllDataPathsInSubtree()
     }
 }
 
+/**
+Euler tour of one Component Tree with a sparse table for range-minimum (depth) queries, used by the interval label queries (Component::IsAncestorOf() etc.), and the level index (components grouped by depth) used by Component::GetComponentsNLevelsDeeper().
+\n Each root owns the table of its Component Tree; the table is built on demand and stays valid until the structure of this Component Tree changes.
+*/
+class ComponentTreeLabels {
+public:
+    unsigned long long version; /**< structureVersion of the root when the table was built */
+    vector<Component*> tour; /**< each component is listed when entered and again after each of its children */
+    vector<int> depth; /**< depth of tour[i] */
+    vector<vector<int> > sparse; /**< sparse[k][i] = position of the minimal depth in tour[i .. i+2^k) */
+    vector<Component*> levels; /**< all components ordered by depth, each depth in DFS pre-order */
+    vector<int> levelTourPos; /**< position of levels[i] in the tour (when entered) */
+    vector<int> levelStart; /**< levels of depth d are levels[levelStart[d] .. levelStart[d+1]) */
+
+    void BuildLevels()
+    {
+        vector<int> entered; //tour positions in pre-order
+        entered.reserve(tour.size() / 2 + 1);
+        for(size_t i = 0; i < tour.size(); i++)
+        {
+            if(i == 0 || depth[i] > depth[i - 1])
+                entered.push_back(i);
+        }
+        int maxDepth = 0;
+        for(int pos : entered)
+            maxDepth = std::max(maxDepth, depth[pos]);
+        levelStart.assign(maxDepth + 2, 0);
+        for(int pos : entered)
+            levelStart[depth[pos] + 1]++;
+        std::partial_sum(levelStart.begin(), levelStart.end(), levelStart.begin());
+        levels.resize(entered.size());
+        levelTourPos.resize(entered.size());
+        vector<int> next(levelStart.begin(), levelStart.end() - 1);
+        for(int pos : entered)
+        {
+            int i = next[depth[pos]]++;
+            levels[i] = tour[pos];
+            levelTourPos[i] = pos;
+        }
+    }
+    //components of the given depth entered within tour[first .. last]
+    span<Component* const> Level(int d, int first, int last)
+    {
+        if(d < 0 || d + 1 >= (int)levelStart.size())
+            return {};
+        auto begin = levelTourPos.begin() + levelStart[d];
+        auto end = levelTourPos.begin() + levelStart[d + 1];
+        auto lo = std::lower_bound(begin, end, first);
+        auto hi = std::upper_bound(lo, end, last);
+        return span<Component* const>(levels.data() + (lo - levelTourPos.begin()), hi - lo);
+    }
+
+    void BuildSparseTable()
+    {
+        int n = tour.size();
+        sparse.emplace_back(n);
+        std::iota(sparse[0].begin(), sparse[0].end(), 0);
+        for(int k = 1; (1 << k) <= n; k++)
+        {
+            const vector<int>& prev = sparse[k - 1];
+            vector<int> cur(n - (1 << k) + 1);
+            for(size_t i = 0; i < cur.size(); i++)
+            {
+                int a = prev[i], b = prev[i + (1 << (k - 1))];
+                cur[i] = depth[a] <= depth[b] ? a : b;
+            }
+            sparse.push_back(std::move(cur));
+        }
+    }
+    //component with the minimal depth in tour[l .. r]
+    Component* MinDepth(int l, int r)
+    {
+        int k = 31 - __builtin_clz(r - l + 1);
+        int a = sparse[k][l], b = sparse[k][r - (1 << k) + 1];
+        return tour[depth[a] <= depth[b] ? a : b];
+    }
+};
+
+static std::atomic<unsigned long long> treeVersion {1};
+//serializes the (re)labelling of the Component Trees by concurrent readers
+static std::mutex labelMutex;
+
+unsigned long long Component::GetTreeVersion(){ return treeVersion; }
+void Component::StructureChanged(){ GetRoot()->structureVersion = ++treeVersion; }
+
+static std::atomic<unsigned long long> dataPathVersion {1};
+unsigned long long Component::GetDataPathVersion(){ return dataPathVersion; }
+unsigned long long Component::GetDataPathChangeVersion(){ return dpChangeVersion; }
+void Component::NotifyDataPathChange(){ dpChangeVersion = ++dataPathVersion; }
+
+void Component::LabelSubtree(ComponentTreeLabels* labels, int _depth, bool primary, vector<Component*>* labelled)
+{
+    //a shared subtree is listed in the tour for each reference, but labelled only under its first parent (GetParent())
+    int first = labels->tour.size();
+    labels->tour.push_back(this);
+    labels->depth.push_back(_depth);
+    for(Component* child : children)
+    {
+        child->LabelSubtree(labels, _depth + 1, primary && child->parent == this, labelled);
+        labels->tour.push_back(this);
+        labels->depth.push_back(_depth);
+    }
+    if(primary)
+    {
+        treeLabels = labels;
+        eulerFirst = first;
+        eulerLast = labels->tour.size() - 1;
+        labelled->push_back(this);
+    }
+}
+bool Component::UpdateTreeLabels()
+{
+    Component* root = GetRoot();
+    //fast path without locking: labelVersion is only published once the whole table is built, and a table is not freed while its version is the current one of the root
+    unsigned long long version = labelVersion.load(std::memory_order_acquire);
+    if(version != 0 && version == root->structureVersion.load(std::memory_order_acquire))
+        return true;
+    std::lock_guard<std::mutex> lock(labelMutex);
+    if(root->structureVersion == 0) //a root that has never changed -- give it a version labels can refer to
+        root->structureVersion = ++treeVersion;
+    //the table may be up to date already (built by another thread in the meantime, or this component is not part of it)
+    if(root->ownTreeLabels == NULL || root->ownTreeLabels->version != root->structureVersion)
+    {
+        delete root->ownTreeLabels;
+        ComponentTreeLabels* labels = new ComponentTreeLabels();
+        labels->version = root->structureVersion;
+        labels->tour.reserve(2 * root->subtreeSize + 1);
+        labels->depth.reserve(2 * root->subtreeSize + 1);
+        vector<Component*> labelled;
+        root->LabelSubtree(labels, 0, true, &labelled);
+        labels->BuildLevels();
+        labels->BuildSparseTable();
+        for(Component* c : labelled)
+            c->labelVersion.store(labels->version, std::memory_order_release);
+        root->ownTreeLabels = labels;
+    }
+    //not labelled if this component is not among the children of its parent (e.g. after RemoveChild())
+    return labelVersion.load(std::memory_order_relaxed) == root->structureVersion;
+}
+
+bool Component::IsAncestorOf(Component* _c)
+{
+    if(_c == NULL || _c == this)
+        return false;
+    if(!UpdateTreeLabels() || !_c->UpdateTreeLabels())
+        return false;
+    return treeLabels == _c->treeLabels && eulerFirst < _c->eulerFirst && _c->eulerLast <= eulerLast;
+}
+Component* Component::GetLowestCommonAncestor(Component* _c)
+{
+    if(_c == NULL)
+        return NULL;
+    if(!UpdateTreeLabels() || !_c->UpdateTreeLabels() || treeLabels != _c->treeLabels)
+        return NULL;
+    return treeLabels->MinDepth(std::min(eulerFirst, _c->eulerFirst), std::max(eulerFirst, _c->eulerFirst));
+}
+Component* Component::GetSharedComponent(Component* _c, int _componentTypeMask)
+{
+    for(Component* a = GetLowestCommonAncestor(_c); a != NULL; a = a->parent)
+    {
+        if(a->componentType & _componentTypeMask)
+            return a;
+    }
+    return NULL;
+}
+
+//bit position of a SYS_SAGE_COMPONENT_* type (index into subtreeTypeCounts), -1 for other (user-defined) types
+static int ComponentTypeIndex(int _componentType)
+{
+    if(_componentType <= 0 || (_componentType & (_componentType - 1)) != 0)
+        return -1;
+    int idx = __builtin_ctz(_componentType);
+    return idx < SYS_SAGE_COMPONENT_NUM_TYPES ? idx : -1;
+}
+
+void Component::AddSubtreeAggregates(Component* child)
+{
+    int childType = ComponentTypeIndex(child->componentType);
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        for(int t = 0; t < SYS_SAGE_COMPONENT_NUM_TYPES; t++)
+            a->subtreeTypeCounts[t] += child->subtreeTypeCounts[t];
+        if(childType >= 0)
+            a->subtreeTypeCounts[childType]++;
+        a->subtreeSize += child->subtreeSize + 1;
+    }
+    //the heights only grow as long as the new subtree is the deepest one
+    int height = child->subtreeHeight + 1;
+    for(Component* a = this; a != NULL && a->subtreeHeight < height; a = a->parent, height++)
+        a->subtreeHeight = height;
+}
+void Component::RemoveSubtreeAggregates(Component* child)
+{
+    int childType = ComponentTypeIndex(child->componentType);
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        for(int t = 0; t < SYS_SAGE_COMPONENT_NUM_TYPES; t++)
+            a->subtreeTypeCounts[t] -= child->subtreeTypeCounts[t];
+        if(childType >= 0)
+            a->subtreeTypeCounts[childType]--;
+        a->subtreeSize -= child->subtreeSize + 1;
+    }
+    //recompute the heights from the children until one does not change
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        int height = 0;
+        for(Component* c : a->children)
+            height = std::max(height, c->subtreeHeight + 1);
+        if(height == a->subtreeHeight)
+            break;
+        a->subtreeHeight = height;
+    }
+}
+
+//guards SharingParents(), CopiesOf() and OriginalOf(), which are shared by all Component Trees
+static std::mutex& SharingMutex()
+{
+    static auto* m = new std::mutex(); //never freed, see SharingParents()
+    return *m;
+}
+//number of entries in SharingParents() and OriginalOf(); lets components which were never shared or copied skip the lock
+static std::atomic<size_t> sharingEntries {0};
+//components referenced by more than one parent -> the referencing parents other than GetParent()
+static unordered_map<Component*, vector<Component*> >& SharingParents()
+{
+    static auto* sharingParents = new unordered_map<Component*, vector<Component*> >(); //never freed -- components may be destroyed during static destruction
+    return *sharingParents;
+}
+static void AddSharingParent(Component* child, Component* parent)
+{
+    std::lock_guard<std::mutex> lock(SharingMutex());
+    vector<Component*>& parents = SharingParents()[child];
+    if(parents.empty())
+        sharingEntries++;
+    parents.push_back(parent);
+}
+//the number of the parents of child other than GetParent()
+static size_t CountSharingParents(Component* child)
+{
+    if(sharingEntries == 0)
+        return 0;
+    std::lock_guard<std::mutex> lock(SharingMutex());
+    auto it = SharingParents().find(child);
+    return it == SharingParents().end() ? 0 : it->second.size();
+}
+//the parent of child other than GetParent() added last, or NULL
+static Component* LastSharingParent(Component* child)
+{
+    if(sharingEntries == 0)
+        return NULL;
+    std::lock_guard<std::mutex> lock(SharingMutex());
+    auto it = SharingParents().find(child);
+    return it == SharingParents().end() ? NULL : it->second.back();
+}
+//drops one reference of parent to the shared child; returns the parent which should become GetParent() of child, if parent was that one
+static Component* DropSharingParent(Component* child, Component* parent)
+{
+    if(sharingEntries == 0)
+        return NULL;
+    std::lock_guard<std::mutex> lock(SharingMutex());
+    auto it = SharingParents().find(child);
+    if(it == SharingParents().end())
+        return NULL;
+    vector<Component*>& parents = it->second;
+    Component* newParent = NULL;
+    if(child->GetParent() == parent)
+    {
+        newParent = parents.back();
+        parents.pop_back();
+    }
+    else
+    {
+        auto p = std::find(parents.begin(), parents.end(), parent);
+        if(p != parents.end())
+            parents.erase(p);
+    }
+    if(parents.empty())
+    {
+        SharingParents().erase(it);
+        sharingEntries--;
+    }
+    return newParent;
+}
+
 void Component::InsertChild(Component * child)
 {
     child->SetParent(this);
     children.push_back(child);
+    AddSubtreeAggregates(child);
+    InvalidateCpuSet();
+    StructureChanged();
+
+    ComponentIndex* index = GetRoot()->subcomponentIndex;
+    if(index != NULL)
+        index->AddSubtree(child);
 }
 int Component::RemoveChild(Component * child)
 {
     int orig_size = children.size();
     children.erase(std::remove(children.begin(), children.end(), child), children.end());
-    return orig_size - children.size();
+    int removed = orig_size - children.size();
+    for(int i = 0; i < removed; i++)
+    {
+        RemoveSubtreeAggregates(child);
+        Component* newParent = DropSharingParent(child, this);
+        if(newParent != NULL)
+            child->SetParent(newParent);
+    }
+    if(removed > 0)
+    {
+        InvalidateCpuSet();
+        StructureChanged();
+        child->StructureChanged();
+    }
+
+    ComponentIndex* index = GetRoot()->subcomponentIndex;
+    if(index != NULL && removed > 0)
+        index->RemoveSubtree(child);
+    return removed;
     //return std::erase(children, child); -- not supported in some compilers
 }
+
+//copy of a single component (without children and DataPaths); NULL for component types that cannot be copied
+static Component* CopyComponent(Component* c)
+{
+    Component* copy;
+    switch(c->GetComponentType())
+    {
+        case SYS_SAGE_COMPONENT_NONE: copy = new Component(*c); break;
+        case SYS_SAGE_COMPONENT_THREAD: copy = new Thread(*(Thread*)c); break;
+        case SYS_SAGE_COMPONENT_CORE: copy = new Core(*(Core*)c); break;
+        case SYS_SAGE_COMPONENT_CACHE: copy = new Cache(*(Cache*)c); break;
+        case SYS_SAGE_COMPONENT_SUBDIVISION: copy = new Subdivision(*(Subdivision*)c); break;
+        case SYS_SAGE_COMPONENT_NUMA: copy = new Numa(*(Numa*)c); break;
+        case SYS_SAGE_COMPONENT_CHIP: copy = new Chip(*(Chip*)c); break;
+        case SYS_SAGE_COMPONENT_MEMORY: copy = new Memory(*(Memory*)c); break;
+        case SYS_SAGE_COMPONENT_STORAGE: copy = new Storage(*(Storage*)c); break;
+        case SYS_SAGE_COMPONENT_NODE: copy = new Node(*(Node*)c); break;
+        case SYS_SAGE_COMPONENT_TOPOLOGY: copy = new Topology(*(Topology*)c); break;
+        default: return NULL;
+    }
+    AttribRegistry::CloneAttribs(c->attrib, &copy->attrib);
+    return copy;
+}
+//copy of a DataPath between other endpoints
+static DataPath* CopyDataPath(DataPath* dp, Component* source, Component* target)
+{
+    DataPath* copy = new DataPath(source, target, dp->GetOriented(), dp->GetDpType(), dp->GetBw(), dp->GetLatency());
+    AttribRegistry::CloneAttribs(dp->attrib, &copy->attrib);
+    return copy;
+}
+static unordered_map<Component*, vector<Component*> >& CopiesOf()
+{
+    static auto* copiesOf = new unordered_map<Component*, vector<Component*> >(); //original -> its copies made by Unshare()/Fork(); never freed, see SharingParents()
+    return *copiesOf;
+}
+static unordered_map<Component*, Component*>& OriginalOf()
+{
+    static auto* originalOf = new unordered_map<Component*, Component*>(); //copy -> original
+    return *originalOf;
+}
+static void AddCopy(Component* original, Component* copy)
+{
+    std::lock_guard<std::mutex> lock(SharingMutex());
+    CopiesOf()[original].push_back(copy);
+    OriginalOf()[copy] = original;
+    sharingEntries++;
+}
+//the copy of c in the subtree of root (copies are private, so their GetParent() chain leads to root), or NULL
+static Component* FindCopyBelow(Component* c, Component* root)
+{
+    if(sharingEntries == 0)
+        return NULL;
+    std::lock_guard<std::mutex> lock(SharingMutex());
+    auto it = CopiesOf().find(c);
+    if(it == CopiesOf().end())
+        return NULL;
+    for(Component* copy : it->second)
+    {
+        for(Component* a = copy; a != NULL; a = a->GetParent())
+        {
+            if(a == root)
+                return copy;
+        }
+    }
+    return NULL;
+}
+//duplicates the DataPaths of c for its copy below root: an endpoint other than c is remapped to its copy below root; DataPaths whose other endpoint has no copy there are left out (they are duplicated once the other endpoint gets copied as well), so each DataPath is copied once and no DataPath is attached to a component outside of the copies
+static void CopyDataPaths(Component* c, Component* copy, Component* root)
+{
+    auto remap = [&](Component* e) { return e == c ? copy : FindCopyBelow(e, root); };
+    for(DataPath* dp : *(c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)))
+    {
+        if(dp->GetSource() != c)
+            continue;
+        Component* target = remap(dp->GetTarget());
+        if(target != NULL)
+            CopyDataPath(dp, copy, target);
+    }
+    for(DataPath* dp : *(c->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)))
+    {
+        if(dp->GetTarget() != c || dp->GetSource() == c)
+            continue;
+        Component* source = remap(dp->GetSource());
+        if(source != NULL)
+            CopyDataPath(dp, source, copy);
+    }
+}
+
+static bool SameAttribs(AttribStore& a, AttribStore& b)
+{
+    if(a.size() != b.size())
+        return false;
+    const vector<AttribStore::Entry>& ea = a.GetEntries();
+    const vector<AttribStore::Entry>& eb = b.GetEntries();
+    for(size_t i = 0; i < ea.size(); i++)
+    {
+        if(ea[i].key != eb[i].key || ea[i].GetType() != eb[i].GetType())
+            return false;
+        if(ea[i].GetType() == SYS_SAGE_ATTRIB_TYPE_VOIDPTR)
+        {
+            if(ea[i].GetData() != eb[i].GetData())
+                return false;
+            continue;
+        }
+        const AttribTypeDescriptor* d = AttribRegistry::GetDescriptor(ea[i]);
+        if(d == NULL || d->toString(ea[i].GetData()) != d->toString(eb[i].GetData()))
+            return false;
+    }
+    return true;
+}
+//same properties of two components (ignoring the children)
+static bool SameComponent(Component* a, Component* b)
+{
+    if(a->GetComponentType() != b->GetComponentType() || a->GetId() != b->GetId() || a->GetName() != b->GetName() || !SameAttribs(a->attrib, b->attrib))
+        return false;
+    switch(a->GetComponentType())
+    {
+        case SYS_SAGE_COMPONENT_CACHE:
+        {
+            Cache* ca = (Cache*)a;
+            Cache* cb = (Cache*)b;
+            return ca->GetCacheName() == cb->GetCacheName() && ca->GetCacheSize() == cb->GetCacheSize() && ca->GetCacheAssociativityWays() == cb->GetCacheAssociativityWays() && ca->GetCacheLineSize() == cb->GetCacheLineSize();
+        }
+        case SYS_SAGE_COMPONENT_NUMA:
+            return ((Numa*)a)->GetSize() == ((Numa*)b)->GetSize() && ((Numa*)a)->GetSubdivisionType() == ((Numa*)b)->GetSubdivisionType();
+        case SYS_SAGE_COMPONENT_SUBDIVISION:
+            return ((Subdivision*)a)->GetSubdivisionType() == ((Subdivision*)b)->GetSubdivisionType();
+        case SYS_SAGE_COMPONENT_CHIP:
+            return ((Chip*)a)->GetVendor() == ((Chip*)b)->GetVendor() && ((Chip*)a)->GetModel() == ((Chip*)b)->GetModel() && ((Chip*)a)->GetChipType() == ((Chip*)b)->GetChipType();
+        case SYS_SAGE_COMPONENT_MEMORY:
+            return ((Memory*)a)->GetSize() == ((Memory*)b)->GetSize();
+        case SYS_SAGE_COMPONENT_STORAGE:
+            return ((Storage*)a)->GetSize() == ((Storage*)b)->GetSize();
+    }
+    return true;
+}
+static bool SameSubtree(Component* a, Component* b)
+{
+    if(a == b)
+        return true;
+    vector<Component*>* ca = a->GetChildren();
+    vector<Component*>* cb = b->GetChildren();
+    if(ca->size() != cb->size() || !SameComponent(a, b))
+        return false;
+    for(size_t i = 0; i < ca->size(); i++)
+    {
+        if(!SameSubtree((*ca)[i], (*cb)[i]))
+            return false;
+    }
+    return true;
+}
+//structural hash of the subtree of c (post-order, memoized in hashes); 0 if the subtree cannot be shared (DataPaths, user-defined component types)
+static size_t SubtreeHash(Component* c, unordered_map<Component*, size_t>* hashes)
+{
+    auto it = hashes->find(c);
+    if(it != hashes->end())
+        return it->second;
+
+    size_t h = 0;
+    bool shareable = ComponentIndex::IsKnownType(c->GetComponentType()) && c->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->empty() && c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->empty();
+    if(shareable)
+    {
+        h = std::hash<string>()(c->GetName());
+        h = h * 31 + c->GetComponentType();
+        h = h * 31 + (unsigned int)c->GetId();
+        h = h * 31 + c->attrib.size();
+    }
+    for(Component* child : *(c->GetChildren()))
+    {
+        size_t childHash = SubtreeHash(child, hashes);
+        if(childHash == 0)
+            shareable = false;
+        h = h * 1000003 + childHash;
+    }
+    if(!shareable)
+        h = 0;
+    else if(h == 0)
+        h = 1;
+    (*hashes)[c] = h;
+    return h;
+}
+
+void Component::InsertSharedChild(Component* child)
+{
+    if(child->parent == NULL)
+    {
+        InsertChild(child);
+        return;
+    }
+    children.push_back(child);
+    AddSharingParent(child, this);
+    AddSubtreeAggregates(child);
+    InvalidateCpuSet();
+    StructureChanged();
+}
+
+int Component::ShareIdenticalSubtrees()
+{
+    DisableSubcomponentIndex();
+
+    unordered_map<Component*, size_t> hashes;
+    SubtreeHash(this, &hashes);
+
+    int deleted = 0;
+    unordered_map<size_t, vector<Component*> > firstInstances;
+    unordered_set<Component*> visited;
+    vector<Component*> stack{this};
+    while(!stack.empty())
+    {
+        Component* c = stack.back();
+        stack.pop_back();
+        if(!visited.insert(c).second)
+            continue;
+        for(size_t i = 0; i < c->children.size(); i++)
+        {
+            Component* child = c->children[i];
+            size_t h = hashes[child];
+            if(h != 0)
+            {
+                Component* instance = NULL;
+                for(Component* candidate : firstInstances[h])
+                {
+                    if(candidate != child && SameSubtree(candidate, child))
+                    {
+                        instance = candidate;
+                        break;
+                    }
+                }
+                if(instance != NULL)
+                {
+                    //same structure -- the aggregates of the ancestors do not change
+                    c->children[i] = instance;
+                    AddSharingParent(instance, c);
+                    if(child->GetNumParents() > 1)
+                    {
+                        //already shared with other parents -- only drop the reference of c
+                        Component* newParent = DropSharingParent(child, c);
+                        if(newParent != NULL)
+                            child->SetParent(newParent);
+                        continue;
+                    }
+                    child->parent = NULL;
+                    deleted += child->subtreeSize + 1;
+                    child->Delete(true);
+                    continue;
+                }
+                if(std::find(firstInstances[h].begin(), firstInstances[h].end(), child) == firstInstances[h].end())
+                    firstInstances[h].push_back(child);
+            }
+        }
+        //pushed in reverse, so that the subtrees are visited in DFS pre-order and the first instance of a subtree is kept
+        for(size_t i = c->children.size(); i-- > 0;)
+            stack.push_back(c->children[i]);
+    }
+    StructureChanged();
+    return deleted;
+}
+
+int Component::GetNumParents()
+{
+    if(parent == NULL)
+        return 0;
+    return 1 + CountSharingParents(this);
+}
+
+bool Component::IsShared()
+{
+    for(Component* c = this; c != NULL; c = c->parent)
+    {
+        if(CountSharingParents(c) > 0)
+            return true;
+    }
+    return false;
+}
+
+//path from root to target (DFS over the children, i.e. also through shared subtrees)
+static bool FindPath(Component* root, Component* target, vector<Component*>* path)
+{
+    path->push_back(root);
+    if(root == target)
+        return true;
+    for(Component* child : *(root->GetChildren()))
+    {
+        if(FindPath(child, target, path))
+            return true;
+    }
+    path->pop_back();
+    return false;
+}
+
+Component* Component::Unshare(Component* descendant)
+{
+    vector<Component*> path;
+    if(!FindPath(this, descendant, &path))
+        return NULL;
+    for(size_t i = 1; i < path.size(); i++)
+    {
+        Component* p = path[i - 1];
+        Component* c = path[i];
+        if(CountSharingParents(c) == 0)
+            continue;
+        Component* copy = CopyComponent(c);
+        if(copy == NULL)
+            return NULL;
+        AddCopy(c, copy);
+        //the copy shares the children of c; the aggregates are the same
+        for(Component* child : c->children)
+        {
+            copy->children.push_back(child);
+            AddSharingParent(child, copy);
+        }
+        std::copy(std::begin(c->subtreeTypeCounts), std::end(c->subtreeTypeCounts), copy->subtreeTypeCounts);
+        copy->subtreeSize = c->subtreeSize;
+        copy->subtreeHeight = c->subtreeHeight;
+        CopyDataPaths(c, copy, this);
+
+        Component* newParent = DropSharingParent(c, p);
+        if(newParent != NULL)
+            c->SetParent(newParent);
+        std::replace(p->children.begin(), p->children.end(), c, copy);
+        copy->parent = p;
+        copy->depth = p->depth + 1;
+        path[i] = copy;
+    }
+    StructureChanged();
+    return path.back();
+}
+
+Component* Component::CloneSubtree()
+{
+    //copies in DFS pre-order; the children are inserted bottom-up, so the aggregates are only added to the (parentless) copy of the parent
+    vector<pair<Component*, Component*> > clones;
+    unordered_map<Component*, Component*> cloneOf;
+    std::function<Component*(Component*)> cloneRecursive = [&](Component* c) -> Component* {
+        Component* copy = CopyComponent(c);
+        if(copy == NULL)
+            return NULL;
+        copy->count = c->count;
+        clones.push_back({c, copy});
+        cloneOf[c] = copy;
+        for(Component* child : c->children)
+        {
+            Component* childCopy = cloneRecursive(child);
+            if(childCopy == NULL)
+            {
+                copy->Delete(true);
+                return NULL;
+            }
+            copy->InsertChild(childCopy);
+        }
+        return copy;
+    };
+    Component* root = cloneRecursive(this);
+    if(root == NULL)
+        return NULL;
+
+    for(auto [c, copy] : clones)
+    {
+        for(DataPath* dp : c->dp_outgoing)
+        {
+            if(dp->GetSource() != c)
+                continue;
+            auto target = cloneOf.find(dp->GetTarget());
+            if(target != cloneOf.end())
+                CopyDataPath(dp, copy, target->second);
+        }
+    }
+    return root;
+}
+
+Component* Component::Fork()
+{
+    Component* fork = CopyComponent(this);
+    if(fork == NULL)
+        return NULL;
+    fork->count = count;
+    AddCopy(this, fork);
+    CopyDataPaths(this, fork, fork);
+    for(Component* child : children)
+        fork->InsertSharedChild(child);
+    return fork;
+}
+
+Component* Component::GetRoot()
+{
+    Component* root = this;
+    while(root->parent != NULL)
+        root = root->parent;
+    return root;
+}
+void Component::EnableSubcomponentIndex()
+{
+    Component* root = GetRoot();
+    if(root->subcomponentIndex != NULL)
+        return;
+    root->subcomponentIndex = new ComponentIndex();
+    root->subcomponentIndex->AddSubtree(root);
+}
+void Component::DisableSubcomponentIndex()
+{
+    Component* root = GetRoot();
+    delete root->subcomponentIndex;
+    root->subcomponentIndex = NULL;
+}
+bool Component::HasSubcomponentIndex()
+{
+    return GetRoot()->subcomponentIndex != NULL;
+}
+
 Component* Component::GetChild(int _id)
 {
+    if(children.size() > SYS_SAGE_INDEX_MIN_CHILDREN)
+    {
+        ComponentIndex* index = GetRoot()->subcomponentIndex;
+        Component* ret;
+        if(index != NULL && index->FindChild(this, _id, &ret))
+            return ret;
+    }
     for(Component* child: children)
     {
         if(child->id == _id)
@@ -86,48 +910,117 @@ vector<Component*> Component::GetAllChildrenByType(int _componentType)
     return ret;
 }
 
-int Component::GetNumThreads()
+Component* Component::GetChildByTypeMask(int _componentTypeMask)
 {
-    if(componentType == SYS_SAGE_COMPONENT_THREAD)
-        return 1;
-    int numPu = 0;
-    for(Component * child: children)
+    for(Component* child: children)
     {
-        numPu += child->GetNumThreads();
+        if(child->GetComponentType() & _componentTypeMask)
+            return child;
     }
-    return numPu;
+    return NULL;
 }
 
-int Component::GetTopoTreeDepth()
+vector<Component*> Component::GetAllChildrenByTypeMask(int _componentTypeMask)
 {
-    if(children.empty()) //is leaf
-        return 0;
-    int maxDepth = 0;
-    for(Component* child: children)
+    vector<Component*> ret;
+    for(Component * child : children)
     {
-        int subtreeDepth = child->GetTopoTreeDepth();
-        if(subtreeDepth > maxDepth)
-            maxDepth = subtreeDepth;
+        if(child->GetComponentType() & _componentTypeMask)
+            ret.push_back(child);
     }
-    return maxDepth + 1;
+    return ret;
 }
 
-void Component::GetComponentsNLevelsDeeper(vector<Component*>* outArray, int depth)
+int Component::GetNumThreads()
 {
+    if(componentType == SYS_SAGE_COMPONENT_THREAD)
+        return 1;
+    return subtreeTypeCounts[ComponentTypeIndex(SYS_SAGE_COMPONENT_THREAD)];
+}
 
-    if(depth <= 0)
-    {
-        outArray->push_back(this);
-        // depth++;
+int Component::GetTopoTreeDepth()
+{
+    return subtreeHeight;
+}
+
+int Component::GetDepth()
+{
+    return depth;
+}
+void Component::UpdateSubtreeDepth(int _depth)
+{
+    if(depth == _depth)
         return;
+    depth = _depth;
+    for(Component* child : children)
+        child->UpdateSubtreeDepth(_depth + 1);
+}
+
+const CpuSet& Component::GetCpuSet()
+{
+    if(!cpusetValid)
+    {
+        cpuset = CpuSet();
+        if(componentType == SYS_SAGE_COMPONENT_THREAD)
+            cpuset.Set(id);
+        for(Component* child : children)
+            cpuset |= child->GetCpuSet();
+        cpusetValid = true;
     }
-    for(Component* child: children)
+    return cpuset;
+}
+void Component::InvalidateCpuSet()
+{
+    //an invalid cpuset implies invalid cpusets of all ancestors, so the walk can stop there
+    for(Component* a = this; a != NULL && a->cpusetValid; a = a->parent)
+        a->cpusetValid = false;
+}
+Component* Component::FindSmallestComponentCovering(const CpuSet& set, int componentTypeMask)
+{
+    if(set.IsEmpty() || !set.IsSubsetOf(GetCpuSet()))
+        return NULL;
+    Component* found = (componentType & componentTypeMask) ? this : NULL;
+    for(Component* c = this; c != NULL; )
     {
-        cout << GetComponentTypeStr() << " (name " << name << ") id " << id << " - children: " << children.size();
-        cout << " depth: " << depth<<"\n";
-        child->GetComponentsNLevelsDeeper(outArray, depth - 1);
+        Component* next = NULL;
+        for(Component* child : c->children)
+        {
+            if(set.IsSubsetOf(child->GetCpuSet()))
+            {
+                next = child;
+                break;
+            }
+        }
+        if(next != NULL && (next->componentType & componentTypeMask))
+            found = next;
+        c = next;
+    }
+    return found;
+}
+
+void Component::GetComponentsNLevelsDeeper(vector<Component*>* outArray, int depth)
+{
+    span<Component* const> level = GetComponentsNLevelsDeeper(std::max(depth, 0));
+    outArray->insert(outArray->end(), level.begin(), level.end());
+}
+span<Component* const> Component::GetComponentsNLevelsDeeper(int _depth)
+{
+    if(_depth < 0 || _depth > subtreeHeight)
+        return {};
+    if(_depth == 1)
+        return span<Component* const>(children);
+    if(!UpdateTreeLabels())
+        return {};
+    return treeLabels->Level(treeLabels->depth[eulerFirst] + _depth, eulerFirst, eulerLast);
+}
+void Component::GetSubtreeNodeListBreadthFirst(vector<Component*>* outArray)
+{
+    outArray->reserve(outArray->size() + subtreeSize + 1);
+    for(int d = 0; d <= subtreeHeight; d++)
+    {
+        span<Component* const> level = GetComponentsNLevelsDeeper(d);
+        outArray->insert(outArray->end(), level.begin(), level.end());
     }
-    return;
 }
 
 void Component::GetSubcomponentsByType(vector<Component*>* outArray, int _componentType)
@@ -143,11 +1036,8 @@ void Component::GetSubcomponentsByType(vector<Component*>* outArray, int _compon
 
 void Component::GetSubtreeNodeList(vector<Component*>* outArray)
 {
-    outArray->push_back(this);
-    for(Component * child : children)
-    {
-        child->GetSubtreeNodeList(outArray);
-    }
+    for(Component* c : Subtree())
+        outArray->push_back(c);
     return;
 }
 
@@ -156,13 +1046,21 @@ Component* Component::FindSubcomponentById(int _id, int _componentType)
     return GetSubcomponentById(_id, _componentType);
 }
 Component* Component::GetSubcomponentById(int _id, int _componentType)
+{
+    ComponentIndex* index = GetRoot()->subcomponentIndex;
+    Component* ret;
+    if(index != NULL && index->FindInSubtree(this, _id, _componentType, &ret))
+        return ret;
+    return SearchSubcomponentById(_id, _componentType);
+}
+Component* Component::SearchSubcomponentById(int _id, int _componentType)
 {
     if(componentType == _componentType && id == _id){
         return this;
     }
     for(Component * child : children)
     {
-        Component* ret = child->GetSubcomponentById(_id, _componentType);
+        Component* ret = child->SearchSubcomponentById(_id, _componentType);
         if(ret != NULL)
         {
             return ret;
@@ -183,37 +1081,77 @@ vector<Component*> Component::GetAllSubcomponentsByType(int _componentType)
 }
 void Component::GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType)
 {
-    if(componentType == _componentType){
-        outArray->push_back(this);
-    }
-    for(Component * child : children)
+    for(Component* c : Subtree())
     {
-        child->GetAllSubcomponentsByType(outArray, _componentType);
+        if(c->GetComponentType() == _componentType)
+            outArray->push_back(c);
     }
     return;
 }
 
-int Component::CountAllSubcomponents()
+void Component::GetAllSubcomponentsByTypeMask(vector<Component*>* outArray, int _componentTypeMask)
 {
-    int cnt = children.size();
-    for(Component * child : children)
+    for(Component* c : SubtreeOfType(_componentTypeMask))
     {
-        cnt += child->CountAllSubcomponents();
+        if(c != this)
+            outArray->push_back(c);
     }
-    return cnt;
+}
+vector<Component*> Component::GetAllSubcomponentsByTypeMask(int _componentTypeMask)
+{
+    vector<Component*> ret;
+    GetAllSubcomponentsByTypeMask(&ret, _componentTypeMask);
+    return ret;
+}
+map<int, vector<Component*> > Component::GetAllSubcomponentsByTypeMaskBucketed(int _componentTypeMask)
+{
+    map<int, vector<Component*> > ret;
+    for(Component* c : SubtreeOfType(_componentTypeMask))
+    {
+        if(c != this)
+            ret[c->GetComponentType()].push_back(c);
+    }
+    return ret;
+}
+
+int Component::CountAllSubcomponents()
+{
+    return subtreeSize;
 }
 
 int Component::CountAllSubcomponentsByType(int _componentType)
 {
+    int idx = ComponentTypeIndex(_componentType);
+    if(idx >= 0)
+        return subtreeTypeCounts[idx];
+
     int cnt = 0;
-    for(Component * child : children)
+    for(Component* c : Subtree())
     {
-        if(child->GetComponentType() == _componentType)
+        if(c != this && c->GetComponentType() == _componentType)
             cnt++;
     }
-    for(Component * child : children)
+    return cnt;
+}
+
+int Component::CountAllSubcomponentsByTypeMask(int _componentTypeMask)
+{
+    if((_componentTypeMask & ~((1 << SYS_SAGE_COMPONENT_NUM_TYPES) - 1)) == 0)
     {
-        cnt += child->CountAllSubcomponentsByType(_componentType);
+        int cnt = 0;
+        for(int t = 0; t < SYS_SAGE_COMPONENT_NUM_TYPES; t++)
+        {
+            if(_componentTypeMask & (1 << t))
+                cnt += subtreeTypeCounts[t];
+        }
+        return cnt;
+    }
+
+    int cnt = 0;
+    for(Component* c : SubtreeOfType(_componentTypeMask))
+    {
+        if(c != this)
+            cnt++;
     }
     return cnt;
 }
@@ -236,45 +1174,167 @@ Component* Component::GetAncestorType(int _componentType)
 
 void Component::AddDataPath(DataPath* p, int orientation)
 {
+    vector<DataPath*>* list;
+    vector<DataPathBucket>* buckets;
     if(orientation == SYS_SAGE_DATAPATH_OUTGOING)
-        dp_outgoing.push_back(p);
+    {
+        list = &dp_outgoing;
+        buckets = &dp_outgoing_by_type;
+    }
     else if(orientation == SYS_SAGE_DATAPATH_INCOMING)
-        dp_incoming.push_back(p);
+    {
+        list = &dp_incoming;
+        buckets = &dp_incoming_by_type;
+    }
+    else
+        return;
+
+    vector<DataPath*>* bucket = FindDataPathBucket(p->GetDpType(), orientation);
+    if(bucket == NULL)
+    {
+        buckets->push_back({p->GetDpType(), {}});
+        bucket = &buckets->back().dataPaths;
+    }
+    //the first free membership of p at this component and orientation (a bidirectional DataPath from a component to itself has two)
+    for(int m = 0; m < 4; m++)
+    {
+        Component* c;
+        int o;
+        if(p->GetMembership(m, &c, &o) && c == this && o == orientation && p->listSlot[m] < 0)
+        {
+            p->listSlot[m] = list->size();
+            p->bucketSlot[m] = bucket->size();
+            break;
+        }
+    }
+    list->push_back(p);
+    bucket->push_back(p);
+    dpChangeVersion = ++dataPathVersion;
+}
+
+void Component::EraseDataPathSlot(vector<DataPath*>* list, int slot, int orientation, bool inBucket)
+{
+    int last = list->size() - 1;
+    if(slot != last)
+    {
+        DataPath* moved = list->back();
+        (*list)[slot] = moved;
+        for(int m = 0; m < 4; m++)
+        {
+            Component* c;
+            int o;
+            int& movedSlot = inBucket ? moved->bucketSlot[m] : moved->listSlot[m];
+            if(movedSlot == last && moved->GetMembership(m, &c, &o) && c == this && o == orientation)
+            {
+                movedSlot = slot;
+                break;
+            }
+        }
+    }
+    list->pop_back();
+}
+
+void Component::RemoveDataPath(DataPath* p, int orientation)
+{
+    vector<DataPath*>* list = GetDataPaths(orientation);
+    if(list == NULL)
+        return;
+    vector<DataPath*>* bucket = FindDataPathBucket(p->GetDpType(), orientation);
+    for(int m = 0; m < 4; m++)
+    {
+        Component* c;
+        int o;
+        if(p->listSlot[m] < 0 || !p->GetMembership(m, &c, &o) || c != this || o != orientation)
+            continue;
+        EraseDataPathSlot(list, p->listSlot[m], orientation, false);
+        EraseDataPathSlot(bucket, p->bucketSlot[m], orientation, true);
+        p->listSlot[m] = -1;
+        p->bucketSlot[m] = -1;
+        dpChangeVersion = ++dataPathVersion;
+    }
+}
+
+int Component::DeleteDataPathsByType(int dp_type, bool withSubtree)
+{
+    int deleted = 0;
+    for(int orientation : {SYS_SAGE_DATAPATH_OUTGOING, SYS_SAGE_DATAPATH_INCOMING})
+    {
+        //DeleteDataPath() does not add buckets, so the pointer stays valid
+        vector<DataPath*>* bucket = FindDataPathBucket(dp_type, orientation);
+        while(bucket != NULL && !bucket->empty())
+        {
+            bucket->back()->DeleteDataPath();
+            deleted++;
+        }
+    }
+    if(withSubtree)
+    {
+        for(Component* child : children)
+            deleted += child->DeleteDataPathsByType(dp_type, true);
+    }
+    return deleted;
+}
+
+vector<DataPath*>* Component::FindDataPathBucket(int dp_type, int orientation)
+{
+    //there are only a few distinct dp_types per component, so the buckets are searched linearly
+    vector<DataPathBucket>& buckets = orientation == SYS_SAGE_DATAPATH_OUTGOING ? dp_outgoing_by_type : dp_incoming_by_type;
+    for(DataPathBucket& b : buckets)
+    {
+        if(b.dp_type == dp_type)
+            return &b.dataPaths;
+    }
+    return NULL;
+}
+
+const vector<DataPath*>& Component::GetDataPathsByType(int dp_type, int orientation)
+{
+    static const vector<DataPath*> empty;
+    if(orientation != SYS_SAGE_DATAPATH_OUTGOING && orientation != SYS_SAGE_DATAPATH_INCOMING)
+        return empty;
+    vector<DataPath*>* bucket = FindDataPathBucket(dp_type, orientation);
+    return bucket == NULL ? empty : *bucket;
 }
 
 DataPath* Component::GetDpByType(int dp_type, int orientation)
 {
     if(orientation & SYS_SAGE_DATAPATH_OUTGOING){
-        for(DataPath* dp : dp_outgoing){
-            if(dp->GetDpType() == dp_type)
-                return dp;
-        }
+        const vector<DataPath*>& dps = GetDataPathsByType(dp_type, SYS_SAGE_DATAPATH_OUTGOING);
+        if(!dps.empty())
+            return dps.front();
     }
     if(orientation & SYS_SAGE_DATAPATH_INCOMING){
-        for(DataPath* dp : dp_incoming){
-            if(dp->GetDpType() == dp_type)
-                return dp;
-        }
+        const vector<DataPath*>& dps = GetDataPathsByType(dp_type, SYS_SAGE_DATAPATH_INCOMING);
+        if(!dps.empty())
+            return dps.front();
     }
     return NULL;
 }
 void Component::GetAllDpByType(vector<DataPath*>* outDpArr, int dp_type, int orientation)
 {
     if(orientation & SYS_SAGE_DATAPATH_OUTGOING){
-        for(DataPath* dp : dp_outgoing){
-            if(dp->GetDpType() == dp_type)
-                outDpArr->push_back(dp);
-        }
+        const vector<DataPath*>& dps = GetDataPathsByType(dp_type, SYS_SAGE_DATAPATH_OUTGOING);
+        outDpArr->insert(outDpArr->end(), dps.begin(), dps.end());
     }
     if(orientation & SYS_SAGE_DATAPATH_INCOMING){
-        for(DataPath* dp : dp_incoming){
-            if(dp->GetDpType() == dp_type)
-                outDpArr->push_back(dp);
-        }
+        const vector<DataPath*>& dps = GetDataPathsByType(dp_type, SYS_SAGE_DATAPATH_INCOMING);
+        outDpArr->insert(outDpArr->end(), dps.begin(), dps.end());
     }
     return;
 }
 
+const vector<DataPathMatrix*>& Component::GetDataPathMatrices(){ return dp_matrices; }
+
+DataPathMatrix* Component::GetDataPathMatrix(int dp_type)
+{
+    for(DataPathMatrix* m : dp_matrices)
+    {
+        if(m->GetDpType() == dp_type)
+            return m;
+    }
+    return NULL;
+}
+
 vector<DataPath*>* Component::GetDataPaths(int orientation)
 {
     if(orientation == SYS_SAGE_DATAPATH_INCOMING)
@@ -382,6 +1442,7 @@ int Component::GetTopologySize(unsigned * out_component_size, unsigned * out_dat
     int dataPathSize = 0;
     dataPathSize += dp_incoming.size() * sizeof(DataPath*);
     dataPathSize += dp_outgoing.size() * sizeof(DataPath*);
+    dataPathSize += (dp_incoming_by_type.size() + dp_outgoing_by_type.size()) * sizeof(DataPathBucket) + (dp_incoming.size() + dp_outgoing.size()) * sizeof(DataPath*);
     for(auto it = std::begin(dp_incoming); it != std::end(dp_incoming); ++it) {
         if(!counted_dataPaths->count((DataPath*)(*it))) {
             //cout << "new datapath " << (DataPath*)(*it) << endl;
@@ -423,17 +1484,26 @@ void Component::DeleteAllDataPaths()
         DataPath * dp = dp_incoming.back();
         dp->DeleteDataPath();
     }
+    while(!dp_matrices.empty())
+        dp_matrices.back()->RemoveComponent(this);
 }
 void Component::DeleteSubtree()
 {
     while(children.size() > 0)
     {
-        children[0]->Delete(true); // Recursively free children
+        if(children[0]->GetNumParents() > 1)
+            RemoveChild(children[0]); // shared subtree -- only drop the reference
+        else
+            children[0]->Delete(true); // Recursively free children
     }
     return;
 }
 void Component::Delete(bool withSubtree)
 {
+    // A shared component is removed from all its parents
+    for(Component* p = LastSharingParent(this); p != NULL; p = LastSharingParent(this))
+        p->RemoveChild(this);
+
     // Delete subtree and all data paths
     if (withSubtree)
     {
@@ -468,10 +1538,29 @@ void Component::Delete(bool withSubtree)
 }
 
 Component* Component::GetParent(){return parent;}
-void Component::SetParent(Component* _parent){parent = _parent;}
+void Component::SetParent(Component* _parent)
+{
+    //only the root of a Component Tree holds the index; a component that becomes a child drops its own one (InsertChild re-indexes its subtree in the new root)
+    if(_parent != NULL && subcomponentIndex != NULL)
+        DisableSubcomponentIndex();
+    //likewise for the labels of the tree
+    if(_parent != NULL && ownTreeLabels != NULL)
+    {
+        delete ownTreeLabels;
+        ownTreeLabels = NULL;
+    }
+    if(parent != _parent)
+    {
+        StructureChanged(); //the tree this component leaves
+        parent = _parent;
+        StructureChanged(); //the tree it joins
+    }
+    UpdateSubtreeDepth(_parent == NULL ? 0 : _parent->depth + 1);
+}
 vector<Component*>* Component::GetChildren(){return &children;}
 int Component::GetComponentType(){return componentType;}
 string Component::GetName(){return name;}
+void Component::SetName(string _name){name = _name;}
 int Component::GetId(){return id;}
 
 void Storage::SetSize(long long _size){size = _size;}
@@ -488,11 +1577,13 @@ void Subdivision::SetSubdivisionType(int subdivisionType){type = subdivisionType
 int Subdivision::GetSubdivisionType(){return type;}
 
 long long Numa::GetSize(){return size;}
+void Numa::SetSize(long long _size){size = _size;}
 
 long long Memory::GetSize() {return size;}
 void Memory::SetSize(long long _size) {size = _size;}
 
 string Cache::GetCacheName(){return cache_type;}
+void Cache::SetCacheName(string _name){cache_type = _name;}
 
 int Cache::GetCacheLevel(){
 
@@ -516,6 +1607,7 @@ void Cache::SetCacheSize(long long _cache_size){cache_size = _cache_size;}
 int Cache::GetCacheLineSize(){return cache_line_size;}
 void Cache::SetCacheLineSize(int _cache_line_size){cache_line_size = _cache_line_size;}
 int Cache::GetCacheAssociativityWays(){return cache_associativity_ways;}
+void Cache::SetCacheAssociativityWays(int _associativity){cache_associativity_ways = _associativity;}
 
 Component::Component(int _id, string _name, int _componentType) : id(_id), name(_name), componentType(_componentType)
 {
@@ -531,6 +1623,37 @@ Component::Component(Component * parent, int _id, string _name, int _componentTy
     }
 }
 
+Component::~Component()
+{
+    treeVersion++;
+    delete ownTreeLabels;
+    if(sharingEntries > 0)
+    {
+        std::lock_guard<std::mutex> lock(SharingMutex());
+        if(SharingParents().erase(this) > 0)
+            sharingEntries--;
+        auto original = OriginalOf().find(this);
+        if(original != OriginalOf().end())
+        {
+            vector<Component*>& copies = CopiesOf()[original->second];
+            copies.erase(std::find(copies.begin(), copies.end(), this));
+            if(copies.empty())
+                CopiesOf().erase(original->second);
+            OriginalOf().erase(original);
+            sharingEntries--;
+        }
+        auto copies = CopiesOf().find(this);
+        if(copies != CopiesOf().end())
+        {
+            for(Component* copy : copies->second)
+                OriginalOf().erase(copy);
+            sharingEntries -= copies->second.size();
+            CopiesOf().erase(copies);
+        }
+    }
+    delete subcomponentIndex;
+}
+
 Topology::Topology():Component(0, "sys-sage Topology", SYS_SAGE_COMPONENT_TOPOLOGY){}
 
 Node::Node(int _id, string _name):Component(_id, _name, SYS_SAGE_COMPONENT_NODE){}
@@ -5,8 +5,16 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <ranges>
+#include <iterator>
+#include <algorithm>
+#include <climits>
+#include <span>
+#include <atomic>
 
 #include "defines.hpp"
+#include "AttribStore.hpp"
+#include "CpuSet.hpp"
 #include "DataPath.hpp"
 #include <libxml/parser.h>
 
@@ -23,6 +31,7 @@
 #define SYS_SAGE_COMPONENT_STORAGE 256 /**< class Storage */
 #define SYS_SAGE_COMPONENT_NODE 512 /**< class Node */
 #define SYS_SAGE_COMPONENT_TOPOLOGY 1024 /**< class Topology */
+#define SYS_SAGE_COMPONENT_NUM_TYPES 11 /**< number of the SYS_SAGE_COMPONENT_* types above (bit positions 0 .. SYS_SAGE_COMPONENT_NUM_TYPES-1) */
 
 #define SYS_SAGE_SUBDIVISION_TYPE_NONE 1 /**< Generic Subdivision type. */
 #define SYS_SAGE_SUBDIVISION_TYPE_GPU_SM 2 /**< Subdivision type for GPU SMs */
@@ -35,14 +44,33 @@
 
 using namespace std;
 class DataPath;
+class DataPathMatrix;
+class FrozenTopology;
+class ComponentIndex;
+class ComponentTreeLabels;
+class ComponentSubtreeView;
+class ComponentAncestorView;
+
+/**
+@private
+DataPaths of one dp_type within dp_outgoing or dp_incoming of a Component.
+*/
+struct DataPathBucket {
+    int dp_type;
+    vector<DataPath*> dataPaths;
+};
 
 /**
 Generic class Component - all components inherit from this class, i.e. this class defines attributes and methods common to all components.
 \n Therefore, these can be used universally among all components. Usually, a Component instance would be an instance of one of the child classes, but a generic component (instance of class Component) is also possible.
+\n Thread safety: the tree queries that build indices on demand (IsAncestorOf(), GetLowestCommonAncestor(), GetSharedComponent(), GetComponentsNLevelsDeeper(), GetSubtreeNodeListBreadthFirst(), Query()) may be called concurrently from several threads, on the same or on different Component Trees, as long as no thread modifies these trees in the meantime; once the labels of a tree are up to date, these queries do not take a lock. Modifying a Component Tree (InsertChild(), RemoveChild(), Delete(), Unshare(), attributes, DataPaths, ...) requires that no other thread accesses it at the same time; different Component Trees may be built, modified and deleted concurrently. Trees linked by a shared subtree (InsertSharedChild() with a parent in another tree) or by Fork() count as one Component Tree for this rule. Other lazily computed values (GetCpuSet(), EnableSubcomponentIndex()) are not synchronized.
 */
 class Component {
 public:
-    Component(const Component& c): id(c.id), depth(c.depth), name(c.name), componentType(c.componentType) {};
+    /**
+    Copies the id, name and component type. The copy is not part of a Component Tree (its depth is 0); children, DataPaths and attributes are not copied.
+    */
+    Component(const Component& c): id(c.id), name(c.name), componentType(c.componentType) {};
 
     /**
     Generic Component constructor (no automatic insertion in the Component Tree). Usually one of the derived subclasses for different Component Types will be created. Sets:
@@ -60,9 +88,19 @@ public:
     */
     Component(Component * parent, int _id = 0, string _name = "unknown", int _componentType = SYS_SAGE_COMPONENT_NONE);
     /**
-     * TODO
+    Frees the (componentType, id) index if this component is the root of an indexed Component Tree. The children are not deleted -- use Delete() for that.
+    */
+    virtual ~Component();
+    /**
+    Allocates the component in the TopologyArena of the current TopologyArena::Scope, or on the heap if there is none.
+    @see TopologyArena
+    */
+    static void* operator new(size_t size);
+    /**
+    Frees a heap-allocated component; components living in a TopologyArena are released together with the arena.
+    @see TopologyArena
     */
-    virtual ~Component() = default;
+    static void operator delete(void* ptr);
     /**
     Inserts a Child component to this component (in the Component Tree).
     The child pointer will be inserted at the end of std::vector of children (retrievable through GetChildren(), GetChild(int _id) etc.)
@@ -83,6 +121,52 @@ public:
     */
     void SetParent(Component* parent);
     /**
+    Inserts a child which stays a child of its current parent as well, i.e. the subtree of child is shared by several parents and stored only once (e.g. the identical sockets of the Nodes of a homogeneous cluster).
+    \n If child has no parent yet, this is the same as InsertChild().
+    @param child - the (root of the) subtree to share
+    @see ShareIdenticalSubtrees() for the semantics of shared subtrees
+    */
+    void InsertSharedChild(Component* child);
+    /**
+    Deduplicates the subtree of this component: identical subtrees (same component types, ids, names, type-specific properties and attributes, without DataPaths) are detected by a structural hash, the duplicates are deleted and replaced by references to the first instance.
+    \n Downward traversals (GetChildren(), Subtree(), GetAllSubcomponentsByType(), CountAllSubcomponents(), exportToXml(), ...) see each reference as a separate copy. Upward queries from inside a shared subtree follow the first parent only, i.e. the other parents are not ancestors of the shared subtree, and their result is the one of the first instance for every reference: GetParent(), GetRoot(), GetDepth(), GetAncestorType(), Ancestors(), IsAncestorOf(), GetLowestCommonAncestor(), GetSharedComponent() and TopologyView::Contains() are therefore unreliable for components for which IsShared() is true. The first instance (in DFS pre-order) of the identical subtrees is kept, so the first parent is the one of the first instance. The (componentType, id) index is disabled and should not be used with shared subtrees.
+    \n A shared subtree must not be modified in place (the change would be visible in all instances and the cached aggregates of the other instances would not be updated) -- use Unshare() (copy-on-write) first.
+    @return the number of deleted Components
+    @see InsertSharedChild()
+    @see Unshare()
+    */
+    int ShareIdenticalSubtrees();
+    /**
+    @return the number of parents referencing this component (0 for a root, 1 normally, more for a shared subtree)
+    */
+    int GetNumParents();
+    /**
+    @return true if this component or one of its ancestors (following GetParent()) is referenced by more than one parent
+    */
+    bool IsShared();
+    /**
+    Copy-on-write for shared subtrees: makes descendant private to the subtree of this component, so that it can be modified without affecting the other instances. Each shared component on the path from this component to descendant is replaced (in this instance only) by a copy whose children are shared with the original.
+    \n The DataPaths of a copied component are duplicated between the copies only: a DataPath is duplicated once both of its endpoints have a copy in the subtree of this component (e.g. a DataPath from a L3 cache to a Core appears in this instance after both were unshared). DataPaths of the originals are left untouched, and no DataPath is attached to a component that is not a copy.
+    @param descendant - a component in the subtree of this component (e.g. found with GetSubcomponentById() called on this component)
+    @return the private copy of descendant (descendant itself if it was not shared), or NULL if descendant is not in the subtree
+    */
+    Component* Unshare(Component* descendant);
+    /**
+    Deep copy of the subtree of this component: the components with their type-specific properties and attributes (cloned via AttribRegistry::CloneAttribs()), and the DataPaths whose source and target both lie in the subtree (remapped to the copies). DataPaths leading out of the subtree are not copied. Shared subtrees (see ShareIdenticalSubtrees()) are copied for each reference.
+    @return the root of the copy (without a parent), or NULL if the subtree contains a component of a user-defined type (which cannot be copied)
+    @see Fork()
+    */
+    Component* CloneSubtree();
+    /**
+    Copy-on-write fork of the subtree of this component, e.g. to model a different CAT or MIG partitioning without copying the whole topology.
+    \n Only this component is copied; its children are shared with the original (see InsertSharedChild()). Before a component of the fork is modified, it is materialized with Unshare(), which copies only the components on the path from the fork to it (the DataPaths among the copies are duplicated as described in Unshare()).
+    \n Deleting the fork (Delete(true)) deletes only the materialized components.
+    @return the root of the fork (without a parent), or NULL if this component is of a user-defined type
+    @see Unshare()
+    @see CloneSubtree()
+    */
+    Component* Fork();
+    /**
     Prints the whole subtree of this component (including the component itself) to stdout. The tree is printed in DFS order, so that the hierarchy can be easily seen. Each child is indented by "  ".
     For each component in the subtree, the following is printed: "<string component type> (name <name>) id <id> - children: <num children>
     */
@@ -105,6 +189,12 @@ public:
     */
     string GetName();
     /**
+    Sets the name of the component.
+    @param _name - the new name
+    @see name
+    */
+    void SetName(string _name);
+    /**
     Returns id of the component.
     @return id
     @see id
@@ -156,6 +246,8 @@ public:
     /**
     Retrieve a Componet* to a child with child.id=_id.
     \n Should there be more children with the same id, the first match will be retrieved (i.e. the one with lower index in the children array.)
+    \n For components with many children, the (componentType, id) index is used if the Component Tree has one.
+    @see EnableSubcomponentIndex()
     */
     Component* GetChild(int _id);
     /**
@@ -167,6 +259,17 @@ public:
     */
     vector<Component*> GetAllChildrenByType(int _componentType);
     /**
+    Returns the first child whose componentType matches the mask.
+    @param _componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types, e.g. SYS_SAGE_COMPONENT_CACHE | SYS_SAGE_COMPONENT_NUMA
+    @return Component * matching the mask. NULL if no match found
+    */
+    Component* GetChildByTypeMask(int _componentTypeMask);
+    /**
+    Returns all children whose componentType matches the mask.
+    @param _componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types
+    */
+    vector<Component*> GetAllChildrenByTypeMask(int _componentTypeMask);
+    /**
     OBSOLETE. Use GetSubcomponentById instead. This function will be removed in the future.
     */
     Component* FindSubcomponentById(int _id, int _componentType);
@@ -177,6 +280,8 @@ public:
     /**
     Searches the subtree to find a component with a matching id and componentType, i.e. looks for a certain component with a matching ID. The search is a DFS. The search starts with the calling component.
     \n Returns first occurence that matches these criteria.
+    \n If the Component Tree has a (componentType, id) index, the lookup is answered from the index without traversing the subtree.
+    @see EnableSubcomponentIndex()
     @param _id - the id to look for
     @param _componentType - the component type where to look for the id
     @return Component * matching the criteria. Returns the first match. NULL if no match found
@@ -191,15 +296,66 @@ public:
     */
     vector<Component*> GetAllSubcomponentsByType(int _componentType);
     /**
-     * TODO
+    Collects all components in the subtree (excluding this Component) whose componentType matches the mask, in a single DFS (pre-order).
+    @param outArray - output parameter; the matching components are pushed back to it
+    @param _componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types, e.g. SYS_SAGE_COMPONENT_CORE | SYS_SAGE_COMPONENT_CACHE
+    @see SubtreeOfType(int componentTypeMask)
+    */
+    void GetAllSubcomponentsByTypeMask(vector<Component*>* outArray, int _componentTypeMask);
+    /**
+    @return all components in the subtree (excluding this Component) whose componentType matches the mask, in DFS pre-order
+    @see GetAllSubcomponentsByTypeMask(vector<Component*>* outArray, int _componentTypeMask)
+    */
+    vector<Component*> GetAllSubcomponentsByTypeMask(int _componentTypeMask);
+    /**
+    Like GetAllSubcomponentsByTypeMask(), but the result is bucketed per component type (single DFS).
+    @param _componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types
+    @return componentType -> matching components in DFS pre-order
+    */
+    map<int, vector<Component*> > GetAllSubcomponentsByTypeMaskBucketed(int _componentTypeMask);
+    /**
+    Typed variant of GetAllSubcomponentsByType(), e.g. vector<Cache*> caches = topo->GetAllSubcomponents<Cache>();
+    @return all components of the class T (Thread, Core, Cache, Numa, ...) in the subtree (excluding this Component), in DFS pre-order
+    */
+    template<class T> vector<T*> GetAllSubcomponents();
+    /**
+    Returns the number of all Components in the subtree (excluding this Component).
+    \n O(1) -- the count is maintained by InsertChild() and RemoveChild().
     */
     int CountAllSubcomponents();
     /**
-     * TODO
+    Returns the number of Components of the given type in the subtree (excluding this Component).
+    \n O(1) for the SYS_SAGE_COMPONENT_* types (maintained by InsertChild() and RemoveChild()); other (user-defined) component types are counted by traversing the subtree.
+    @param _componentType - the desired component type
     */
     int CountAllSubcomponentsByType(int _componentType);
     /**
+    Returns the number of Components in the subtree (excluding this Component) whose componentType matches the mask.
+    \n O(1) for masks of SYS_SAGE_COMPONENT_* types; masks with other bits are counted by traversing the subtree.
+    @param _componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types
+    */
+    int CountAllSubcomponentsByTypeMask(int _componentTypeMask);
+    /**
+    @return the root of the Component Tree this component belongs to (the topmost ancestor, or the component itself if it has no parent)
+    */
+    Component* GetRoot();
+    /**
+    Creates a hash index keyed by (componentType, id) for the whole Component Tree this component belongs to. The index is stored in the root and makes GetSubcomponentById() and GetChild() O(1) lookups.
+    \n Once enabled, the index is kept up to date by InsertChild(), RemoveChild(), SetParent() and Delete(). Changes done directly on the vector returned by GetChildren() are not tracked.
+    \n Enabling an already enabled index has no effect.
+    */
+    void EnableSubcomponentIndex();
+    /**
+    Frees the (componentType, id) index of the Component Tree this component belongs to (if there is one). Lookups fall back to the DFS search.
+    */
+    void DisableSubcomponentIndex();
+    /**
+    @return true if the Component Tree this component belongs to has a (componentType, id) index
+    */
+    bool HasSubcomponentIndex();
+    /**
     Moves up the tree until a parent of given type.
+    \n In a shared subtree, only the ancestors of the first instance are searched (see ShareIdenticalSubtrees()).
     @param _componentType - the desired component type
     @return Component * matching the criteria. NULL if no match found
     */
@@ -208,21 +364,83 @@ public:
     OBSOLETE. Use GetAncestorType instead. This function will be removed in the future.
     */
     Component* FindParentByType(int _componentType);
+    /**
+    Checks whether this Component is a (direct or indirect) parent of another Component.
+    \n O(1): uses interval labels (Euler tour) of the Component Tree. The labels are kept per Component Tree (in its root) and recomputed (O(n)) on the first query after a change of the structure of this Component Tree; changes of other trees do not affect them.
+    @param _c - the other Component
+    @return true if _c is in the subtree of this Component (false for _c == this)
+    */
+    bool IsAncestorOf(Component* _c);
+    /**
+    Returns the lowest common ancestor of this Component and another Component, i.e. the deepest Component containing both in its subtree.
+    \n O(1): range-minimum query over the Euler tour of the Component Tree (labels recomputed as in IsAncestorOf()).
+    @param _c - the other Component
+    @return the lowest common ancestor (this, if _c is in the subtree of this Component, and vice versa); NULL if the Components are not in the same Component Tree
+    */
+    Component* GetLowestCommonAncestor(Component* _c);
+    /**
+    Returns the closest Component of the given type(s) shared by this Component and another Component, e.g. the smallest Cache shared by two Threads.
+    @param _c - the other Component
+    @param _componentTypeMask - bitwise OR of the desired SYS_SAGE_COMPONENT_* types
+    @return the lowest common ancestor or its closest ancestor matching the mask; NULL if there is none
+    */
+    Component* GetSharedComponent(Component* _c, int _componentTypeMask);
+    /**
+    Returns a process-wide counter that changes with every change of the structure of any Component Tree (InsertChild(), RemoveChild(), SetParent(), deleting a Component). Data derived from the tree structure can be cached and recomputed once the version changes.
+    */
+    static unsigned long long GetTreeVersion();
+    /**
+    Returns a process-wide counter that changes whenever a DataPath is added to or removed from any Component. Data derived from the DataPath graph (e.g. DataPathGraph) can be cached and recomputed once the version changes.
+    @see GetDataPathChangeVersion()
+    */
+    static unsigned long long GetDataPathVersion();
+    /**
+    @returns the value of GetDataPathVersion() after the last change of the DataPaths of this component -- a DataPath added or removed, or the bandwidth or latency of one set (0 if it never had any)
+    */
+    unsigned long long GetDataPathChangeVersion();
+    /**
+    !!Normally should not be called; called by DataPath::SetBw() and DataPath::SetLatency()!!
+    Marks the DataPaths of this component as changed, i.e. advances GetDataPathVersion() and GetDataPathChangeVersion().
+    */
+    void NotifyDataPathChange();
 
     /**
     OBSOLETE. Use int CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD) instead.
-    Returns the number of Components of type SYS_SAGE_COMPONENT_THREAD in the subtree.
+    Returns the number of Components of type SYS_SAGE_COMPONENT_THREAD in the subtree (1 if this Component is a Thread).
     */
     int GetNumThreads();
     /**
     Retrieves maximal distance to a leaf (i.e. the depth of the subtree).
     \n 0=leaf, 1=children are leaves, 2=at most children's children are leaves .....
+    \n O(1) -- the height is maintained by InsertChild() and RemoveChild().
     @return maximal distance to a leaf
     */
     int GetTopoTreeDepth();//0=empty, 1=1element,...
     /**
-    Retrieves a std::vector of Component pointers, which reside 'depth' levels deeper. The tree is traversed in order as the children are stored in std::vector children.
+    Retrieves the set of the hardware threads in the subtree, i.e. the ids of all Threads in the subtree (including this component, if it is a Thread).
+    \n Computed lazily and cached; InsertChild() and RemoveChild() invalidate the cached sets of the component and its ancestors. Changes done directly on the vector returned by GetChildren() are not tracked.
+    @return the cpuset of the component (valid until the subtree changes)
+    @see CpuSet
+    */
+    const CpuSet& GetCpuSet();
+    /**
+    Finds the deepest component in the subtree (including this component) whose cpuset contains the whole given set, e.g. the smallest Cache or Numa shared by a group of threads.
+    @param set - the hardware threads to cover
+    @param componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types that may be returned (default: any type)
+    @return the deepest covering component of a matching type, or NULL if the set is empty or is not covered by this component
+    @see GetCpuSet()
+    */
+    Component* FindSmallestComponentCovering(const CpuSet& set, int componentTypeMask = -1);
+    /**
+    Retrieves the depth of this component in its Component Tree (0=root, 1=children of the root, ...).
+    \n O(1) -- the depth is maintained by SetParent()/InsertChild() for the whole moved subtree. In a shared subtree (see ShareIdenticalSubtrees()), the depth is relative to the first parent.
+    @return the distance to the root
+    */
+    int GetDepth();
+    /**
+    Retrieves a std::vector of Component pointers, which reside 'depth' levels deeper, in DFS order (as the children are stored in std::vector children).
     \n E.g. if depth=1, only children of the current are retrieved; if depth=2, only children of the children are retrieved..
+    \n The components are copied from the level index, see GetComponentsNLevelsDeeper(int depth).
     @param depth - how many levels down the tree should be looked
     @param outArray - output parameter (vector with results)
         \n An input is pointer to a std::vector<Component *>, in which the elements will be pushed. It must be allocated before the call (but does not have to be empty).
@@ -230,6 +448,58 @@ public:
     */
     void GetComponentsNLevelsDeeper(vector<Component*>* outArray, int depth);
     /**
+    Components which reside 'depth' levels deeper (depth=0 is this component, depth=1 its children, ...), in the same order as GetComponentsNLevelsDeeper(vector<Component*>* outArray, int depth).
+    \n The components are looked up in the level index of the Component Tree (all components of one depth stored contiguously), i.e. O(log n) without traversal. The index is rebuilt on demand after the structure of this Component Tree changed.
+    @param depth - how many levels down the tree should be looked
+    @return view of the components (empty if there are none); only valid until the structure of this Component Tree changes
+    */
+    span<Component* const> GetComponentsNLevelsDeeper(int depth);
+    /**
+    Retrieves all components of the subtree (including this component) in breadth-first order, i.e. level by level, each level in DFS order. Uses the level index (see GetComponentsNLevelsDeeper(int depth)).
+    @param outArray - output parameter (vector with results)
+        \n An input is pointer to a std::vector<Component *>, in which the elements will be pushed. It must be allocated before the call (but does not have to be empty).
+    */
+    void GetSubtreeNodeListBreadthFirst(vector<Component*>* outArray);
+    /**
+    Lazy view of the subtree of this component (including the component itself) in DFS pre-order, i.e. in the same order as GetSubtreeNodeList() returns.
+    \n The traversal is iterative and does not allocate; it can be stopped at any time (e.g. break out of a range-based for loop) and composes with std::views (filter, take, ...).
+    \n The Component Tree must not be modified while the view is being iterated.
+    @return a forward range of Component*
+    @see GetSubtreeNodeList(vector<Component*>* outArray)
+    */
+    ComponentSubtreeView Subtree();
+    /**
+    Lazy view of all components in the subtree of this component (including the component itself) whose componentType matches the mask, in DFS pre-order.
+    @param componentTypeMask - bitwise OR of the SYS_SAGE_COMPONENT_* types to yield, e.g. SYS_SAGE_COMPONENT_CORE | SYS_SAGE_COMPONENT_THREAD
+    @return a forward range of Component*
+    @see Subtree()
+    @see GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType)
+    */
+    ComponentSubtreeView SubtreeOfType(int componentTypeMask);
+    /**
+    Evaluates a path expression on this component, e.g. topo->Query("Node/Chip[type=GPU]//Cache[level=L2]").
+    \n Each distinct expression is compiled once (process-wide, thread-safe cache of the last 256 distinct ComponentQuery plans); results are memoized against GetTreeVersion() only for queries without name, type and attribute predicates, as described in ComponentQuery.
+    @param expression - the path expression
+    @return the selected components; empty (and an error printed to stderr) if the expression is not valid
+    @see ComponentQuery
+    */
+    vector<Component*> Query(const string& expression);
+    /**
+    Lazy view of the components exactly n levels below this component (n=0 is the component itself, n=1 its children, ...), in DFS order. Subtrees deeper than n are not visited.
+    @param n - relative depth of the yielded components
+    @return a forward range of Component*
+    @see Subtree()
+    @see GetComponentsNLevelsDeeper(vector<Component*>* outArray, int depth)
+    */
+    ComponentSubtreeView AtDepth(int n);
+    /**
+    Lazy view of the ancestors of this component, starting with the parent and ending with the root of the Component Tree (the component itself is not included).
+    \n In a shared subtree, these are the ancestors of the first instance (see ShareIdenticalSubtrees()).
+    @return a forward range of Component*
+    @see GetAncestorType(int _componentType)
+    */
+    ComponentAncestorView Ancestors();
+    /**
     Retrieves a std::vector of Component pointers, which reside 'depth' levels deeper. The tree is traversed in order as the children are stored in each std::vector children.
     \n E.g. if depth=1, only children of the current are retrieved; if depth=2, only children of the children are retrieved..
     @param depth - how many levels down the tree should be looked
@@ -251,7 +521,7 @@ public:
     /**
     Returns the DataPaths of this component according to their orientation.
     @param orientation - either SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING
-    @return Pointer to std::vector<DataPath *> with the result (dp_outgoing on SYS_SAGE_DATAPATH_OUTGOING, or dp_incoming on SYS_SAGE_DATAPATH_INCOMING, otherwise NULL)
+    @return Pointer to std::vector<DataPath *> with the result (dp_outgoing on SYS_SAGE_DATAPATH_OUTGOING, or dp_incoming on SYS_SAGE_DATAPATH_INCOMING, otherwise NULL). Use the vector for reading only; DataPaths are added and removed through the DataPath constructors and DataPath::DeleteDataPath().
     @see dp_incoming
     @see dp_outgoing
     */
@@ -265,6 +535,21 @@ public:
     */
     void AddDataPath(DataPath* p, int orientation);
     /**
+    !!Normally should not be called; Use DataPath::DeleteDataPath() instead!!
+    Removes a DataPath pointer from the list of DataPaths of this component with the given orientation (and from the per-type bucket) in constant time, using the position stored in the DataPath. The last DataPath of the list takes the freed position.
+    @param p - the pointer to remove
+    @param orientation - either SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING
+    @see DataPath::DeleteDataPath()
+    */
+    void RemoveDataPath(DataPath* p, int orientation);
+    /**
+    Returns the DataPaths of this component of one dp_type. The DataPaths are kept grouped by dp_type next to dp_outgoing and dp_incoming, so the lookup does not depend on the number of DataPaths of other types.
+    @param dp_type - DataPath type (dp_type) to search for
+    @param orientation - either SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING
+    @return the DataPaths (an empty vector if there are none, or if orientation is not one of the above)
+    */
+    const vector<DataPath*>& GetDataPathsByType(int dp_type, int orientation);
+    /**
     Retrieves a DataPath * from the list of this component's data paths with matching type and orientation.
     \n The first match is returned -- first SYS_SAGE_DATAPATH_OUTGOING are searched, then SYS_SAGE_DATAPATH_INCOMING.
     @param dp_type - DataPath type (dp_type) to search for
@@ -282,6 +567,17 @@ public:
         \n The method pushes back the found data paths -- i.e. the data paths(pointers) can be found in this array after the method returns. (If no found, the vector is not changed.)
     */
     void GetAllDpByType(vector<DataPath*>* outDpArr, int dp_type, int orientation);
+    /**
+    Returns the DataPathMatrices this component is part of (as a row/column).
+    @see DataPathMatrix
+    */
+    const vector<DataPathMatrix*>& GetDataPathMatrices();
+    /**
+    Retrieves the first DataPathMatrix of dp_type this component is part of.
+    @return the matrix; NULL if there is none
+    @see DataPathMatrix
+    */
+    DataPathMatrix* GetDataPathMatrix(int dp_type);
     /**
      * TODO
     */
@@ -304,6 +600,14 @@ public:
     */
     int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize, std::set<DataPath*>* counted_dataPaths);
 
+    /**
+    Creates a read-only snapshot of the subtree of this component (incl. the component itself), stored as contiguous arrays. Intended for read-mostly workloads that query the same topology many times.
+    \n The snapshot does not reflect later changes of the Component Tree. The caller is responsible for deleting the returned object.
+    @return a new FrozenTopology with this component at index 0
+    @see FrozenTopology
+    */
+    FrozenTopology* Freeze();
+
     /**
     !!Should normally not be used!! Helper function of XML dump generation.
     @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
@@ -311,10 +615,17 @@ public:
     xmlNodePtr CreateXmlSubtree();
 
     /**
-    Deletes all DataPaths of this component.
+    Deletes all DataPaths of this component and removes it from all DataPathMatrices.
     */
     void DeleteAllDataPaths();
     /**
+    Deletes all DataPaths of one dp_type (incoming and outgoing) of this component, e.g. all SYS_SAGE_DATAPATH_TYPE_L3CAT DataPaths before the CAT settings are refreshed.
+    @param dp_type - DataPath type (dp_type) to delete
+    @param withSubtree - if true, the DataPaths of dp_type of the whole subtree are deleted
+    @return number of deleted DataPaths
+    */
+    int DeleteDataPathsByType(int dp_type, bool withSubtree = false);
+    /**
     Deletes the whole subtree (all the children) of the component.
     */
     void DeleteSubtree();
@@ -326,13 +637,15 @@ public:
     void Delete(bool withSubtree = true);
 
     /**
-    TODO this part
+    Attributes of the component. Typed values are set/read with attrib.Set() and attrib.Get<T>(); the std::map<string,void*>-like interface (e.g. attrib["key"] = (void*)ptr) stores untyped pointers owned by the user.
+    @see AttribStore
     */
-    map<string,void*> attrib;
+    AttribStore attrib;
 protected:
+    friend class DataPathMatrix;
 
     int id; /**< Numeric ID of the component. There is no requirement for uniqueness of the ID, however it is advised to have unique IDs at least in the realm of parent's children. Some tree search functions, which take the id as a search parameter search for first match, so the user is responsible to manage uniqueness in the realm of the search subtree (or should be aware of the consequences of not doing so). Component's ID is set by the constructor, and is retrieved via int GetId(); */
-    int depth; /**< TODO not implemented */
+    int depth { 0 }; /**< Distance to the root of the Component Tree (0 for the root). Maintained by SetParent(), retrieved via int GetDepth() */
     string name; /**< Name of the component (as a string). */
     int count{-1}; /**< Can be used to represent multiple Components with the same properties. By default, it represents only 1 component, and is set to -1. */
     /**
@@ -355,10 +668,212 @@ protected:
     Component* parent { nullptr }; /**< Contains pointer to the parent component in the component tree. If this component is the root, parent will be NULL.*/
     vector<DataPath*> dp_incoming; /**< Contains references to data paths that point to this component. @see DataPath */
     vector<DataPath*> dp_outgoing; /**< Contains references to data paths that point from this component. @see DataPath */
+    vector<DataPathBucket> dp_incoming_by_type; /**< dp_incoming grouped by dp_type (one bucket per dp_type that occurred). @see GetDataPathsByType() */
+    vector<DataPathBucket> dp_outgoing_by_type; /**< dp_outgoing grouped by dp_type (one bucket per dp_type that occurred). @see GetDataPathsByType() */
+    vector<DataPathMatrix*> dp_matrices; /**< DataPathMatrices this component is part of. @see DataPathMatrix */
+    unsigned long long dpChangeVersion { 0 }; /**< GetDataPathVersion() after the last change of dp_incoming or dp_outgoing */
+    ComponentIndex* subcomponentIndex { nullptr }; /**< (componentType, id) index of the Component Tree; only set in the root of an indexed tree. @see EnableSubcomponentIndex() */
+    /**
+    Aggregates of the subtree (excluding this Component), kept up to date along the ancestor chain by InsertChild() and RemoveChild(). Changes done directly on the vector returned by GetChildren() are not tracked.
+    */
+    int subtreeTypeCounts[SYS_SAGE_COMPONENT_NUM_TYPES] {}; /**< number of descendants of each SYS_SAGE_COMPONENT_* type; index = bit position of the type */
+    int subtreeSize { 0 }; /**< number of descendants */
+    int subtreeHeight { 0 }; /**< maximal distance to a leaf */
+    ComponentTreeLabels* treeLabels { nullptr }; /**< Euler tour of the Component Tree this component was labelled in; only valid if labelVersion equals the structureVersion of the root */
+    std::atomic<unsigned long long> labelVersion { 0 }; /**< structureVersion of the root when treeLabels, eulerFirst and eulerLast were computed; 0 if never labelled */
+    ComponentTreeLabels* ownTreeLabels { nullptr }; /**< (root only) Euler tour of the Component Tree of this root, built by UpdateTreeLabels() */
+    std::atomic<unsigned long long> structureVersion { 0 }; /**< (root only) GetTreeVersion() after the last change of the structure of the Component Tree of this root; 0 if it has not changed since the root was created */
+    int eulerFirst { 0 }; /**< first position of this component in the Euler tour */
+    int eulerLast { 0 }; /**< last position of this component in the Euler tour */
+    CpuSet cpuset; /**< cached result of GetCpuSet(); only valid if cpusetValid */
+    bool cpusetValid { false }; /**< if a component's cpuset is valid, the cpusets of all its descendants are valid as well */
 
 private:
+    /**
+    Adds the subtree of a (newly inserted) child to the aggregates of this Component and its ancestors.
+    */
+    void AddSubtreeAggregates(Component* child);
+    /**
+    Removes the subtree of a (removed) child from the aggregates of this Component and its ancestors.
+    */
+    void RemoveSubtreeAggregates(Component* child);
+    /**
+    Recomputes the Euler tour labels of the Component Tree if they are not up to date.
+    @return false if this component is not reachable from GetRoot() over the children (and has no labels)
+    */
+    bool UpdateTreeLabels();
+    /**
+    Marks the structure of the Component Tree of this component as changed: increments GetTreeVersion() and stores it as the structureVersion of the root.
+    */
+    void StructureChanged();
+    void LabelSubtree(ComponentTreeLabels* labels, int _depth, bool primary, vector<Component*>* labelled);
+    /**
+    Sets the depth of this component and its subtree (used when the component gets a new parent).
+    */
+    void UpdateSubtreeDepth(int _depth);
+    /**
+    Invalidates the cached cpuset of this component and its ancestors.
+    */
+    void InvalidateCpuSet();
+    /**
+    @returns the DataPaths of dp_type in dp_incoming_by_type or dp_outgoing_by_type, NULL if there is no such bucket
+    */
+    vector<DataPath*>* FindDataPathBucket(int dp_type, int orientation);
+    /**
+    Removes list[slot] (dp_incoming, dp_outgoing or a bucket of this component) by moving the last DataPath of the list to slot, and updates the stored position of the moved DataPath.
+    */
+    void EraseDataPathSlot(vector<DataPath*>* list, int slot, int orientation, bool inBucket);
+    /**
+    DFS search behind GetSubcomponentById(), used when there is no index or the index cannot decide which match comes first.
+    */
+    Component* SearchSubcomponentById(int _id, int _componentType);
 };
 
+#define SYS_SAGE_VIEW_INLINE_DEPTH 32 /**< Number of tree levels for which ComponentSubtreeView iterators remember the path and the child positions; deeper levels use GetParent() and look the position up in the parent (shared subtrees deeper than this are not supported). */
+
+/**
+Range returned by Component::Subtree(), Component::SubtreeOfType() and Component::AtDepth().
+\n Iterates the subtree in DFS pre-order without allocating and without recursion, yielding the components within the depth range [minDepth, maxDepth] (relative to the root of the view) whose componentType matches the mask.
+*/
+class ComponentSubtreeView : public std::ranges::view_interface<ComponentSubtreeView> {
+public:
+    class iterator {
+    public:
+        using value_type = Component*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+        iterator(Component* _root, int _mask, int _minDepth, int _maxDepth): current(_root), mask(_mask), minDepth(_minDepth), maxDepth(_maxDepth)
+        {
+            path[0] = _root;
+            if(current != NULL && !Matches())
+                Advance();
+        }
+
+        Component* operator*() const { return current; }
+        iterator& operator++() { Advance(); return *this; }
+        iterator operator++(int) { iterator tmp = *this; Advance(); return tmp; }
+        //a component of a shared subtree is visited once per reference, so the positions on the path are compared as well (multipass guarantee of forward iterators)
+        bool operator==(const iterator& other) const
+        {
+            if(current != other.current || depth != other.depth)
+                return false;
+            int inlineDepth = std::min(depth, SYS_SAGE_VIEW_INLINE_DEPTH - 1);
+            return std::equal(position + 1, position + 1 + inlineDepth, other.position + 1);
+        }
+        bool operator==(std::default_sentinel_t) const { return current == NULL; }
+
+    private:
+        bool Matches() const { return depth >= minDepth && (current->GetComponentType() & mask); }
+        void Advance()
+        {
+            do { Step(); } while(current != NULL && !Matches());
+        }
+        //moves to the next component in DFS pre-order (not descending below maxDepth)
+        void Step()
+        {
+            vector<Component*>* children = current->GetChildren();
+            if(depth < maxDepth && !children->empty())
+            {
+                current = (*children)[0];
+                depth++;
+                if(depth < SYS_SAGE_VIEW_INLINE_DEPTH)
+                {
+                    position[depth] = 0;
+                    path[depth] = current;
+                }
+                return;
+            }
+            while(depth > 0)
+            {
+                //the parent on the current path (not GetParent() -- a shared subtree has several parents)
+                Component* parent = depth - 1 < SYS_SAGE_VIEW_INLINE_DEPTH ? path[depth - 1] : current->GetParent();
+                vector<Component*>* siblings = parent->GetChildren();
+                size_t pos;
+                if(depth < SYS_SAGE_VIEW_INLINE_DEPTH)
+                    pos = position[depth];
+                else
+                    pos = std::find(siblings->begin(), siblings->end(), current) - siblings->begin();
+                if(pos + 1 < siblings->size())
+                {
+                    current = (*siblings)[pos + 1];
+                    if(depth < SYS_SAGE_VIEW_INLINE_DEPTH)
+                    {
+                        position[depth] = pos + 1;
+                        path[depth] = current;
+                    }
+                    return;
+                }
+                current = parent;
+                depth--;
+            }
+            current = NULL;
+        }
+
+        Component* current { nullptr };
+        int mask { 0 };
+        int minDepth { 0 };
+        int maxDepth { 0 };
+        int depth { 0 }; /**< depth of current relative to the root of the view */
+        unsigned int position[SYS_SAGE_VIEW_INLINE_DEPTH]; /**< position[d] = index of the level-d component on the current path in its parent's children */
+        Component* path[SYS_SAGE_VIEW_INLINE_DEPTH]; /**< path[d] = the level-d component on the current path */
+    };
+
+    ComponentSubtreeView() = default;
+    ComponentSubtreeView(Component* _root, int _mask, int _minDepth, int _maxDepth): root(_root), mask(_mask), minDepth(_minDepth), maxDepth(_maxDepth) {}
+
+    iterator begin() const { return iterator(root, mask, minDepth, maxDepth); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+    Component* root { nullptr };
+    int mask { 0 };
+    int minDepth { 0 };
+    int maxDepth { 0 };
+};
+
+/**
+Range returned by Component::Ancestors(); follows the parent pointers up to the root of the Component Tree.
+*/
+class ComponentAncestorView : public std::ranges::view_interface<ComponentAncestorView> {
+public:
+    class iterator {
+    public:
+        using value_type = Component*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+        iterator(Component* _current): current(_current) {}
+
+        Component* operator*() const { return current; }
+        iterator& operator++() { current = current->GetParent(); return *this; }
+        iterator operator++(int) { iterator tmp = *this; current = current->GetParent(); return tmp; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator==(std::default_sentinel_t) const { return current == NULL; }
+
+    private:
+        Component* current { nullptr };
+    };
+
+    ComponentAncestorView() = default;
+    ComponentAncestorView(Component* _component): component(_component) {}
+
+    iterator begin() const { return iterator(component == NULL ? NULL : component->GetParent()); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+    Component* component { nullptr };
+};
+
+inline ComponentSubtreeView Component::Subtree() { return ComponentSubtreeView(this, ~0, 0, INT_MAX); }
+inline ComponentSubtreeView Component::SubtreeOfType(int componentTypeMask) { return ComponentSubtreeView(this, componentTypeMask, 0, INT_MAX); }
+inline ComponentSubtreeView Component::AtDepth(int n) { return ComponentSubtreeView(this, ~0, n, n); }
+inline ComponentAncestorView Component::Ancestors() { return ComponentAncestorView(this); }
+
 /**
 Class Topology - the root of the topology.
 \n It is not required to have an instance of this class at the root of the topology. Any component can be the root. This class is a child of Component class, therefore inherits its attributes and methods.
@@ -408,14 +923,19 @@ public:
     ~Node() override = default;
 #ifdef CPUINFO
 public:
+    /**
+    !!! Only if compiled with CPUINFO functionality !!!
+    \n Refreshes the frequency of all CPU cores of the node from /proc/cpuinfo.
+    @param keep_history - if true, the frequency is also appended to attrib "freq_history" of each core (AttribTimeSeries of <timestamp,frequency in MHz>, keeps the last SYS_SAGE_TIME_SERIES_DEFAULT_CAPACITY samples)
+    */
     int RefreshCpuCoreFrequency(bool keep_history = false);
 #endif
 #ifdef CAT_AWARE //defined in CAT_aware.cpp
 public:
     /**
     !!! Only if compiled with CAT_AWARE functionality, only for Intel CPUs !!!
-    \n Creates/updates (bidirectional) data paths between all cores (class Thread) and their L3 cache segment (class Cache). The data paths of type SYS_SAGE_DATAPATH_TYPE_L3CAT contain the COS id (attrib with key "CATcos", value is of type uint64_t*) and the open L3 cache ways (attrib with key "CATL3mask", value is of type uint64_t*) to contain the current settings.
-    \n Each time the method is called, new DataPath objects get created, so the last one is always the most up-to-date.
+    \n Creates/updates (bidirectional) data paths between all cores (class Thread) and their L3 cache segment (class Cache). The data paths of type SYS_SAGE_DATAPATH_TYPE_L3CAT contain the COS id (attrib with key "CATcos", value is of type uint64_t*) and the open L3 cache ways (attrib with key "CATL3mask", value is of type uint64_t*) to contain the current settings. The masks of all calls are kept in attrib "CATL3mask_history" (AttribTimeSeries of <timestamp,mask>).
+    \n Each call updates the DataPaths of the previous call in place (see UpsertDataPath()).
     */
     int UpdateL3CATCoreCOS();
 #endif
@@ -582,6 +1102,11 @@ private:
     int type; /**< TODO  */
 #ifdef NVIDIA_MIG
 public:
+    /**
+    !!! Only if compiled with NVIDIA_MIG functionality !!!
+    \n Creates/updates DataPaths of type SYS_SAGE_DATAPATH_TYPE_MIG (attrib "mig_uuid") from this Chip to its Memory, L2 caches and SMs available to the MIG instance. The Memory and L2 DataPaths contain the available size (attrib "mig_size") and its values of all calls (attrib "mig_size_history", AttribTimeSeries of <timestamp,size>).
+    @param uuid - UUID of the MIG instance; if empty, CUDA_VISIBLE_DEVICES is used
+    */
     int UpdateMIGSettings(string uuid = "");
     int GetMIGNumSMs(string uuid = "");
     int GetMIGNumCores(string uuid = "");
@@ -642,6 +1167,10 @@ public:
     */
     string GetCacheName();
     /**
+    Sets the cache level or type (e.g. "2" or "L2").
+    */
+    void SetCacheName(string _name);
+    /**
     @returns cache size of this cache
     */
     long long GetCacheSize();
@@ -654,6 +1183,10 @@ public:
     */
     int GetCacheAssociativityWays();
     /**
+    Sets the number of the cache associativity ways of this cache.
+    */
+    void SetCacheAssociativityWays(int _associativity);
+    /**
     @returns the size of a cache line of this cache
     */
     int GetCacheLineSize();
@@ -719,7 +1252,7 @@ public:
     */
     xmlNodePtr CreateXmlSubtree();
 protected:
-    int type; /**< Type of the subdivision. Each user can have his own numbering, i.e. the type is there to identify different types of subdivisions as the user defines it.*/
+    int type { SYS_SAGE_SUBDIVISION_TYPE_NONE }; /**< Type of the subdivision (SYS_SAGE_SUBDIVISION_TYPE_NONE unless set). Each user can have his own numbering, i.e. the type is there to identify different types of subdivisions as the user defines it.*/
 };
 
 /**
@@ -756,6 +1289,10 @@ public:
     @returns size of the Numa memory segment.
     */
     long long GetSize();
+    /**
+    Set size of the Numa memory segment.
+    */
+    void SetSize(long long _size);
 
     /**
     !!Should normally not be used!! Helper function of XML dump generation.
@@ -852,4 +1389,32 @@ public:
 private:
 };
 
+/**
+@private
+Maps the component classes to their SYS_SAGE_COMPONENT_* type (used by Component::GetAllSubcomponents<T>()).
+*/
+template<class T> struct ComponentTraits;
+template<> struct ComponentTraits<Component> { static constexpr int type = SYS_SAGE_COMPONENT_NONE; };
+template<> struct ComponentTraits<Thread> { static constexpr int type = SYS_SAGE_COMPONENT_THREAD; };
+template<> struct ComponentTraits<Core> { static constexpr int type = SYS_SAGE_COMPONENT_CORE; };
+template<> struct ComponentTraits<Cache> { static constexpr int type = SYS_SAGE_COMPONENT_CACHE; };
+template<> struct ComponentTraits<Subdivision> { static constexpr int type = SYS_SAGE_COMPONENT_SUBDIVISION; };
+template<> struct ComponentTraits<Numa> { static constexpr int type = SYS_SAGE_COMPONENT_NUMA; };
+template<> struct ComponentTraits<Chip> { static constexpr int type = SYS_SAGE_COMPONENT_CHIP; };
+template<> struct ComponentTraits<Memory> { static constexpr int type = SYS_SAGE_COMPONENT_MEMORY; };
+template<> struct ComponentTraits<Storage> { static constexpr int type = SYS_SAGE_COMPONENT_STORAGE; };
+template<> struct ComponentTraits<Node> { static constexpr int type = SYS_SAGE_COMPONENT_NODE; };
+template<> struct ComponentTraits<Topology> { static constexpr int type = SYS_SAGE_COMPONENT_TOPOLOGY; };
+
+template<class T> vector<T*> Component::GetAllSubcomponents()
+{
+    vector<T*> ret;
+    for(Component* c : SubtreeOfType(ComponentTraits<T>::type))
+    {
+        if(c != this && c->GetComponentType() == ComponentTraits<T>::type)
+            ret.push_back(static_cast<T*>(c));
+    }
+    return ret;
+}
+
 #endif
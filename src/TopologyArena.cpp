@@ -0,0 +1,116 @@
+#include "TopologyArena.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+//every Component/DataPath (in an arena or on the heap) is preceded by this header, so that operator delete knows where the object lives
+struct ArenaBlockHeader {
+    TopologyArena* arena; /**< owning arena, NULL for heap objects */
+    unsigned int size; /**< size of the block (without the header), multiple of 16 */
+    unsigned short kind; /**< SYS_SAGE_ARENA_OBJECT_* */
+    unsigned short live; /**< 0 once the object has been deleted */
+};
+static_assert(sizeof(ArenaBlockHeader) == 16, "ArenaBlockHeader must keep the objects 16-byte aligned");
+
+static thread_local TopologyArena* currentArena = NULL;
+
+static size_t AlignBlock(size_t size) { return (size + 15) & ~(size_t)15; }
+
+TopologyArena::TopologyArena(size_t _chunkSize): chunkSize(_chunkSize), numObjects(0), reservedBytes(0) {}
+
+TopologyArena::~TopologyArena()
+{
+    //run the destructors of the objects that were not deleted; no tree or DataPath bookkeeping is done
+    for(auto [chunk, used] : chunks)
+    {
+        size_t offset = 0;
+        while(offset < used)
+        {
+            ArenaBlockHeader* h = (ArenaBlockHeader*)(chunk + offset);
+            void* obj = (void*)(h + 1);
+            if(h->live)
+            {
+                if(h->kind == SYS_SAGE_ARENA_OBJECT_COMPONENT)
+                    ((Component*)obj)->~Component();
+                else if(h->kind == SYS_SAGE_ARENA_OBJECT_DATAPATH)
+                    ((DataPath*)obj)->~DataPath();
+            }
+            offset += sizeof(ArenaBlockHeader) + h->size;
+        }
+    }
+    for(auto [chunk, used] : chunks)
+        std::free(chunk);
+    if(currentArena == this)
+        currentArena = NULL;
+}
+
+TopologyArena::Scope::Scope(TopologyArena* arena): previous(currentArena)
+{
+    if(arena != NULL)
+        currentArena = arena;
+}
+TopologyArena::Scope::~Scope(){ currentArena = previous; }
+
+TopologyArena* TopologyArena::GetCurrent(){ return currentArena; }
+size_t TopologyArena::GetNumObjects(){ return numObjects; }
+size_t TopologyArena::GetReservedBytes(){ return reservedBytes; }
+
+void* TopologyArena::Allocate(size_t size, int kind)
+{
+    size_t blockSize = sizeof(ArenaBlockHeader) + AlignBlock(size);
+    if(chunks.empty() || chunks.back().second + blockSize > chunkSize)
+    {
+        size_t newChunkSize = blockSize > chunkSize ? blockSize : chunkSize;
+        char* chunk = (char*)std::malloc(newChunkSize);
+        if(chunk == NULL)
+            throw std::bad_alloc();
+        chunks.push_back({chunk, 0});
+        reservedBytes += newChunkSize;
+    }
+    auto& [chunk, used] = chunks.back();
+    ArenaBlockHeader* h = (ArenaBlockHeader*)(chunk + used);
+    used += blockSize;
+    h->arena = this;
+    h->size = AlignBlock(size);
+    h->kind = kind;
+    h->live = 1;
+    numObjects++;
+    return (void*)(h + 1);
+}
+
+void* TopologyArena::AllocateObject(size_t size, int kind)
+{
+    if(currentArena != NULL)
+        return currentArena->Allocate(size, kind);
+
+    ArenaBlockHeader* h = (ArenaBlockHeader*)std::malloc(sizeof(ArenaBlockHeader) + size);
+    if(h == NULL)
+        throw std::bad_alloc();
+    h->arena = NULL;
+    h->size = AlignBlock(size);
+    h->kind = kind;
+    h->live = 1;
+    return (void*)(h + 1);
+}
+
+void TopologyArena::DeallocateObject(void* ptr)
+{
+    if(ptr == NULL)
+        return;
+    ArenaBlockHeader* h = (ArenaBlockHeader*)ptr - 1;
+    if(h->arena == NULL)
+    {
+        std::free(h);
+        return;
+    }
+    h->live = 0;
+    h->arena->numObjects--;
+}
+
+void* Component::operator new(size_t size){ return TopologyArena::AllocateObject(size, SYS_SAGE_ARENA_OBJECT_COMPONENT); }
+void Component::operator delete(void* ptr){ TopologyArena::DeallocateObject(ptr); }
+void* DataPath::operator new(size_t size){ return TopologyArena::AllocateObject(size, SYS_SAGE_ARENA_OBJECT_DATAPATH); }
+void DataPath::operator delete(void* ptr){ TopologyArena::DeallocateObject(ptr); }
@@ -0,0 +1,79 @@
+#ifndef TOPOLOGY_ARENA
+#define TOPOLOGY_ARENA
+
+#include <cstddef>
+#include <vector>
+
+#define SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE (1 << 20) /**< Default size of one TopologyArena chunk (1 MiB). */
+
+#define SYS_SAGE_ARENA_OBJECT_COMPONENT 1 /**< Arena block holds a Component (or any class inheriting from it). */
+#define SYS_SAGE_ARENA_OBJECT_DATAPATH 2 /**< Arena block holds a DataPath. */
+
+/**
+Class TopologyArena - a chunked bump allocator for Components and DataPaths.
+\n Components and DataPaths are allocated into an arena whenever they are created with new while a TopologyArena::Scope is active (in the same thread). The parsers accept an optional arena parameter which opens such a scope for the duration of the parsing.
+\n Deleting a Component or DataPath that lives in an arena (e.g. via Component::Delete() or DataPath::DeleteDataPath()) only runs its destructor; the memory is released together with the arena.
+\n Destroying the arena destroys all objects still living in it and releases the whole memory at once, i.e. without detaching the components from the Component Tree one by one. Therefore, the arena should contain a whole topology (or a whole subtree together with its DataPaths) -- components outside of the arena must not keep pointers to the arena objects once the arena is destroyed.
+\n Attribute values (attrib) are not allocated by the arena.
+*/
+class TopologyArena {
+public:
+    /**
+    TopologyArena constructor. No memory is allocated until the first object is placed into the arena.
+    @param _chunkSize - size of one memory chunk in bytes. Objects larger than a chunk get a dedicated chunk.
+    */
+    TopologyArena(size_t _chunkSize = SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE);
+    TopologyArena(const TopologyArena&) = delete;
+    TopologyArena& operator=(const TopologyArena&) = delete;
+    /**
+    Destroys all objects still living in the arena and releases all chunks.
+    */
+    ~TopologyArena();
+
+    /**
+    RAII helper -- while a Scope exists, Components and DataPaths created with new in this thread are placed in the given arena. Scopes can be nested; the previous arena is restored when the scope ends.
+    \n A Scope with a NULL arena keeps the currently active arena (if any).
+    */
+    class Scope {
+    public:
+        Scope(TopologyArena* arena);
+        ~Scope();
+    private:
+        TopologyArena* previous;
+    };
+
+    /**
+    @returns the arena used for new Components and DataPaths in this thread, or NULL if objects are allocated on the heap.
+    */
+    static TopologyArena* GetCurrent();
+
+    /**
+    @returns the number of objects placed in the arena that were not deleted yet.
+    */
+    size_t GetNumObjects();
+    /**
+    @returns the number of bytes reserved by the arena chunks.
+    */
+    size_t GetReservedBytes();
+
+    /**
+    !!Should normally not be used!! Used by operator new of Component and DataPath.
+    \n Allocates size bytes for an object of the given kind (SYS_SAGE_ARENA_OBJECT_*) in the current arena, or on the heap if there is no current arena.
+    */
+    static void* AllocateObject(size_t size, int kind);
+    /**
+    !!Should normally not be used!! Used by operator delete of Component and DataPath.
+    \n Releases heap objects immediately; objects living in an arena are only marked as deleted.
+    */
+    static void DeallocateObject(void* ptr);
+
+private:
+    void* Allocate(size_t size, int kind);
+
+    size_t chunkSize; /**< default chunk size */
+    std::vector<std::pair<char*, size_t> > chunks; /**< chunk memory and the number of used bytes in it */
+    size_t numObjects; /**< number of live objects */
+    size_t reservedBytes; /**< total size of the chunks */
+};
+
+#endif
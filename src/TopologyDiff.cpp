@@ -0,0 +1,556 @@
+#include "TopologyDiff.hpp"
+#include "AttribRegistry.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+
+using ComponentKey = TopologyPatch::ComponentKey;
+using Operation = TopologyPatch::Operation;
+
+TopologyPatch::~TopologyPatch()
+{
+    for(Operation& op : operations)
+    {
+        if(op.subtree != NULL)
+            op.subtree->Delete(true);
+    }
+}
+
+const vector<Operation>& TopologyPatch::GetOperations(){ return operations; }
+bool TopologyPatch::IsEmpty(){ return operations.empty(); }
+
+static string PathToString(const vector<ComponentKey>& path)
+{
+    string ret;
+    for(const ComponentKey& k : path)
+    {
+        ret += "/" + to_string(k.componentType) + ":" + to_string(k.id);
+        if(k.ordinal > 0)
+            ret += "#" + to_string(k.ordinal);
+    }
+    return ret.empty() ? "/" : ret;
+}
+
+void TopologyPatch::Print()
+{
+    for(Operation& op : operations)
+    {
+        switch(op.type)
+        {
+            case SYS_SAGE_PATCH_REMOVE_DATAPATH:
+                cout << "remove DataPath " << PathToString(op.path) << " -> " << PathToString(op.targetPath) << " (type " << op.dpType << ")" << endl;
+                break;
+            case SYS_SAGE_PATCH_REMOVE_COMPONENT:
+                cout << "remove " << PathToString(op.path) << endl;
+                break;
+            case SYS_SAGE_PATCH_SET_FIELD:
+                cout << "set " << PathToString(op.path) << " field " << op.field << " = " << (op.strValue.empty() ? to_string(op.intValue) : op.strValue) << endl;
+                break;
+            case SYS_SAGE_PATCH_SET_ATTRIB:
+                cout << "set " << PathToString(op.path) << " attrib " << op.attribKey << endl;
+                break;
+            case SYS_SAGE_PATCH_REMOVE_ATTRIB:
+                cout << "remove " << PathToString(op.path) << " attrib " << op.attribKey << endl;
+                break;
+            case SYS_SAGE_PATCH_ADD_COMPONENT:
+                cout << "add " << op.subtree->GetComponentTypeStr() << " " << op.subtree->GetId() << " to " << PathToString(op.path) << " at " << op.position << endl;
+                break;
+            case SYS_SAGE_PATCH_ADD_DATAPATH:
+                cout << "add DataPath " << PathToString(op.path) << " -> " << PathToString(op.targetPath) << " (type " << op.dpType << ")" << endl;
+                break;
+        }
+    }
+}
+
+//key of each child (ordinal = index among the preceding siblings with the same componentType and id)
+static vector<ComponentKey> ChildKeys(Component* c)
+{
+    vector<ComponentKey> keys;
+    map<pair<int,int>, int> seen;
+    for(Component* child : *(c->GetChildren()))
+        keys.push_back({child->GetComponentType(), child->GetId(), seen[{child->GetComponentType(), child->GetId()}]++});
+    return keys;
+}
+
+static Component* Resolve(Component* root, const vector<ComponentKey>& path)
+{
+    Component* c = root;
+    for(const ComponentKey& k : path)
+    {
+        int ordinal = 0;
+        Component* next = NULL;
+        for(Component* child : *(c->GetChildren()))
+        {
+            if(child->GetComponentType() == k.componentType && child->GetId() == k.id && ordinal++ == k.ordinal)
+            {
+                next = child;
+                break;
+            }
+        }
+        if(next == NULL)
+            return NULL;
+        c = next;
+    }
+    return c;
+}
+
+////////////////////////////////////////////////////////////////////////
+//Diff
+
+static void DiffField(vector<Operation>* ops, const vector<ComponentKey>& path, int field, long long oldValue, long long newValue)
+{
+    if(oldValue == newValue)
+        return;
+    Operation op;
+    op.type = SYS_SAGE_PATCH_SET_FIELD;
+    op.path = path;
+    op.field = field;
+    op.intValue = newValue;
+    ops->push_back(std::move(op));
+}
+static void DiffField(vector<Operation>* ops, const vector<ComponentKey>& path, int field, const string& oldValue, const string& newValue)
+{
+    if(oldValue == newValue)
+        return;
+    Operation op;
+    op.type = SYS_SAGE_PATCH_SET_FIELD;
+    op.path = path;
+    op.field = field;
+    op.strValue = newValue;
+    ops->push_back(std::move(op));
+}
+
+static void DiffFields(vector<Operation>* ops, const vector<ComponentKey>& path, Component* o, Component* n)
+{
+    DiffField(ops, path, SYS_SAGE_PATCH_FIELD_NAME, o->GetName(), n->GetName());
+    switch(o->GetComponentType())
+    {
+        case SYS_SAGE_COMPONENT_CACHE:
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CACHE_NAME, ((Cache*)o)->GetCacheName(), ((Cache*)n)->GetCacheName());
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CACHE_SIZE, ((Cache*)o)->GetCacheSize(), ((Cache*)n)->GetCacheSize());
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CACHE_ASSOCIATIVITY, ((Cache*)o)->GetCacheAssociativityWays(), ((Cache*)n)->GetCacheAssociativityWays());
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CACHE_LINE_SIZE, ((Cache*)o)->GetCacheLineSize(), ((Cache*)n)->GetCacheLineSize());
+            break;
+        case SYS_SAGE_COMPONENT_CHIP:
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CHIP_VENDOR, ((Chip*)o)->GetVendor(), ((Chip*)n)->GetVendor());
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CHIP_MODEL, ((Chip*)o)->GetModel(), ((Chip*)n)->GetModel());
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_CHIP_TYPE, ((Chip*)o)->GetChipType(), ((Chip*)n)->GetChipType());
+            break;
+        case SYS_SAGE_COMPONENT_SUBDIVISION:
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_SUBDIVISION_TYPE, ((Subdivision*)o)->GetSubdivisionType(), ((Subdivision*)n)->GetSubdivisionType());
+            break;
+        case SYS_SAGE_COMPONENT_NUMA:
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_SUBDIVISION_TYPE, ((Numa*)o)->GetSubdivisionType(), ((Numa*)n)->GetSubdivisionType());
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_SIZE, ((Numa*)o)->GetSize(), ((Numa*)n)->GetSize());
+            break;
+        case SYS_SAGE_COMPONENT_MEMORY:
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_SIZE, ((Memory*)o)->GetSize(), ((Memory*)n)->GetSize());
+            break;
+        case SYS_SAGE_COMPONENT_STORAGE:
+            DiffField(ops, path, SYS_SAGE_PATCH_FIELD_SIZE, ((Storage*)o)->GetSize(), ((Storage*)n)->GetSize());
+            break;
+    }
+}
+
+static bool SameAttrib(const AttribStore::Entry& a, const AttribStore::Entry& b)
+{
+    if(a.GetType() != b.GetType())
+        return false;
+    const AttribTypeDescriptor* d = AttribRegistry::GetDescriptor(a);
+    if(d == NULL || d->toString == NULL)
+        return a.GetData() == b.GetData();
+    return d->toString(a.GetData()) == d->toString(b.GetData());
+}
+static bool SameAttribs(AttribStore& a, AttribStore& b)
+{
+    if(a.size() != b.size())
+        return false;
+    const vector<AttribStore::Entry>& ea = a.GetEntries();
+    const vector<AttribStore::Entry>& eb = b.GetEntries();
+    for(size_t i = 0; i < ea.size(); i++)
+    {
+        if(ea[i].key != eb[i].key || !SameAttrib(ea[i], eb[i]))
+            return false;
+    }
+    return true;
+}
+
+static void DiffAttribs(vector<Operation>* ops, const vector<ComponentKey>& path, AttribStore& o, AttribStore& n)
+{
+    //the entries are sorted by key name
+    const vector<AttribStore::Entry>& eo = o.GetEntries();
+    const vector<AttribStore::Entry>& en = n.GetEntries();
+    size_t i = 0, j = 0;
+    while(i < eo.size() || j < en.size())
+    {
+        int cmp = i == eo.size() ? 1 : j == en.size() ? -1 : eo[i].name->compare(*en[j].name);
+        if(cmp < 0)
+        {
+            Operation op;
+            op.type = SYS_SAGE_PATCH_REMOVE_ATTRIB;
+            op.path = path;
+            op.attribKey = *eo[i].name;
+            ops->push_back(std::move(op));
+            i++;
+            continue;
+        }
+        if(cmp > 0 || !SameAttrib(eo[i], en[j]))
+        {
+            const AttribStore::Entry& e = en[j];
+            Operation op;
+            op.type = SYS_SAGE_PATCH_SET_ATTRIB;
+            op.path = path;
+            op.attribKey = *e.name;
+            op.attribType = e.GetType();
+            const AttribTypeDescriptor* d = AttribRegistry::GetDescriptor(e);
+            if(d != NULL && d->size != NULL && d->serialize != NULL && d->deserialize != NULL)
+            {
+                op.attribData.resize(d->size(e.GetData()));
+                d->serialize(e.GetData(), op.attribData.data());
+            }
+            else
+            {
+                void* ptr = e.GetData();
+                op.attribData.resize(sizeof(void*));
+                memcpy(op.attribData.data(), &ptr, sizeof(void*));
+            }
+            ops->push_back(std::move(op));
+        }
+        if(cmp == 0)
+            i++;
+        j++;
+    }
+}
+
+struct DiffState {
+    vector<Operation> removals; /**< DataPath and component removals */
+    vector<Operation> changes; /**< field and attribute changes */
+    vector<Operation> additions; /**< component additions */
+    unordered_map<Component*, vector<ComponentKey> > oldPaths;
+    unordered_map<Component*, vector<ComponentKey> > newPaths;
+    unordered_set<Component*> removed; /**< components of removed subtrees (old tree) */
+    unordered_map<Component*, Component*> addedRoot; /**< component of an added subtree (new tree) -> root of the added subtree */
+    bool failed { false };
+};
+
+static void CollectPaths(Component* c, const vector<ComponentKey>& path, unordered_map<Component*, vector<ComponentKey> >* paths)
+{
+    (*paths)[c] = path;
+    vector<ComponentKey> keys = ChildKeys(c);
+    vector<Component*>* children = c->GetChildren();
+    for(size_t i = 0; i < children->size(); i++)
+    {
+        vector<ComponentKey> childPath = path;
+        childPath.push_back(keys[i]);
+        CollectPaths((*children)[i], childPath, paths);
+    }
+}
+
+static void DiffSubtree(DiffState* s, Component* o, Component* n, const vector<ComponentKey>& path)
+{
+    DiffFields(&s->changes, path, o, n);
+    DiffAttribs(&s->changes, path, o->attrib, n->attrib);
+
+    vector<ComponentKey> oldKeys = ChildKeys(o);
+    vector<ComponentKey> newKeys = ChildKeys(n);
+    vector<Component*>* oldChildren = o->GetChildren();
+    vector<Component*>* newChildren = n->GetChildren();
+    map<tuple<int,int,int>, Component*> oldByKey;
+    for(size_t i = 0; i < oldChildren->size(); i++)
+        oldByKey[{oldKeys[i].componentType, oldKeys[i].id, oldKeys[i].ordinal}] = (*oldChildren)[i];
+
+    for(size_t i = 0; i < newChildren->size(); i++)
+    {
+        Component* newChild = (*newChildren)[i];
+        vector<ComponentKey> childPath = path;
+        childPath.push_back(newKeys[i]);
+        auto it = oldByKey.find({newKeys[i].componentType, newKeys[i].id, newKeys[i].ordinal});
+        if(it != oldByKey.end())
+        {
+            DiffSubtree(s, it->second, newChild, childPath);
+            oldByKey.erase(it);
+            continue;
+        }
+        Operation op;
+        op.type = SYS_SAGE_PATCH_ADD_COMPONENT;
+        op.path = path;
+        op.position = i;
+        op.subtree = newChild->CloneSubtree();
+        if(op.subtree == NULL)
+            s->failed = true;
+        s->additions.push_back(std::move(op));
+        vector<Component*> subtree;
+        newChild->GetSubtreeNodeList(&subtree);
+        for(Component* c : subtree)
+            s->addedRoot[c] = newChild;
+    }
+    //old children without a match, in the order of the old children
+    for(size_t i = 0; i < oldChildren->size(); i++)
+    {
+        if(!oldByKey.count({oldKeys[i].componentType, oldKeys[i].id, oldKeys[i].ordinal}))
+            continue;
+        Operation op;
+        op.type = SYS_SAGE_PATCH_REMOVE_COMPONENT;
+        op.path = path;
+        op.path.push_back(oldKeys[i]);
+        s->removals.push_back(std::move(op));
+        vector<Component*> subtree;
+        (*oldChildren)[i]->GetSubtreeNodeList(&subtree);
+        s->removed.insert(subtree.begin(), subtree.end());
+    }
+}
+
+//identity of a DataPath (endpoint paths, oriented, dp_type) -> the DataPaths with this identity, in the order of the outgoing DataPaths of the source
+using DataPathGroups = map<tuple<string, string, int, int>, vector<DataPath*> >;
+static DataPathGroups GroupDataPaths(Component* root, unordered_map<Component*, vector<ComponentKey> >& paths)
+{
+    DataPathGroups groups;
+    vector<Component*> components;
+    root->GetSubtreeNodeList(&components);
+    for(Component* c : components)
+    {
+        for(DataPath* dp : *(c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)))
+        {
+            if(dp->GetSource() != c || !paths.count(dp->GetTarget()))
+                continue;
+            vector<DataPath*>& group = groups[{PathToString(paths[c]), PathToString(paths[dp->GetTarget()]), dp->GetOriented(), dp->GetDpType()}];
+            if(std::find(group.begin(), group.end(), dp) == group.end())
+                group.push_back(dp);
+        }
+    }
+    return groups;
+}
+
+static Operation DataPathOperation(int type, DataPath* dp, unordered_map<Component*, vector<ComponentKey> >& paths)
+{
+    Operation op;
+    op.type = type;
+    op.path = paths[dp->GetSource()];
+    op.targetPath = paths[dp->GetTarget()];
+    op.oriented = dp->GetOriented();
+    op.dpType = dp->GetDpType();
+    op.bw = dp->GetBw();
+    op.latency = dp->GetLatency();
+    return op;
+}
+
+TopologyPatch* Diff(Component* oldRoot, Component* newRoot)
+{
+    if(oldRoot == NULL || newRoot == NULL || oldRoot->GetComponentType() != newRoot->GetComponentType())
+        return NULL;
+
+    DiffState s;
+    DiffSubtree(&s, oldRoot, newRoot, {});
+    if(s.failed)
+    {
+        for(Operation& op : s.additions)
+        {
+            if(op.subtree != NULL)
+                op.subtree->Delete(true);
+        }
+        return NULL;
+    }
+    CollectPaths(oldRoot, {}, &s.oldPaths);
+    CollectPaths(newRoot, {}, &s.newPaths);
+
+    DataPathGroups oldGroups = GroupDataPaths(oldRoot, s.oldPaths);
+    DataPathGroups newGroups = GroupDataPaths(newRoot, s.newPaths);
+    vector<Operation> dpRemovals;
+    vector<Operation> dpAdditions;
+    for(auto& [identity, oldDps] : oldGroups)
+    {
+        auto it = newGroups.find(identity);
+        size_t matched = it == newGroups.end() ? 0 : std::min(oldDps.size(), it->second.size());
+        for(size_t i = 0; i < oldDps.size(); i++)
+        {
+            DataPath* o = oldDps[i];
+            if(i < matched)
+            {
+                DataPath* n = it->second[i];
+                if(o->GetBw() == n->GetBw() && o->GetLatency() == n->GetLatency() && SameAttribs(o->attrib, n->attrib))
+                    continue;
+            }
+            //DataPaths of removed components are deleted together with them
+            if(s.removed.count(o->GetSource()) || s.removed.count(o->GetTarget()))
+                continue;
+            Operation op = DataPathOperation(SYS_SAGE_PATCH_REMOVE_DATAPATH, o, s.oldPaths);
+            op.ordinal = i;
+            dpRemovals.push_back(std::move(op));
+        }
+    }
+    for(auto& [identity, newDps] : newGroups)
+    {
+        auto it = oldGroups.find(identity);
+        size_t matched = it == oldGroups.end() ? 0 : std::min(newDps.size(), it->second.size());
+        for(size_t i = 0; i < newDps.size(); i++)
+        {
+            DataPath* n = newDps[i];
+            if(i < matched)
+            {
+                DataPath* o = it->second[i];
+                if(o->GetBw() == n->GetBw() && o->GetLatency() == n->GetLatency() && SameAttribs(o->attrib, n->attrib))
+                    continue;
+            }
+            //DataPaths within an added subtree are part of its copy
+            auto src = s.addedRoot.find(n->GetSource());
+            auto tgt = s.addedRoot.find(n->GetTarget());
+            if(src != s.addedRoot.end() && tgt != s.addedRoot.end() && src->second == tgt->second)
+                continue;
+            Operation op = DataPathOperation(SYS_SAGE_PATCH_ADD_DATAPATH, n, s.newPaths);
+            AttribRegistry::CloneAttribs(n->attrib, &op.dpAttrib);
+            dpAdditions.push_back(std::move(op));
+        }
+    }
+
+    TopologyPatch* patch = new TopologyPatch();
+    vector<Operation>& ops = patch->operations;
+    for(vector<Operation>* group : {&dpRemovals, &s.removals, &s.changes, &s.additions, &dpAdditions})
+    {
+        for(Operation& op : *group)
+            ops.push_back(std::move(op));
+    }
+    return patch;
+}
+
+////////////////////////////////////////////////////////////////////////
+//ApplyPatch
+
+static DataPath* ResolveDataPath(Component* root, const Operation& op)
+{
+    Component* source = Resolve(root, op.path);
+    Component* target = Resolve(root, op.targetPath);
+    if(source == NULL || target == NULL)
+        return NULL;
+    int ordinal = 0;
+    vector<DataPath*> seen;
+    for(DataPath* dp : *(source->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)))
+    {
+        if(dp->GetSource() != source || dp->GetTarget() != target || dp->GetOriented() != op.oriented || dp->GetDpType() != op.dpType)
+            continue;
+        if(std::find(seen.begin(), seen.end(), dp) != seen.end())
+            continue;
+        seen.push_back(dp);
+        if(ordinal++ == op.ordinal)
+            return dp;
+    }
+    return NULL;
+}
+
+static void SetField(Component* c, const Operation& op)
+{
+    switch(op.field)
+    {
+        case SYS_SAGE_PATCH_FIELD_NAME: c->SetName(op.strValue); break;
+        case SYS_SAGE_PATCH_FIELD_CACHE_NAME: ((Cache*)c)->SetCacheName(op.strValue); break;
+        case SYS_SAGE_PATCH_FIELD_CACHE_SIZE: ((Cache*)c)->SetCacheSize(op.intValue); break;
+        case SYS_SAGE_PATCH_FIELD_CACHE_ASSOCIATIVITY: ((Cache*)c)->SetCacheAssociativityWays(op.intValue); break;
+        case SYS_SAGE_PATCH_FIELD_CACHE_LINE_SIZE: ((Cache*)c)->SetCacheLineSize(op.intValue); break;
+        case SYS_SAGE_PATCH_FIELD_CHIP_VENDOR: ((Chip*)c)->SetVendor(op.strValue); break;
+        case SYS_SAGE_PATCH_FIELD_CHIP_MODEL: ((Chip*)c)->SetModel(op.strValue); break;
+        case SYS_SAGE_PATCH_FIELD_CHIP_TYPE: ((Chip*)c)->SetChipType(op.intValue); break;
+        case SYS_SAGE_PATCH_FIELD_SUBDIVISION_TYPE: ((Subdivision*)c)->SetSubdivisionType(op.intValue); break;
+        case SYS_SAGE_PATCH_FIELD_SIZE:
+            if(c->GetComponentType() == SYS_SAGE_COMPONENT_NUMA)
+                ((Numa*)c)->SetSize(op.intValue);
+            else if(c->GetComponentType() == SYS_SAGE_COMPONENT_MEMORY)
+                ((Memory*)c)->SetSize(op.intValue);
+            else if(c->GetComponentType() == SYS_SAGE_COMPONENT_STORAGE)
+                ((Storage*)c)->SetSize(op.intValue);
+            break;
+    }
+}
+
+static void SetAttrib(Component* c, const Operation& op)
+{
+    AttribKey key(op.attribKey);
+    const AttribTypeDescriptor* d = op.attribType == SYS_SAGE_ATTRIB_TYPE_VOIDPTR ? AttribRegistry::GetKeyDescriptor(key.GetId()) : AttribRegistry::GetTypeDescriptor(op.attribType);
+    c->attrib.Remove(key);
+    if(d != NULL && d->deserialize != NULL)
+    {
+        d->deserialize(&c->attrib, key, op.attribData.data(), op.attribData.size());
+    }
+    else if(op.attribType == SYS_SAGE_ATTRIB_TYPE_VOIDPTR && op.attribData.size() == sizeof(void*))
+    {
+        void* ptr;
+        memcpy(&ptr, op.attribData.data(), sizeof(void*));
+        c->attrib[op.attribKey] = ptr;
+    }
+}
+
+int ApplyPatch(Component* root, TopologyPatch* patch)
+{
+    const vector<Operation>& ops = patch->GetOperations();
+    int failed = 0;
+
+    //resolve all old-tree paths before the tree is modified
+    vector<DataPath*> dataPaths(ops.size(), NULL);
+    vector<Component*> components(ops.size(), NULL);
+    for(size_t i = 0; i < ops.size(); i++)
+    {
+        if(ops[i].type == SYS_SAGE_PATCH_REMOVE_DATAPATH)
+            dataPaths[i] = ResolveDataPath(root, ops[i]);
+        else if(ops[i].type != SYS_SAGE_PATCH_ADD_DATAPATH)
+            components[i] = Resolve(root, ops[i].path);
+    }
+
+    for(size_t i = 0; i < ops.size(); i++)
+    {
+        const Operation& op = ops[i];
+        if(op.type == SYS_SAGE_PATCH_ADD_DATAPATH)
+        {
+            Component* source = Resolve(root, op.path);
+            Component* target = Resolve(root, op.targetPath);
+            if(source == NULL || target == NULL)
+            {
+                failed++;
+                continue;
+            }
+            DataPath* dp = new DataPath(source, target, op.oriented, op.dpType, op.bw, op.latency);
+            AttribRegistry::CloneAttribs(op.dpAttrib, &dp->attrib);
+            continue;
+        }
+        if(op.type == SYS_SAGE_PATCH_REMOVE_DATAPATH)
+        {
+            if(dataPaths[i] == NULL)
+                failed++;
+            else
+                dataPaths[i]->DeleteDataPath();
+            continue;
+        }
+
+        Component* c = components[i];
+        if(c == NULL)
+        {
+            failed++;
+            continue;
+        }
+        switch(op.type)
+        {
+            case SYS_SAGE_PATCH_REMOVE_COMPONENT:
+                c->Delete(true);
+                break;
+            case SYS_SAGE_PATCH_SET_FIELD:
+                SetField(c, op);
+                break;
+            case SYS_SAGE_PATCH_SET_ATTRIB:
+                SetAttrib(c, op);
+                break;
+            case SYS_SAGE_PATCH_REMOVE_ATTRIB:
+                c->attrib.Remove(op.attribKey);
+                break;
+            case SYS_SAGE_PATCH_ADD_COMPONENT:
+            {
+                Component* added = op.subtree->CloneSubtree();
+                c->InsertChild(added);
+                vector<Component*>* children = c->GetChildren();
+                if(op.position < (int)children->size() - 1)
+                    std::rotate(children->begin() + op.position, children->end() - 1, children->end());
+                break;
+            }
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,108 @@
+#ifndef TOPOLOGY_DIFF
+#define TOPOLOGY_DIFF
+
+#include <vector>
+#include <string>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+using namespace std;
+
+#define SYS_SAGE_PATCH_REMOVE_DATAPATH 1 /**< remove the DataPath identified by path, targetPath, oriented, dpType and ordinal */
+#define SYS_SAGE_PATCH_REMOVE_COMPONENT 2 /**< remove the component at path (with its subtree and DataPaths) */
+#define SYS_SAGE_PATCH_SET_FIELD 3 /**< set field (SYS_SAGE_PATCH_FIELD_*) of the component at path to intValue/strValue */
+#define SYS_SAGE_PATCH_SET_ATTRIB 4 /**< set attribute attribKey of the component at path */
+#define SYS_SAGE_PATCH_REMOVE_ATTRIB 5 /**< remove attribute attribKey of the component at path */
+#define SYS_SAGE_PATCH_ADD_COMPONENT 6 /**< insert a copy of subtree as a child of the component at path, at index position */
+#define SYS_SAGE_PATCH_ADD_DATAPATH 7 /**< add a DataPath from path to targetPath (paths in the patched tree) */
+
+#define SYS_SAGE_PATCH_FIELD_NAME 1 /**< Component::GetName() (strValue) */
+#define SYS_SAGE_PATCH_FIELD_CACHE_NAME 2 /**< Cache::GetCacheName() (strValue) */
+#define SYS_SAGE_PATCH_FIELD_CACHE_SIZE 3 /**< Cache::GetCacheSize() */
+#define SYS_SAGE_PATCH_FIELD_CACHE_ASSOCIATIVITY 4 /**< Cache::GetCacheAssociativityWays() */
+#define SYS_SAGE_PATCH_FIELD_CACHE_LINE_SIZE 5 /**< Cache::GetCacheLineSize() */
+#define SYS_SAGE_PATCH_FIELD_CHIP_VENDOR 6 /**< Chip::GetVendor() (strValue) */
+#define SYS_SAGE_PATCH_FIELD_CHIP_MODEL 7 /**< Chip::GetModel() (strValue) */
+#define SYS_SAGE_PATCH_FIELD_CHIP_TYPE 8 /**< Chip::GetChipType() */
+#define SYS_SAGE_PATCH_FIELD_SUBDIVISION_TYPE 9 /**< Subdivision::GetSubdivisionType() */
+#define SYS_SAGE_PATCH_FIELD_SIZE 10 /**< GetSize() of Numa, Memory or Storage */
+
+/**
+Class TopologyPatch - the differences between two versions of a Component Tree, produced by Diff() and applied to a live topology by ApplyPatch().
+\n Components are addressed by their path from the root: for each level the componentType, the id and the ordinal among the siblings with the same componentType and id. DataPaths are addressed by the paths of their source and target, oriented, dp_type and the ordinal among the DataPaths with the same endpoints and properties.
+\n The operations are ordered as they are applied: DataPath and component removals, field and attribute changes, component additions, DataPath additions. The paths of the first three groups and the parent paths of added components refer to the old tree; the paths of added DataPaths refer to the patched tree.
+@see Diff()
+@see ApplyPatch()
+*/
+class TopologyPatch {
+public:
+    struct ComponentKey {
+        int componentType;
+        int id;
+        int ordinal; /**< index among the siblings with the same componentType and id */
+    };
+    struct Operation {
+        int type; /**< SYS_SAGE_PATCH_* */
+        vector<ComponentKey> path; /**< the component (the parent for SYS_SAGE_PATCH_ADD_COMPONENT, the source for DataPath operations) */
+        vector<ComponentKey> targetPath; /**< target of a DataPath */
+        int position { 0 }; /**< SYS_SAGE_PATCH_ADD_COMPONENT: index among the children of the parent */
+        Component* subtree { nullptr }; /**< SYS_SAGE_PATCH_ADD_COMPONENT: copy of the added subtree (incl. its inner DataPaths), owned by the patch */
+        int field { 0 }; /**< SYS_SAGE_PATCH_SET_FIELD: SYS_SAGE_PATCH_FIELD_* */
+        long long intValue { 0 };
+        string strValue;
+        string attribKey; /**< SYS_SAGE_PATCH_SET_ATTRIB, SYS_SAGE_PATCH_REMOVE_ATTRIB */
+        int attribType { SYS_SAGE_ATTRIB_TYPE_NONE }; /**< SYS_SAGE_ATTRIB_TYPE_* of the attribute */
+        vector<char> attribData; /**< value serialized by its AttribTypeDescriptor; the pointer itself for untyped pointers without a descriptor */
+        int oriented { 0 }; /**< DataPath operations */
+        int dpType { 0 };
+        int ordinal { 0 }; /**< SYS_SAGE_PATCH_REMOVE_DATAPATH */
+        double bw { 0 };
+        double latency { 0 };
+        AttribStore dpAttrib; /**< SYS_SAGE_PATCH_ADD_DATAPATH: attributes of the DataPath */
+    };
+
+    TopologyPatch() = default;
+    TopologyPatch(const TopologyPatch&) = delete;
+    TopologyPatch& operator=(const TopologyPatch&) = delete;
+    ~TopologyPatch();
+
+    /**
+    @returns the operations of the patch, in the order they are applied
+    */
+    const vector<Operation>& GetOperations();
+    /**
+    @returns true if the two trees were equal
+    */
+    bool IsEmpty();
+    /**
+    Prints the operations to stdout, one per line.
+    */
+    void Print();
+
+private:
+    vector<Operation> operations;
+
+    friend TopologyPatch* Diff(Component* oldRoot, Component* newRoot);
+};
+
+/**
+Computes the differences between two versions of a Component Tree, e.g. of the same machine discovered before and after a CPU hotplug or MIG reconfiguration.
+\n Children are matched by componentType and id (and their order among equal siblings). Added subtrees are stored as copies (see Component::CloneSubtree()); field changes cover the name and the type-specific properties; attributes are compared by their string representation (AttribRegistry), untyped pointers without a registered descriptor by the pointer. Only DataPaths with both endpoints within the trees are considered; a changed DataPath is removed and added again.
+@param oldRoot - root of the old version
+@param newRoot - root of the new version (the roots are matched with each other)
+@return the patch (to be deleted by the caller), or NULL if the roots are of different componentTypes or the new tree contains a component of a user-defined type
+@see ApplyPatch()
+*/
+TopologyPatch* Diff(Component* oldRoot, Component* newRoot);
+/**
+Applies a patch to a live topology in place. Components that are not changed by the patch (and the pointers to them) are kept.
+\n The patch can be applied several times (e.g. to several copies of the old version); added subtrees are copied from the patch.
+@param root - root of the topology to update (corresponds to oldRoot of Diff())
+@param patch - the patch
+@return 0 if all operations were applied, otherwise the number of operations whose components or DataPaths were not found (these are skipped)
+@see Diff()
+*/
+int ApplyPatch(Component* root, TopologyPatch* patch);
+
+#endif
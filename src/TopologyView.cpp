@@ -0,0 +1,277 @@
+#include "TopologyView.hpp"
+
+#include <fstream>
+#include <sstream>
+
+//bit position of a SYS_SAGE_COMPONENT_* type (index into Aggregates::typeCounts), -1 for other (user-defined) types
+static int TypeIndex(int _componentType)
+{
+    if(_componentType <= 0 || (_componentType & (_componentType - 1)) != 0)
+        return -1;
+    int idx = __builtin_ctz(_componentType);
+    return idx < SYS_SAGE_COMPONENT_NUM_TYPES ? idx : -1;
+}
+
+TopologyView::TopologyView(Component* _root, function<bool(Component*)> _predicate): root(_root), predicate(_predicate) {}
+
+TopologyView::TopologyView(Component* _root, const CpuSet& allowed): root(_root)
+{
+    predicate = [allowed](Component* c){
+        const CpuSet& cpuset = c->GetCpuSet();
+        return cpuset.IsEmpty() || cpuset.Intersects(allowed);
+    };
+}
+
+int TopologyView::ReadCgroupCpuSet(const string& path, CpuSet* out)
+{
+    ifstream file(path);
+    if(!file.is_open())
+    {
+        cerr << "could not open " << path << endl;
+        return 1;
+    }
+    stringstream content;
+    content << file.rdbuf();
+    if(out->Parse(content.str()) != 0)
+    {
+        cerr << "could not parse cpuset " << path << endl;
+        return 1;
+    }
+    return 0;
+}
+
+Component* TopologyView::GetRoot(){ return root; }
+
+void TopologyView::CheckVersion()
+{
+    if(version != Component::GetTreeVersion())
+    {
+        Invalidate();
+        version = Component::GetTreeVersion();
+    }
+}
+
+void TopologyView::Invalidate()
+{
+    passes.clear();
+    aggregates.clear();
+}
+
+bool TopologyView::Passes(Component* c)
+{
+    auto it = passes.find(c);
+    if(it != passes.end())
+        return it->second;
+    bool ret = predicate(c);
+    passes[c] = ret;
+    return ret;
+}
+
+bool TopologyView::Contains(Component* c)
+{
+    CheckVersion();
+    for(; c != NULL; c = c->GetParent())
+    {
+        if(c == root)
+            return true;
+        if(!Passes(c))
+            return false;
+    }
+    return false;
+}
+
+vector<Component*> TopologyView::GetChildren(Component* c)
+{
+    if(c == NULL)
+        c = root;
+    vector<Component*> ret;
+    if(!Contains(c))
+        return ret;
+    for(Component* child : *(c->GetChildren()))
+    {
+        if(Passes(child))
+            ret.push_back(child);
+    }
+    return ret;
+}
+
+void TopologyView::CollectSubtree(vector<Component*>* outArray, int _componentTypeMask, Component* c)
+{
+    if(c->GetComponentType() & _componentTypeMask)
+        outArray->push_back(c);
+    for(Component* child : *(c->GetChildren()))
+    {
+        if(Passes(child))
+            CollectSubtree(outArray, _componentTypeMask, child);
+    }
+}
+
+void TopologyView::GetSubtreeNodeList(vector<Component*>* outArray, Component* c)
+{
+    if(c == NULL)
+        c = root;
+    if(Contains(c))
+        CollectSubtree(outArray, -1, c);
+}
+
+void TopologyView::GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, Component* c)
+{
+    if(c == NULL)
+        c = root;
+    if(!Contains(c))
+        return;
+    //the component type is compared for equality (user-defined types are not necessarily single bits)
+    vector<Component*> subtree;
+    CollectSubtree(&subtree, -1, c);
+    for(Component* s : subtree)
+    {
+        if(s->GetComponentType() == _componentType)
+            outArray->push_back(s);
+    }
+}
+
+vector<Component*> TopologyView::GetAllSubcomponentsByType(int _componentType, Component* c)
+{
+    vector<Component*> ret;
+    GetAllSubcomponentsByType(&ret, _componentType, c);
+    return ret;
+}
+
+Component* TopologyView::GetSubcomponentById(int _id, int _componentType, Component* c)
+{
+    if(c == NULL)
+        c = root;
+    if(!Contains(c))
+        return NULL;
+    vector<Component*> stack{c};
+    while(!stack.empty())
+    {
+        Component* s = stack.back();
+        stack.pop_back();
+        if(s->GetComponentType() == _componentType && s->GetId() == _id)
+            return s;
+        vector<Component*>* children = s->GetChildren();
+        for(auto it = children->rbegin(); it != children->rend(); ++it)
+        {
+            if(Passes(*it))
+                stack.push_back(*it);
+        }
+    }
+    return NULL;
+}
+
+TopologyView::Aggregates& TopologyView::GetAggregates(Component* c)
+{
+    auto it = aggregates.find(c);
+    if(it != aggregates.end())
+        return it->second;
+
+    Aggregates a;
+    if(c->GetComponentType() == SYS_SAGE_COMPONENT_THREAD)
+        a.cpuset.Set(c->GetId());
+    for(Component* child : *(c->GetChildren()))
+    {
+        if(!Passes(child))
+            continue;
+        //references to the elements of an unordered_map stay valid when it grows
+        Aggregates& ca = GetAggregates(child);
+        for(int t = 0; t < SYS_SAGE_COMPONENT_NUM_TYPES; t++)
+            a.typeCounts[t] += ca.typeCounts[t];
+        int childType = TypeIndex(child->GetComponentType());
+        if(childType >= 0)
+            a.typeCounts[childType]++;
+        a.size += ca.size + 1;
+        a.cpuset |= ca.cpuset;
+    }
+    return aggregates[c] = std::move(a);
+}
+
+int TopologyView::CountAllSubcomponentsByType(int _componentType, Component* c)
+{
+    if(c == NULL)
+        c = root;
+    if(!Contains(c))
+        return 0;
+    int idx = TypeIndex(_componentType);
+    if(idx >= 0)
+        return GetAggregates(c).typeCounts[idx];
+    int count = GetAllSubcomponentsByType(_componentType, c).size();
+    return c->GetComponentType() == _componentType ? count - 1 : count;
+}
+
+int TopologyView::CountAllSubcomponents(Component* c)
+{
+    if(c == NULL)
+        c = root;
+    if(!Contains(c))
+        return 0;
+    return GetAggregates(c).size;
+}
+
+int TopologyView::GetNumThreads(Component* c)
+{
+    if(c == NULL)
+        c = root;
+    if(!Contains(c))
+        return 0;
+    if(c->GetComponentType() == SYS_SAGE_COMPONENT_THREAD)
+        return 1;
+    return GetAggregates(c).typeCounts[TypeIndex(SYS_SAGE_COMPONENT_THREAD)];
+}
+
+const CpuSet& TopologyView::GetCpuSet(Component* c)
+{
+    static const CpuSet empty;
+    if(c == NULL)
+        c = root;
+    if(!Contains(c))
+        return empty;
+    return GetAggregates(c).cpuset;
+}
+
+Component* TopologyView::FindSmallestComponentCovering(const CpuSet& set, int componentTypeMask)
+{
+    if(set.IsEmpty() || !set.IsSubsetOf(GetCpuSet(root)))
+        return NULL;
+    Component* found = (root->GetComponentType() & componentTypeMask) ? root : NULL;
+    for(Component* c = root; c != NULL; )
+    {
+        Component* next = NULL;
+        for(Component* child : *(c->GetChildren()))
+        {
+            if(Passes(child) && set.IsSubsetOf(GetAggregates(child).cpuset))
+            {
+                next = child;
+                break;
+            }
+        }
+        if(next != NULL && (next->GetComponentType() & componentTypeMask))
+            found = next;
+        c = next;
+    }
+    return found;
+}
+
+vector<DataPath*> TopologyView::GetDataPaths(Component* c, int orientation)
+{
+    vector<DataPath*> ret;
+    if(!Contains(c))
+        return ret;
+    for(DataPath* dp : *(c->GetDataPaths(orientation)))
+    {
+        if(Contains(dp->GetSource()) && Contains(dp->GetTarget()))
+            ret.push_back(dp);
+    }
+    return ret;
+}
+
+vector<Component*> TopologyView::Query(const string& expression)
+{
+    vector<Component*> ret;
+    for(Component* c : root->Query(expression))
+    {
+        if(Contains(c))
+            ret.push_back(c);
+    }
+    return ret;
+}
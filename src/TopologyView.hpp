@@ -0,0 +1,132 @@
+#ifndef TOPOLOGY_VIEW
+#define TOPOLOGY_VIEW
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+#include "Topology.hpp"
+#include "CpuSet.hpp"
+
+using namespace std;
+
+/**
+Class TopologyView - a filtered view of a Component subtree, e.g. the part of the machine a container is allowed to use. No components are copied; excluded components are skipped on the fly.
+\n A component is part of the view if it is the root of the view, or if its parent is part of the view and it passes the filter -- i.e. excluding a component excludes its whole subtree.
+\n Filters: an arbitrary predicate, or an allowed cpuset (e.g. read from cpuset.cpus.effective of a cgroup, see ReadCgroupCpuSet()). With a cpuset, components whose cpuset (Component::GetCpuSet()) does not intersect the allowed set are excluded; components without hardware threads (Memory, Numa, GPUs, ...) are kept under included parents.
+\n The membership of the components and the derived aggregates (counts, cpusets) are cached. The caches are dropped automatically when the structure of a Component Tree changes (Component::GetTreeVersion()); call Invalidate() if the predicate depends on other data (e.g. attributes) that changed.
+*/
+class TopologyView {
+public:
+    /**
+    @param root - the root of the viewed subtree (always part of the view)
+    @param predicate - returns true for the components to keep
+    */
+    TopologyView(Component* root, function<bool(Component*)> predicate);
+    /**
+    @param root - the root of the viewed subtree (always part of the view)
+    @param allowed - the allowed hardware threads; Threads outside of this set and components without any allowed Thread are excluded
+    */
+    TopologyView(Component* root, const CpuSet& allowed);
+    /**
+    Reads the cpuset of a cgroup (cgroup v2), e.g. ReadCgroupCpuSet("/sys/fs/cgroup/cpuset.cpus.effective", &allowed).
+    @param path - path to a file in the Linux list format (cpuset.cpus.effective, cpuset.cpus, /sys/devices/system/cpu/online, ...)
+    @param out - output parameter; the parsed set
+    @return 0 on success, 1 if the file could not be read or parsed
+    */
+    static int ReadCgroupCpuSet(const string& path, CpuSet* out);
+
+    /**
+    @returns the root of the view
+    */
+    Component* GetRoot();
+    /**
+    @returns true if the component is part of the view; for a component of a shared subtree, only the ancestors of the first instance are considered (see Component::ShareIdenticalSubtrees())
+    */
+    bool Contains(Component* c);
+    /**
+    Drops the cached membership and aggregates.
+    */
+    void Invalidate();
+
+    /**
+    Equivalent of Component::GetChildren() on the view.
+    @param c - the component, NULL for the root of the view
+    @return the children of c that are part of the view (empty if c is not part of the view)
+    */
+    vector<Component*> GetChildren(Component* c = NULL);
+    /**
+    Equivalent of Component::GetSubtreeNodeList() on the view (DFS pre-order, including c).
+    @param outArray - output parameter (vector with results); must be allocated before the call
+    @param c - the component, NULL for the root of the view
+    */
+    void GetSubtreeNodeList(vector<Component*>* outArray, Component* c = NULL);
+    /**
+    Equivalent of Component::GetAllSubcomponentsByType() on the view (DFS pre-order, including c if it matches).
+    @param outArray - output parameter (vector with results); must be allocated before the call
+    @param _componentType - the component type to look for
+    @param c - the component, NULL for the root of the view
+    */
+    void GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, Component* c = NULL);
+    /**
+    @see GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, Component* c)
+    */
+    vector<Component*> GetAllSubcomponentsByType(int _componentType, Component* c = NULL);
+    /**
+    Equivalent of Component::GetSubcomponentById() on the view. Returns the first match in DFS order.
+    @return the component, or NULL if there is no match in the view
+    */
+    Component* GetSubcomponentById(int _id, int _componentType, Component* c = NULL);
+    /**
+    Equivalent of Component::CountAllSubcomponentsByType() on the view (descendants of c only). Cached.
+    */
+    int CountAllSubcomponentsByType(int _componentType, Component* c = NULL);
+    /**
+    Equivalent of Component::CountAllSubcomponents() on the view (descendants of c only). Cached.
+    */
+    int CountAllSubcomponents(Component* c = NULL);
+    /**
+    Equivalent of Component::GetNumThreads() on the view. Cached.
+    */
+    int GetNumThreads(Component* c = NULL);
+    /**
+    Equivalent of Component::GetCpuSet() on the view, i.e. the ids of the Threads of the subtree of c that are part of the view. Cached.
+    @return the cpuset (empty if c is not part of the view)
+    */
+    const CpuSet& GetCpuSet(Component* c = NULL);
+    /**
+    Equivalent of Component::FindSmallestComponentCovering() on the view.
+    */
+    Component* FindSmallestComponentCovering(const CpuSet& set, int componentTypeMask = -1);
+    /**
+    Equivalent of Component::GetDataPaths() on the view: only DataPaths whose source and target are both part of the view.
+    @param c - the component
+    @param orientation - SYS_SAGE_DATAPATH_INCOMING or SYS_SAGE_DATAPATH_OUTGOING
+    */
+    vector<DataPath*> GetDataPaths(Component* c, int orientation);
+    /**
+    Equivalent of Component::Query() on the view: evaluates the path expression on the root of the view and drops the components that are not part of the view.
+    */
+    vector<Component*> Query(const string& expression);
+
+private:
+    struct Aggregates {
+        int typeCounts[SYS_SAGE_COMPONENT_NUM_TYPES] {}; /**< descendants of each SYS_SAGE_COMPONENT_* type; index = bit position of the type */
+        int size { 0 }; /**< number of descendants */
+        CpuSet cpuset;
+    };
+
+    void CheckVersion();
+    bool Passes(Component* c);
+    Aggregates& GetAggregates(Component* c);
+    void CollectSubtree(vector<Component*>* outArray, int _componentTypeMask, Component* c);
+
+    Component* root;
+    function<bool(Component*)> predicate;
+    unsigned long long version { 0 }; /**< Component::GetTreeVersion() the caches were computed for */
+    unordered_map<Component*, bool> passes; /**< cached results of the predicate */
+    unordered_map<Component*, Aggregates> aggregates;
+};
+
+#endif
@@ -75,12 +75,10 @@ int readCpuinfoFreq(std::vector<Thread*> threads, bool keep_history = false)
                     ((Core*)c)->SetFreq(freq);
                     if(keep_history)
                     {
-                        //check if freq_history exists; if not, create it -- vector of tuples <timestamp,frequency>
-                        if (c->attrib.find("freq_history") == c->attrib.end()) {
-                            c->attrib["freq_history"] = (void*) new std::vector<std::tuple<long long,double>>();
-                        }
+                        //append <timestamp,frequency> to freq_history (ring buffer of the last SYS_SAGE_TIME_SERIES_DEFAULT_CAPACITY samples; created on first use)
+                        static const AttribKey freq_history("freq_history");
                         long long ts = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-                        ((std::vector<std::tuple<long long,double>>*)c->attrib["freq_history"])->push_back(std::make_tuple(ts,freq));
+                        c->attrib.AppendSample(freq_history, ts, freq);
                     }
                     //cout << "----------------Core " << c->GetId() << " (HW thread " << threads[current_thread_pos]->GetId() << ") frequency: " << freq << endl;
                     threads_processed++;
@@ -106,7 +104,10 @@ int Node::RefreshCpuCoreFrequency(bool keep_history)
     for(Component * socket : sockets)
     {
         if(((Chip*)socket)->GetChipType() == SYS_SAGE_CHIP_TYPE_CPU_SOCKET || ((Chip*)socket)->GetChipType() == SYS_SAGE_CHIP_TYPE_CPU)
-            socket->FindAllSubcomponentsByType((vector<Component*>*)&cpu_hw_threads, SYS_SAGE_COMPONENT_THREAD);
+        {
+            vector<Thread*> socket_threads = socket->GetAllSubcomponents<Thread>();
+            cpu_hw_threads.insert(cpu_hw_threads.end(), socket_threads.begin(), socket_threads.end());
+        }
     }
 
     //remove duplicate threads of the same core (hyperthreading -- 2 threads on the same core have the same freq)
@@ -8,11 +8,16 @@
 #include <sstream>
 #include <string>
 #include <array>
+#include <chrono>
 
 #include <nvml.h>
 
 #include "Topology.hpp"
 
+//attribute keys of the MIG DataPaths (interned once)
+static const AttribKey mig_uuid_key("mig_uuid");
+static const AttribKey mig_size_key("mig_size");
+static const AttribKey mig_size_history_key("mig_size_history");
 
 //nvmlReturn_t nvmlDeviceGetMigDeviceHandleByIndex ( nvmlDevice_t device, unsigned int  index, nvmlDevice_t* migDevice ) --> look for all mig devices and add/update them
 int Chip::UpdateMIGSettings(string uuid)
@@ -47,22 +52,15 @@ int Chip::UpdateMIGSettings(string uuid)
     
     //main memory, expects the memory as a child of
     Memory* m = (Memory*)GetChildByType(SYS_SAGE_COMPONENT_MEMORY);
-    long long* mig_size;
+    long long mig_size = 0;
+    //the sizes are also recorded in "mig_size_history" (ring buffer of <timestamp,size>)
+    long long ts = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     if(m != NULL){
-        DataPath * d = NULL;
-        //iterate over dp_outgoing to check if DP already exists
-        for(DataPath* dp : dp_outgoing){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
-                d = dp;
-                break;
-            }
-        }
-
-        d = new DataPath(this, m, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
-        string* mig_uuid = new string(uuid);
-        mig_size = new long long(attributes.memorySizeMB*1000000);
-        d->attrib.insert({"mig_uuid",(void*)mig_uuid});
-        d->attrib.insert({"mig_size",(void*)mig_size});
+        //reuse the DataPath of this MIG instance if it already exists
+        DataPath * d = UpsertDataPath(this, m, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, mig_uuid_key, uuid);
+        mig_size = attributes.memorySizeMB*1000000;
+        d->attrib.Set(mig_size_key, mig_size);
+        d->attrib.AppendSample(mig_size_history_key, ts, mig_size);
     } else {
         std::cerr << "Chip::UpdateMIGSettings: Component Type Memory not found as a child of this Chip. Memory info will not be updated." << std::endl;
         ret = 1;
@@ -70,8 +68,8 @@ int Chip::UpdateMIGSettings(string uuid)
 
     //L2 cache(s)
     unsigned int L2_fraction = 1; //which fraction of L2 is in MIG partition (the same fraction as the fraction of main memory)
-    if(m->GetSize() > *mig_size){
-        L2_fraction = (m->GetSize() + (*mig_size/2)) / *mig_size; //divide and round up or down
+    if(m != NULL && mig_size > 0 && m->GetSize() > mig_size){
+        L2_fraction = (m->GetSize() + (mig_size/2)) / mig_size; //divide and round up or down
     }
     vector<Component*> caches;
     FindAllSubcomponentsByType(&caches, SYS_SAGE_COMPONENT_CACHE);
@@ -85,14 +83,12 @@ int Chip::UpdateMIGSettings(string uuid)
     if(num_caches > 0){
         int cache_id = 0;
         for(Cache* c : L2_caches){
-            DataPath * d = new DataPath(this, c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
-            string* mig_uuid = new string(uuid);
-            mig_size = new long long();
-            *mig_size = c->GetCacheSize() * ( (float)num_caches/(float)L2_fraction-(float)cache_id/(float)num_caches);
-            if(*mig_size <0)
-                *mig_size=0;
-            d->attrib.insert({"mig_uuid",(void*)mig_uuid});
-            d->attrib.insert({"mig_size",(void*)mig_size});
+            DataPath * d = UpsertDataPath(this, c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, mig_uuid_key, uuid);
+            long long cache_mig_size = c->GetCacheSize() * ( (float)num_caches/(float)L2_fraction-(float)cache_id/(float)num_caches);
+            if(cache_mig_size <0)
+                cache_mig_size=0;
+            d->attrib.Set(mig_size_key, cache_mig_size);
+            d->attrib.AppendSample(mig_size_history_key, ts, cache_mig_size);
             cache_id++;
         }
     } else {
@@ -110,9 +106,15 @@ int Chip::UpdateMIGSettings(string uuid)
     }
     for(Subdivision* sm: sms){
         if(sm->GetId() < (int)attributes.multiprocessorCount){
-            DataPath * d = new DataPath(this, sm, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
-            string* mig_uuid = new string(uuid);
-            d->attrib.insert({"mig_uuid",(void*)mig_uuid});
+            UpsertDataPath(this, sm, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, mig_uuid_key, uuid);
+        } else {
+            //the SM is no longer part of this MIG instance
+            DataPath * d = FindDataPath(this, sm, SYS_SAGE_DATAPATH_TYPE_MIG, [&uuid](DataPath* dp){
+                string* dp_uuid = dp->attrib.Get<string>(mig_uuid_key);
+                return dp_uuid != NULL && *dp_uuid == uuid;
+            });
+            if(d != NULL)
+                d->DeleteDataPath();
         }
     }
 
@@ -142,8 +144,9 @@ int Chip::GetMIGNumSMs(string uuid)
     } 
     else
     {
-        for(DataPath* dp: dp_outgoing){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
+        for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING)){
+            string* dp_uuid = dp->attrib.Get<string>(mig_uuid_key);
+            if(dp_uuid != NULL && *dp_uuid == uuid){
                 Component* target = dp->GetTarget();
                 if(target->GetComponentType() == SYS_SAGE_COMPONENT_SUBDIVISION && ((Subdivision*)target)->GetSubdivisionType() == SYS_SAGE_SUBDIVISION_TYPE_GPU_SM ){
                     num_sm++;
@@ -177,8 +180,9 @@ int Chip::GetMIGNumCores(string uuid)
     }
     else
     {
-        for(DataPath* dp: dp_outgoing){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
+        for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING)){
+            string* dp_uuid = dp->attrib.Get<string>(mig_uuid_key);
+            if(dp_uuid != NULL && *dp_uuid == uuid){
                 Component* target = dp->GetTarget();
                 if(target->GetComponentType() == SYS_SAGE_COMPONENT_SUBDIVISION && ((Subdivision*)target)->GetSubdivisionType() == SYS_SAGE_SUBDIVISION_TYPE_GPU_SM ){
                     sms.push_back((Subdivision*)target);
@@ -209,11 +213,12 @@ long long Memory::GetMIGSize(string uuid)
         return size;
     } 
 
-    for(DataPath* dp: dp_incoming){
-        if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
-            if (dp->attrib.count("mig_size")){
-                long long r = *(long long*)dp->attrib["mig_size"];
-                return r;
+    for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_INCOMING)){
+        string* dp_uuid = dp->attrib.Get<string>(mig_uuid_key);
+        if(dp_uuid != NULL && *dp_uuid == uuid){
+            long long* r = dp->attrib.Get<long long>(mig_size_key);
+            if (r != NULL){
+                return *r;
             }
         }
     }
@@ -236,11 +241,12 @@ long long Cache::GetMIGSize(string uuid)
     }
 
     if(GetCacheLevel() == 2){
-        for(DataPath* dp: dp_incoming){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
-                if (dp->attrib.count("mig_size")){
-                    long long r = *(long long*)dp->attrib["mig_size"];
-                    return r;
+        for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_INCOMING)){
+            string* dp_uuid = dp->attrib.Get<string>(mig_uuid_key);
+            if(dp_uuid != NULL && *dp_uuid == uuid){
+                long long* r = dp->attrib.Get<long long>(mig_size_key);
+                if (r != NULL){
+                    return *r;
                 }
             }
         }
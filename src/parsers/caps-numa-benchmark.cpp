@@ -7,8 +7,9 @@
 
 using namespace std;
 
-int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim)
+int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim, TopologyArena* arena)
 {
+    TopologyArena::Scope arenaScope(arena);
     CSVReader reader(benchmarkPath, delim);
     vector<vector<string> > benchmarkData;
     if(reader.getData(&benchmarkData) != 0) {//Error
@@ -47,6 +48,10 @@ int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, strin
         return 1;
     }
 
+    //each line needs two lookups by id -- use the (componentType, id) index instead of a DFS per lookup
+    bool had_index = rootComponent->HasSubcomponentIndex();
+    rootComponent->EnableSubcomponentIndex();
+
     //cout << "caps-numa-benchmark parser: num entries: " << benchmarkData.size()-1 << endl;
     //parse each line as one DataPath, skip header
     for(unsigned int i=1; i<benchmarkData.size(); i++)
@@ -74,6 +79,8 @@ int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, strin
 
         }
     }
+    if(!had_index)
+        rootComponent->DisableSubcomponentIndex();
     return 0;
 }
 
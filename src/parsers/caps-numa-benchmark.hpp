@@ -3,8 +3,9 @@
 
 #include "Topology.hpp"
 #include "DataPath.hpp"
+#include "TopologyArena.hpp"
 
-int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim = ";");
+int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim = ";", TopologyArena* arena = NULL);
 
 class CSVReader
 {
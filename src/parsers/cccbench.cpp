@@ -84,41 +84,90 @@ CccbenchParser::CccbenchParser(const char *csv_path)
     }
 }
 
-void CccbenchParser::applyDataPaths(Component *root)
+bool CccbenchParser::getLatencies(int xci, int yci, float *mean, float *min, float *max)
 {
-    auto corev = new vector<Component *>();
-    root->FindAllSubcomponentsByType(corev, SYS_SAGE_COMPONENT_CORE);
-    //auto corev = root->GetAllChildrenByType(SYS_SAGE_COMPONENT_CORE);
+    auto& xtoylatv = (*this->c2cDatapoints)[xci][yci];
+    if(xtoylatv.empty())
+    {
+        return false;
+    }
+    auto sum = accumulate(xtoylatv.begin(), xtoylatv.end(), 0.0);
+    *mean = sum / xtoylatv.size();
+    *max = *max_element(xtoylatv.begin(), xtoylatv.end());
+    *min = *min_element(xtoylatv.begin(), xtoylatv.end());
+    return true;
+}
+
+DataPathMatrix *CccbenchParser::applyDataPaths(Component *root)
+{
+    vector<Component *> corev;
+    root->FindAllSubcomponentsByType(&corev, SYS_SAGE_COMPONENT_CORE);
+    if(corev.empty())
+        return NULL;
+
+    //one dense all-to-all relation instead of cores^2 DataPaths with their own attributes
+    auto matrix = new DataPathMatrix(corev, SYS_SAGE_DATAPATH_TYPE_C2C, {"latency", "latency_min", "latency_max"});
+    for(size_t x = 0; x < corev.size(); x++)
+    {
+        for(size_t y = 0; y < corev.size(); y++)
+        {
+            auto xci = corev[x]->GetId();
+            auto yci = corev[y]->GetId();
+            if(xci == yci)
+            {
+                continue;
+            }
+            float mean, min, max;
+            if(!getLatencies(xci, yci, &mean, &min, &max))
+            {
+                continue;
+            }
+            matrix->Set(x, y, 0, mean);
+            matrix->Set(x, y, 1, min);
+            matrix->Set(x, y, 2, max);
+        }
+    }
+    return matrix;
+}
 
-    for(auto xcore : *corev)
+int CccbenchParser::createDataPaths(Component *root)
+{
+    static const AttribKey latency_key("latency");
+    static const AttribKey latency_min_key("latency_min");
+    static const AttribKey latency_max_key("latency_max");
+    vector<Component *> corev;
+    root->FindAllSubcomponentsByType(&corev, SYS_SAGE_COMPONENT_CORE);
+    int created = 0;
+    for(auto xcore : corev)
     {
-        for(auto ycore : *corev)
+        for(auto ycore : corev)
         {
             auto xci = xcore->GetId();
             auto yci = ycore->GetId();
-            if(xci == yci)
+            float mean, min, max;
+            if(xci == yci || !getLatencies(xci, yci, &mean, &min, &max))
             {
                 continue;
             }
-            auto xtoylatv = (*this->c2cDatapoints)[xci][yci];
-            auto sum = accumulate(xtoylatv.begin(), xtoylatv.end(), 0.0);
-            auto mean = new float(sum / xtoylatv.size());
-            auto max = new float(*max_element(xtoylatv.begin(), xtoylatv.end()));
-            auto min = new float(*min_element(xtoylatv.begin(), xtoylatv.end()));
-            auto dtp = new DataPath(xcore, ycore, SYS_SAGE_DATAPATH_ORIENTED,
-                                   SYS_SAGE_DATAPATH_TYPE_C2C, 0, *mean);
-            dtp->attrib.insert(std::pair<string, void *>("latency_max", (void *)max));
-            dtp->attrib.insert(std::pair<string, void *>("latency_min", (void *)min));
-            dtp->attrib.insert(std::pair<string, void *>("latency", (void *)mean));
+            auto dtp = new DataPath(xcore, ycore, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 0, mean);
+            dtp->attrib.Set(latency_max_key, max);
+            dtp->attrib.Set(latency_min_key, min);
+            dtp->attrib.Set(latency_key, mean);
+            created++;
         }
     }
+    return created;
 }
 
-int parseCccbenchOutput(Node* n, std::string cccPath)
+int parseCccbenchOutput(Node* n, std::string cccPath, TopologyArena* arena, int output)
 {
+    TopologyArena::Scope arenaScope(arena);
     const char *cstr_path = cccPath.c_str();
     auto cccparser = new CccbenchParser(cstr_path);
-    cccparser->applyDataPaths(n);
+    if(output & SYS_SAGE_CCCBENCH_MATRIX)
+        cccparser->applyDataPaths(n);
+    if(output & SYS_SAGE_CCCBENCH_DATAPATHS)
+        cccparser->createDataPaths(n);
     delete cccparser;
     return 0;
 }
@@ -4,8 +4,20 @@
 #include <vector>
 #include "Topology.hpp"
 #include "DataPath.hpp"
+#include "DataPathMatrix.hpp"
+#include "TopologyArena.hpp"
 
-int parseCccbenchOutput(Node* , std::string );
+#define SYS_SAGE_CCCBENCH_MATRIX 1 /**< store the core-to-core latencies in one DataPathMatrix */
+#define SYS_SAGE_CCCBENCH_DATAPATHS 2 /**< create one C2C DataPath per pair of cores (current default); needed by the code that only reads DataPaths, e.g. GetDpByType(SYS_SAGE_DATAPATH_TYPE_C2C), DataPathGraph and BuildDistanceMatrix() */
+
+/**
+Parses the output of cccbench (core-to-core latencies) and attaches it to the cores of n.
+\n DEPRECATION NOTE: the default output is still SYS_SAGE_CCCBENCH_DATAPATHS (cores^2 DataPaths) and will change to SYS_SAGE_CCCBENCH_MATRIX in the next release. Code that reads the latencies through DataPaths (GetDpByType(SYS_SAGE_DATAPATH_TYPE_C2C), DataPathGraph, BuildDistanceMatrix()) should then pass SYS_SAGE_CCCBENCH_DATAPATHS explicitly; pass SYS_SAGE_CCCBENCH_MATRIX to use the (much smaller) DataPathMatrix already now.
+@param output - SYS_SAGE_CCCBENCH_MATRIX, SYS_SAGE_CCCBENCH_DATAPATHS, or both (bitwise OR)
+@see CccbenchParser::applyDataPaths()
+@see CccbenchParser::createDataPaths()
+*/
+int parseCccbenchOutput(Node* , std::string , TopologyArena* arena = NULL, int output = SYS_SAGE_CCCBENCH_DATAPATHS);
 
 template <typename T>class Vec2DArray
 {
@@ -14,6 +26,7 @@ template <typename T>class Vec2DArray
     unsigned int size, xdim, ydim;
 public:
     Vec2DArray(unsigned xdim, unsigned ydim);
+    ~Vec2DArray(){delete [] array;}
     std::vector<T> *operator [](unsigned int xindex);
 };
 
@@ -39,12 +52,25 @@ class CccbenchParser{
     const char *ycore_name = "ycore";
     Vec2DArray<float> *c2cDatapoints;
     CccbenchParser():c2cDatapoints((Vec2DArray<float> *)0){}
+    //mean, minimal and maximal measured latency from core xci to core yci; false if there is no measurement
+    bool getLatencies(int xci, int yci, float *mean, float *min, float *max);
 public:
-    virtual ~CccbenchParser(){if(this->c2cDatapoints) {delete [] c2cDatapoints;}}
+    virtual ~CccbenchParser(){if(this->c2cDatapoints) {delete c2cDatapoints;}}
     unsigned int xtoi(unsigned int _x){return _x - this->firstCore;}
     unsigned int ytoi(unsigned int _y){return _y - this->firstCore;}
     CccbenchParser(const char *csv_path);
-    void applyDataPaths(Component *root);
+    /**
+    Stores the mean, minimal and maximal measured latency between all pairs of cores of the subtree in one DataPathMatrix (dp_type SYS_SAGE_DATAPATH_TYPE_C2C, metrics "latency", "latency_min", "latency_max").
+    \n The matrix is owned by its cores, like DataPaths by their endpoints: it is freed when the last of the cores is deleted (or calls DeleteAllDataPaths()), or earlier by DataPathMatrix::DeleteDataPathMatrix(). The caller must not delete it otherwise.
+    @return the matrix (NULL if there are no cores)
+    */
+    DataPathMatrix *applyDataPaths(Component *root);
+    /**
+    Creates one DataPath (SYS_SAGE_DATAPATH_ORIENTED, dp_type SYS_SAGE_DATAPATH_TYPE_C2C, the mean latency as its latency, attributes "latency", "latency_min", "latency_max") per measured pair of cores of the subtree, as applyDataPaths() did before the latencies were stored in a DataPathMatrix. The DataPaths are owned by the cores (freed with them, see DataPath).
+    \n Unlike the matrix, these DataPaths are seen by GetDpByType(), DataPathGraph and BuildDistanceMatrix().
+    @return the number of created DataPaths
+    */
+    int createDataPaths(Component *root);
 };
 
 #endif
@@ -10,19 +10,21 @@
 #include <string>
 
 
-int parseGpuTopo(Component* parent, string dataSourcePath, int gpuId, string delim)
+int parseGpuTopo(Component* parent, string dataSourcePath, int gpuId, string delim, TopologyArena* arena)
 {
+    TopologyArena::Scope arenaScope(arena);
     if(parent == NULL){
         std::cerr << "parseGpuTopo: parent is null" << std::endl;
         return 1;
     }
     Chip * gpu = new Chip(parent, gpuId, "GPU", SYS_SAGE_CHIP_TYPE_GPU);
 
-    return parseGpuTopo(gpu, dataSourcePath, delim);
+    return parseGpuTopo(gpu, dataSourcePath, delim, arena);
 }
 
-int parseGpuTopo(Chip* gpu, string dataSourcePath, string delim)
+int parseGpuTopo(Chip* gpu, string dataSourcePath, string delim, TopologyArena* arena)
 {
+    TopologyArena::Scope arenaScope(arena);
     GpuTopo gpuT(gpu, dataSourcePath, delim);
     int ret = gpuT.ParseBenchmarkData();
     return ret;
@@ -228,8 +230,7 @@ int GpuTopo::parseCOMPUTE_RESOURCE_INFORMATION()
                 cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            string * val = new string(data[i+1]);
-            root->attrib.insert({data[i], (void*)val});
+            root->attrib.Set(data[i], data[i+1]);
             i++;
         }
         else if(data[i]== "Number_of_streaming_multiprocessors" ||
@@ -240,19 +241,22 @@ int GpuTopo::parseCOMPUTE_RESOURCE_INFORMATION()
                 cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            int * val = new int(std::stoi(data[i+1]));
-            root->attrib.insert({data[i], (void*)val});
+            root->attrib.Set(data[i], std::stoi(data[i+1]));
 
             i++;
         }
     }
 
-    for(int i = 0; i < (*(int*)root->attrib["Number_of_streaming_multiprocessors"]); i++)
+    static const AttribKey num_sms_key("Number_of_streaming_multiprocessors");
+    static const AttribKey cores_per_sm_key("Number_of_cores_per_SM");
+    int num_sms = *root->attrib.Get<int>(num_sms_key);
+    int cores_per_sm = *root->attrib.Get<int>(cores_per_sm_key);
+    for(int i = 0; i < num_sms; i++)
     {
         //cout << "adding SM " << i << std::endl;
         Subdivision * sm = new Subdivision(root, i, "SM (Streaming Multiprocessor)");
         sm->SetSubdivisionType(SYS_SAGE_SUBDIVISION_TYPE_GPU_SM);
-        for(int j = 0; j<(*(int*)root->attrib["Number_of_cores_per_SM"]); j++)
+        for(int j = 0; j<cores_per_sm; j++)
         {
             new Thread(sm, j, "GPU Core");
         }
@@ -310,8 +314,7 @@ int GpuTopo::parseADDITIONAL_INFORMATION()
                 cerr << "parseREGISTER_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 2 additional values." << endl;
                 return 1;
             }
-            std::tuple<double, std::string>* val = new std::tuple<double, std::string>(stod(data[i+1]), data[i+2]);
-            root->attrib.insert({data[i], (void*)val});
+            root->attrib.Set(data[i], AttribValueUnit(stod(data[i+1]), data[i+2]));
             i+=2;
         }
     }
@@ -381,12 +384,10 @@ int GpuTopo::parseMAIN_MEMORY()
             mem->SetSize((long long)size);
 
         if(Memory_Clock_Frequency > -1){
-            double * mfreq = new double(Memory_Clock_Frequency);
-            mem->attrib.insert({"Clock_Frequency", (void*)mfreq});
+            mem->attrib.Set("Clock_Frequency", Memory_Clock_Frequency);
         }
         if(Memory_Bus_Width > -1){
-            int * busW = new int(Memory_Bus_Width);
-            mem->attrib.insert({"Bus_Width_bit", (void*)busW});
+            mem->attrib.Set("Bus_Width_bit", Memory_Bus_Width);
         }
 
         //make SMs as memory's children and inserd DP with latency
@@ -651,7 +652,8 @@ int GpuTopo::parseCaches(string header_name, string cache_type)
                 if(cache_line_size != -1)
                     cache->SetCacheLineSize(cache_line_size);
 
-                int cores_per_cache = (*(int*)root->attrib["Number_of_cores_per_SM"])/caches_per_sm;
+                static const AttribKey cores_per_sm_key("Number_of_cores_per_SM");
+                int cores_per_cache = (*root->attrib.Get<int>(cores_per_sm_key))/caches_per_sm;
 
                 //insert DP with latency
                 vector<Component*> children_copy;
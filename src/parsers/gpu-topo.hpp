@@ -3,9 +3,10 @@
 
 #include "Topology.hpp"
 #include "DataPath.hpp"
+#include "TopologyArena.hpp"
 
-int parseGpuTopo(Component* parent, string dataSourcePath, int gpuId, string delim = ";");
-int parseGpuTopo(Chip* gpu, string dataSourcePath, string delim = ";");
+int parseGpuTopo(Component* parent, string dataSourcePath, int gpuId, string delim = ";", TopologyArena* arena = NULL);
+int parseGpuTopo(Chip* gpu, string dataSourcePath, string delim = ";", TopologyArena* arena = NULL);
 
 class GpuTopo
 {
@@ -1,19 +1,23 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
+#include <string_view>
+
+#include <libxml/xmlreader.h>
 
 #include "hwloc.hpp"
 
 using namespace std;
 
-vector<string> xmlRelevantNames
+//the built-in lists, which parseHwlocOutput() dispatches on
+static const vector<string> defaultXmlRelevantNames
 {
     "topology",
     "object",
     "info"
 };
-
-vector<string> xmlRelevantObjectTypes
+static const vector<string> defaultXmlRelevantObjectTypes
 {
     "Machine",
     "Package",
@@ -27,6 +31,9 @@ vector<string> xmlRelevantObjectTypes
     "Group"
 };
 
+vector<string> xmlRelevantNames = defaultXmlRelevantNames;
+vector<string> xmlRelevantObjectTypes = defaultXmlRelevantObjectTypes;
+
 
 
 
@@ -98,6 +105,41 @@ Component* createChildC(string type, xmlNode* node)
     return c;
 }
 
+//inserts a newly parsed component childC as a child of c
+static void insertChildC(Component* c, Component* childC)
+{
+    bool inserted_as_sibling = false;
+    if(childC->GetComponentType() == SYS_SAGE_COMPONENT_CACHE)
+    {//make a cache a child of NUMA, if it is a sibling
+        vector<Component*>* siblings = c->GetChildren();
+        for(Component* sibling : *siblings){
+            if(sibling->GetComponentType() == SYS_SAGE_COMPONENT_NUMA) {
+                sibling->InsertChild(childC);
+                inserted_as_sibling = true;
+                break;
+            }
+        }
+    }
+    else if(childC->GetComponentType() == SYS_SAGE_COMPONENT_NUMA)
+    {//make the (already inserted) caches children of NUMA, if they are siblings
+        vector<Component*> caches;
+        for(Component* sibling : *c->GetChildren()){
+            if(sibling->GetComponentType() == SYS_SAGE_COMPONENT_CACHE)
+                caches.push_back(sibling);
+        }
+        if(!caches.empty()) {
+            c->InsertChild(childC);
+            for(Component* cache : caches) {
+                c->RemoveChild(cache);
+                childC->InsertChild(cache);
+            }
+            inserted_as_sibling = true;
+        }
+    }
+    if(!inserted_as_sibling)
+        c->InsertChild(childC);
+}
+
 int xmlProcessChildren(Component* c, xmlNode* parent, int level)
 {
     for (xmlNode* child = parent->children; child; child = child->next)
@@ -143,35 +185,7 @@ int xmlProcessChildren(Component* c, xmlNode* parent, int level)
                         {
                             //cout << "inserting " << type << " to " << c->GetName() << endl;
                             childC = createChildC(type, child);
-
-                            bool inserted_as_sibling = false;
-                            if(childC->GetComponentType() == SYS_SAGE_COMPONENT_CACHE)
-                            {//make a cache a child of NUMA, if it is a sibling
-                                vector<Component*>* siblings = c->GetChildren();
-                                for(Component* sibling : *siblings){
-                                    if(sibling->GetComponentType() == SYS_SAGE_COMPONENT_NUMA) {
-                                        sibling->InsertChild(childC);
-                                        inserted_as_sibling = true;
-                                        break;
-                                    }
-                                }
-                            }
-                            else if(childC->GetComponentType() == SYS_SAGE_COMPONENT_NUMA)
-                            {//make a (already inserted)cache a child of NUMA, if it is a sibling
-                                vector<Component*>* siblings = c->GetChildren();
-                                for(Component* sibling: *siblings){
-                                    if(sibling->GetComponentType() == SYS_SAGE_COMPONENT_CACHE) {
-                                        c->RemoveChild(sibling);
-                                        c->InsertChild(childC);
-                                        childC->InsertChild(childC);
-                                        sibling->InsertChild(sibling);
-                                        inserted_as_sibling = true;
-                                        break;
-                                    }
-                                }
-                            }
-                            if(!inserted_as_sibling)
-                                c->InsertChild(childC);
+                            insertChildC(c, childC);
                         }
                         xmlProcessChildren(childC, child, level+1);
                         //delete childC;
@@ -222,9 +236,10 @@ int removeUnknownCompoents(Component* c){
     return ret;
 }
 
-//parses a hwloc output and adds it to topology
-int parseHwlocOutput(Node* n, string topoPath)
+//parses a hwloc output (DOM) and adds it to topology
+int parseHwlocOutputDOM(Node* n, string topoPath, TopologyArena* arena)
 {
+    TopologyArena::Scope arenaScope(arena);
     xmlDoc *document = xmlReadFile(topoPath.c_str(), NULL, 0);
     if (document == NULL) {
         cerr << "error: could not parse file " << topoPath.c_str() << endl;
@@ -247,3 +262,190 @@ int parseHwlocOutput(Node* n, string topoPath)
     err = n->CheckComponentTreeConsistency();
     return err;
 }
+
+//streaming parser: the keywords it dispatches on are looked up in perfect-hash tables
+//(6*length + s[0] + 9*s[1]) % 16 is collision-free for each table (checked at compile time), so a lookup is one hash and one string comparison
+#define HWLOC_KEYWORD_TABLE_SIZE 16
+
+static constexpr unsigned hwlocKeywordHash(std::string_view s)
+{
+    return s.size() < 2 ? 0 : (6 * s.size() + (unsigned char)s[0] + 9 * (unsigned char)s[1]) % HWLOC_KEYWORD_TABLE_SIZE;
+}
+
+template<size_t N> struct HwlocKeywordTable {
+    std::string_view slots[HWLOC_KEYWORD_TABLE_SIZE] {};
+    int ids[HWLOC_KEYWORD_TABLE_SIZE] {};
+    bool perfect = true;
+
+    //keyword i gets id i
+    constexpr HwlocKeywordTable(const std::string_view (&keywords)[N])
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            unsigned h = hwlocKeywordHash(keywords[i]);
+            if(!slots[h].empty())
+                perfect = false;
+            slots[h] = keywords[i];
+            ids[h] = i;
+        }
+    }
+    //@return id of the keyword, or -1
+    int Find(const char* s) const
+    {
+        std::string_view sv(s);
+        unsigned h = hwlocKeywordHash(sv);
+        return (!slots[h].empty() && slots[h] == sv) ? ids[h] : -1;
+    }
+};
+
+//XML element names (cf. xmlRelevantNames)
+enum { HWLOC_ELEMENT_TOPOLOGY, HWLOC_ELEMENT_OBJECT, HWLOC_ELEMENT_INFO };
+static constexpr std::string_view hwlocElementNames[] = { "topology", "object", "info" };
+static constexpr HwlocKeywordTable hwlocElements(hwlocElementNames);
+static_assert(hwlocElements.perfect, "hwlocKeywordHash collides on the element names");
+
+//object types (cf. xmlRelevantObjectTypes)
+enum { HWLOC_TYPE_MACHINE, HWLOC_TYPE_PACKAGE, HWLOC_TYPE_CACHE, HWLOC_TYPE_L3CACHE, HWLOC_TYPE_L2CACHE, HWLOC_TYPE_L1CACHE, HWLOC_TYPE_NUMANODE, HWLOC_TYPE_CORE, HWLOC_TYPE_PU, HWLOC_TYPE_GROUP };
+static constexpr std::string_view hwlocTypeNames[] = { "Machine", "Package", "Cache", "L3Cache", "L2Cache", "L1Cache", "NUMANode", "Core", "PU", "Group" };
+static constexpr HwlocKeywordTable hwlocTypes(hwlocTypeNames);
+static_assert(hwlocTypes.perfect, "hwlocKeywordHash collides on the object types");
+
+//object attributes used by createChildC()
+enum { HWLOC_ATTR_TYPE, HWLOC_ATTR_OS_INDEX, HWLOC_ATTR_GP_INDEX, HWLOC_ATTR_CACHE_SIZE, HWLOC_ATTR_DEPTH, HWLOC_ATTR_CACHE_ASSOCIATIVITY, HWLOC_ATTR_CACHE_LINESIZE, HWLOC_ATTR_LOCAL_MEMORY, HWLOC_ATTR_COUNT };
+static constexpr std::string_view hwlocAttrNames[] = { "type", "os_index", "gp_index", "cache_size", "depth", "cache_associativity", "cache_linesize", "local_memory" };
+static constexpr HwlocKeywordTable hwlocAttrs(hwlocAttrNames);
+static_assert(hwlocAttrs.perfect, "hwlocKeywordHash collides on the object attributes");
+
+//same as createChildC(string, xmlNode*), from the attribute values collected by the streaming parser (attribs[HWLOC_ATTR_*]; 0 if not present)
+static Component* createChildC(int type, const long long* attribs)
+{
+    switch(type)
+    {
+    case HWLOC_TYPE_MACHINE:
+        return (Component*)new Node();
+    case HWLOC_TYPE_PACKAGE:
+        return (Component*)new Chip((int)attribs[HWLOC_ATTR_OS_INDEX], "socket", SYS_SAGE_CHIP_TYPE_CPU_SOCKET);
+    case HWLOC_TYPE_CACHE:
+    case HWLOC_TYPE_L3CACHE:
+    case HWLOC_TYPE_L2CACHE:
+    case HWLOC_TYPE_L1CACHE:
+        return (Component*)new Cache((int)attribs[HWLOC_ATTR_GP_INDEX], (int)attribs[HWLOC_ATTR_DEPTH], attribs[HWLOC_ATTR_CACHE_SIZE], (int)attribs[HWLOC_ATTR_CACHE_ASSOCIATIVITY], (int)attribs[HWLOC_ATTR_CACHE_LINESIZE]);
+    case HWLOC_TYPE_NUMANODE:
+        return (Component*)new Numa((int)attribs[HWLOC_ATTR_OS_INDEX], attribs[HWLOC_ATTR_LOCAL_MEMORY]);
+    case HWLOC_TYPE_CORE:
+        return (Component*)new Core((int)attribs[HWLOC_ATTR_OS_INDEX]);
+    case HWLOC_TYPE_PU:
+        return (Component*)new Thread((int)attribs[HWLOC_ATTR_OS_INDEX], "HW_thread");
+    default:
+        return new Component();
+    }
+}
+
+//parses a hwloc output in one pass with xmlTextReader and adds it to topology
+int parseHwlocOutput(Node* n, string topoPath, TopologyArena* arena)
+{
+    //the streaming parser only knows the built-in lists; modified lists are honored by the DOM parser
+    if(xmlRelevantNames != defaultXmlRelevantNames || xmlRelevantObjectTypes != defaultXmlRelevantObjectTypes)
+        return parseHwlocOutputDOM(n, topoPath, arena);
+    TopologyArena::Scope arenaScope(arena);
+    //blank text nodes are dropped by the reader instead of being reported (and skipped) here
+    xmlTextReaderPtr reader = xmlReaderForFile(topoPath.c_str(), NULL, XML_PARSE_NOBLANKS);
+    if (reader == NULL) {
+        cerr << "error: could not parse file " << topoPath.c_str() << endl;
+        return 1;
+    }
+
+    //the components are built below a detached root and only attached to n once the whole file has been parsed
+    Node* root = new Node(n->GetId(), n->GetName());
+    //context[d] = the component the children of the open element at depth d are added to
+    vector<Component*> context;
+    int ret = xmlTextReaderRead(reader);
+    while(ret == 1)
+    {
+        if(xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+        {
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+        int depth = xmlTextReaderDepth(reader);
+        if(depth == 0)
+        {//root element -- its children are added to n
+            context.assign(1, root);
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+        Component* c = context[depth - 1];
+        int element = hwlocElements.Find((const char*)xmlTextReaderConstLocalName(reader));
+        if(element == HWLOC_ELEMENT_INFO)
+        {
+            if(c->GetComponentType() == SYS_SAGE_COMPONENT_CHIP)
+            {
+                xmlChar* name = xmlTextReaderGetAttribute(reader, (const xmlChar*)"name");
+                if(name != NULL && (xmlStrEqual(name, (const xmlChar*)"CPUVendor") || xmlStrEqual(name, (const xmlChar*)"CPUModel")))
+                {
+                    xmlChar* value = xmlTextReaderGetAttribute(reader, (const xmlChar*)"value");
+                    string val = value == NULL ? "" : (const char*)value;
+                    if(xmlStrEqual(name, (const xmlChar*)"CPUVendor"))
+                        ((Chip*)c)->SetVendor(val);
+                    else
+                        ((Chip*)c)->SetModel(val);
+                    xmlFree(value);
+                }
+                xmlFree(name);
+            }
+            ret = xmlTextReaderNext(reader);
+        }
+        else if(element == HWLOC_ELEMENT_OBJECT || element == HWLOC_ELEMENT_TOPOLOGY)
+        {
+            int type = -1;
+            long long attribs[HWLOC_ATTR_COUNT] = {};
+            while(xmlTextReaderMoveToNextAttribute(reader) == 1)
+            {
+                int attr = hwlocAttrs.Find((const char*)xmlTextReaderConstLocalName(reader));
+                if(attr == HWLOC_ATTR_TYPE)
+                    type = hwlocTypes.Find((const char*)xmlTextReaderConstValue(reader));
+                else if(attr >= 0)
+                    attribs[attr] = strtoll((const char*)xmlTextReaderConstValue(reader), NULL, 10);
+            }
+            xmlTextReaderMoveToElement(reader);
+
+            //if relevant object, it will be inserted in the topology
+            Component* childC = c;
+            if(type >= 0 && type != HWLOC_TYPE_MACHINE) //node is already existing param
+            {
+                childC = createChildC(type, attribs);
+                insertChildC(c, childC);
+            }
+            if(!xmlTextReaderIsEmptyElement(reader))
+            {
+                context.resize(depth + 1);
+                context[depth] = childC;
+            }
+            ret = xmlTextReaderRead(reader);
+        }
+        else
+        {//other elements and their subtrees are skipped
+            ret = xmlTextReaderNext(reader);
+        }
+    }
+    xmlFreeTextReader(reader);
+    if(ret != 0){
+        std::cerr << "parseHwlocOutput: error while parsing file " << topoPath << std::endl;
+        root->Delete(true);
+        return 1;
+    }
+    vector<Component*> parsed = *root->GetChildren();
+    for(Component* child : parsed)
+    {
+        root->RemoveChild(child);
+        n->InsertChild(child);
+    }
+    root->Delete(false);
+
+    int err = removeUnknownCompoents(n);
+    if(err != 0){
+        std::cerr << "parseHwlocOutput on file " << topoPath << " failed on removeUnknownCompoents BUT WILL CONTINUE" << std::endl;
+    }
+    err = n->CheckComponentTreeConsistency();
+    return err;
+}
@@ -8,15 +8,24 @@
 #include <libxml/tree.h>
 
 #include "Topology.hpp"
+#include "TopologyArena.hpp"
 
 /*! \file */
 /**
 Parser function for importing hwloc XML output to sys-sage.
-\n The parser looks for the XML object names defined in xmlRelevantNames, and considers (i.e. parses) the XML object types as defined in xmlRelevantObjectTypes.
+\n The file is parsed in one streaming pass (libxml2 xmlTextReader) that creates the components as the XML objects are read, i.e. the XML document is never held in memory as a whole. The XML object names and types are those listed in xmlRelevantNames and xmlRelevantObjectTypes (the streaming parser dispatches on built-in tables equal to the default lists; if the lists were modified, parseHwlocOutputDOM() is used instead).
 @param n - Pointer to an already existing Node where the hwloc topology will get parsed.
 @param topoPath - Path to the XML output of hwloc that should be parsed and uploaded to sys-sage.
+@param arena - (optional) TopologyArena to allocate the parsed components in. If NULL (default), the components are allocated on the heap (or in the arena of an already active TopologyArena::Scope).
+@return 0 on success
+*/
+int parseHwlocOutput(Node* n, std::string topoPath, TopologyArena* arena = NULL);
+/**
+Parser function for importing hwloc XML output to sys-sage, which loads the whole XML document (libxml2 DOM) and then walks it. Produces the same Component Tree as parseHwlocOutput(), which is faster and uses less memory.
+\n The parser looks for the XML object names defined in xmlRelevantNames, and considers (i.e. parses) the XML object types as defined in xmlRelevantObjectTypes.
+@see parseHwlocOutput()
 */
-int parseHwlocOutput(Node* n, std::string topoPath);
+int parseHwlocOutputDOM(Node* n, std::string topoPath, TopologyArena* arena = NULL);
 /// @private
 int xmlProcessChildren(Component* c, xmlNode* parent, int level);
 /// @private
@@ -25,7 +34,7 @@ Component* createChildC(std::string type, xmlNode* node);
 std::string xmlGetPropStr(xmlNode* node, std::string key);
 
 /**
-Defines parsed XML object names: "topology", "object"
+Defines parsed XML object names: "topology", "object", "info"
 */
 extern std::vector<std::string> xmlRelevantNames;
 /**
@@ -1,5 +1,8 @@
 #include "shared_mem.hpp"
 
+#include <algorithm>
+#include <set>
+
 SharedMemory::SharedMemory(std::string path, size_t size)
     : size(size), path(path) {
   mem = create_shared_memory(path, size);
@@ -15,12 +18,29 @@ SharedMemory::SharedMemory(std::string path) {
   }
 }
 
-size_t attrib_memory_size(std::map<std::string, void *> *attribs,
+// Exported attrib layout: key\0 | type (size_t) | size (size_t) | data
+// type is SYS_SAGE_ATTRIB_TYPE_NONE for attribs packed by the user-provided pack
+// function, otherwise the type of the AttribTypeDescriptor that serialized it.
+size_t attrib_export_size(const AttribStore::Entry &e,
+                          CopyAttrib (*pack)(std::pair<std::string, void *>)) {
+  const AttribTypeDescriptor *d = AttribRegistry::GetDescriptor(e);
+  if (d != nullptr && d->size != nullptr && d->serialize != nullptr) {
+    return e.name->size() + 1 + 2 * sizeof(size_t) + d->size(e.GetData());
+  }
+  if (e.GetType() == SYS_SAGE_ATTRIB_TYPE_VOIDPTR) {
+    CopyAttrib attrib = pack({*e.name, e.GetData()});
+    if (attrib.size != 0) {
+      return attrib.getTotalSize();
+    }
+  }
+  return 0;
+}
+
+size_t attrib_memory_size(AttribStore *attribs,
                           CopyAttrib (*pack)(std::pair<std::string, void *>)) {
   size_t size = 0;
-  for (const auto &a : *attribs) {
-    auto [key, size_attrib, ptr] = pack(a);
-    size += size_attrib + key.size() + sizeof(size_t);
+  for (const auto &e : attribs->GetEntries()) {
+    size += attrib_export_size(e, pack);
   }
   return size;
 }
@@ -46,129 +66,69 @@ size_t size_attribs_recursive(
   return size;
 }
 
+// Exported DataPathMatrix layout: dp_type | oriented | N | number of metrics
+// (size_t each) | N component offsets (~0 for components that are not
+// exported) | metric names (\0-terminated) | values (double, see GetData())
+size_t datapath_matrix_export_size(DataPathMatrix *m) {
+  size_t n = m->GetSize();
+  size_t size = (4 + n) * sizeof(size_t);
+  for (const std::string &metric : m->GetMetrics()) {
+    size += metric.size() + 1;
+  }
+  return size + m->GetMetrics().size() * n * n * sizeof(double);
+}
+
 size_t calc_memory_size(Component *tree,
                         CopyAttrib (*pack)(std::pair<std::string, void *>)) {
   unsigned a, b;
   size_t min_size = tree->GetTopologySize(&a, &b);
   min_size += size_attribs_recursive(tree, pack);
 
-  size_t tmp = (min_size + PAGE_SIZE - 1) & -PAGE_SIZE;
-
-  return tmp;
-}
-
-std::tuple<size_t, std::string, void *> recreate_attrib(void *src) {
-  char *cur = (char *)src;
-
-  // Create key
-  std::string key(cur);
-  cur += key.size() + 1;
-
-  // Read size of data
-  size_t size = *(size_t *)cur;
-  cur += sizeof(size_t);
-
-  // Create Value
-  void *val = malloc(size);
-  if (!val) {
-    return {0, "", nullptr};
+  std::vector<Component *> components;
+  std::set<DataPathMatrix *> matrices;
+  tree->GetSubtreeNodeList(&components);
+  for (Component *c : components) {
+    matrices.insert(c->GetDataPathMatrices().begin(),
+                    c->GetDataPathMatrices().end());
   }
-
-  memcpy(val, cur, size);
-
-  size_t total_size = key.size() + 1 + sizeof(size_t) + size;
-  return {total_size, key, val};
-}
-
-CopyAttrib pack_default(std::pair<std::string, void *> attrib) {
-  std::string key = attrib.first;
-  void *value = attrib.second;
-
-  if (!key.compare("CATcos") || !key.compare("CATL3mask")) {
-    return {key, sizeof(uint64_t), value};
-  }
-
-  if (!key.compare("mig_size")) {
-    return {key, sizeof(long long), value};
-  }
-
-  if (!key.compare("Number_of_streaming_multiprocessors") ||
-      !key.compare("Number_of_cores_in_GPU") ||
-      !key.compare("Number_of_cores_per_SM") || !key.compare("Bus_Width_bit")) {
-    return {key, sizeof(int), value};
-  }
-
-  if (!key.compare("Clock_Frequency")) {
-    return {key, sizeof(double), value};
-  }
-
-  if (!key.compare("latency") || !key.compare("latency_max") ||
-      !key.compare("latency_min")) {
-    return {key, sizeof(float), value};
-  }
-
-  if (!key.compare("CUDA_compute_capability") || !key.compare("mig_uuid")) {
-    std::string *val = (std::string *)value;
-    return {key, val->size() + 1, (void *)(val->c_str())};
-  }
-
-  if (!key.compare("freq_history")) {
-    std::vector<std::tuple<long long, double>> *val =
-        (std::vector<std::tuple<long long, double>> *)value;
-
-    return {key, val->size() * sizeof(std::tuple<long long, double>),
-            val->data()};
-  }
-
-  if (!key.compare("GPU_Clock_Rate")) {
-    return {key, sizeof(std::tuple<double, std::string>), value};
+  min_size += sizeof(size_t);
+  for (DataPathMatrix *m : matrices) {
+    min_size += datapath_matrix_export_size(m);
   }
 
-  return {key, 0, nullptr};
-}
-
-std::pair<std::string, void *> unpack_default(
-    size_t size, std::pair<std::string, void *> attrib) {
-  std::string key = attrib.first;
-  void *value = attrib.second;
-
-  if (!key.compare("CUDA_compute_capability") || !key.compare("mig_uuid")) {
-    std::string *str = new std::string((char *)value);
-    free(value);
-    return {key, str};
-  }
-
-  if (!key.compare("freq_history")) {
-    char *end = (char *)value + size;
-
-    std::vector<std::tuple<long long, double>> *vec =
-        new std::vector<std::tuple<long long, double>>(
-            (std::tuple<long long, double> *)value,
-            (std::tuple<long long, double> *)end);
-
-    free(value);
-    return {key, vec};
-  }
+  size_t tmp = (min_size + PAGE_SIZE - 1) & -PAGE_SIZE;
 
-  return {key, value};
+  return tmp;
 }
 
 void export_attribs(SharedMemory *manager,
                     CopyAttrib (*pack)(std::pair<std::string, void *>),
-                    std::map<std::string, void *> *attribs) {
+                    AttribStore *attribs) {
   size_t *num_attribs = (size_t *)manager->cur;
   *num_attribs = 0;
   manager->cur += sizeof(size_t);
 
-  CopyAttrib attrib;
-
-  for (auto const &a : *attribs) {
-    if (attrib = pack_default(a); attrib.size != 0) {
-      (*num_attribs)++;
-      manager->cur += attrib.copy(manager->cur);
-    } else if (attrib = pack(a); attrib.size != 0) {
+  for (const auto &e : attribs->GetEntries()) {
+    const AttribTypeDescriptor *d = AttribRegistry::GetDescriptor(e);
+    if (d != nullptr && d->size != nullptr && d->serialize != nullptr) {
+      size_t type = d->type;
+      size_t size = d->size(e.GetData());
+
+      strcpy(manager->cur, e.name->c_str());
+      manager->cur += e.name->size() + 1;
+      memcpy(manager->cur, &type, sizeof(size_t));
+      manager->cur += sizeof(size_t);
+      memcpy(manager->cur, &size, sizeof(size_t));
+      manager->cur += sizeof(size_t);
+      d->serialize(e.GetData(), manager->cur);
+      manager->cur += size;
       (*num_attribs)++;
-      manager->cur += attrib.copy(manager->cur);
+    } else if (e.GetType() == SYS_SAGE_ATTRIB_TYPE_VOIDPTR) {
+      CopyAttrib attrib = pack({*e.name, e.GetData()});
+      if (attrib.size != 0) {
+        (*num_attribs)++;
+        manager->cur += attrib.copy(manager->cur);
+      }
     }
   }
 }
@@ -226,6 +186,14 @@ size_t export_recursive(SharedMemory *manager, Component *component,
   // Get own offset
   auto self_offset = (size_t)manager->cur - (size_t)manager->mem;
 
+  manager->exported_comps[component] = self_offset;
+  for (DataPathMatrix *m : component->GetDataPathMatrices()) {
+    if (std::find(manager->dp_matrices.begin(), manager->dp_matrices.end(),
+                  m) == manager->dp_matrices.end()) {
+      manager->dp_matrices.push_back(m);
+    }
+  }
+
   // Copy Class and initialize Component
   memcpy(manager->cur, (void *)component, size_comp);
   Component *c = (Component *)manager->cur;
@@ -305,6 +273,40 @@ void export_datapaths(SharedMemory *manager,
   }
 }
 
+void export_datapath_matrices(SharedMemory *manager) {
+  size_t *num_matrices = (size_t *)(manager->cur);
+  *num_matrices = manager->dp_matrices.size();
+  manager->cur += sizeof(size_t);
+
+  for (DataPathMatrix *m : manager->dp_matrices) {
+    size_t n = m->GetSize();
+    size_t *header = (size_t *)(manager->cur);
+    *(header++) = m->GetDpType();
+    *(header++) = m->GetOriented();
+    *(header++) = n;
+    *(header++) = m->GetMetrics().size();
+
+    // ----- Write component offsets -----
+    for (size_t i = 0; i < n; i++) {
+      Component *c = m->GetComponent(i);
+      auto search = c == NULL ? manager->exported_comps.end()
+                              : manager->exported_comps.find(c);
+      *(header++) = search == manager->exported_comps.end() ? ~(size_t)0
+                                                            : search->second;
+    }
+    manager->cur = (char *)header;
+
+    // ----- Write metric names and values -----
+    for (const std::string &metric : m->GetMetrics()) {
+      strcpy(manager->cur, metric.c_str());
+      manager->cur += metric.size() + 1;
+    }
+    size_t values = m->GetMetrics().size() * n * n * sizeof(double);
+    memcpy(manager->cur, m->GetData(), values);
+    manager->cur += values;
+  }
+}
+
 SharedMemory *export_topology(
     std::string path, Component *component,
     CopyAttrib (*pack)(std::pair<std::string, void *>)) {
@@ -319,6 +321,7 @@ SharedMemory *export_topology(
   //----- Export -----
   export_recursive(manager, component, pack);
   export_datapaths(manager, pack);
+  export_datapath_matrices(manager);
   return manager;
 }
 
@@ -330,20 +333,39 @@ SharedMemory *export_topology(std::string path, Component *component) {
 }
 
 void import_attribs(SharedMemory *manager,
-                    std::map<std::string, void *> *attribs,
+                    AttribStore *attribs,
                     std::pair<std::string, void *> (*unpack)(
                         size_t size, std::pair<std::string, void *>)) {
   size_t num_attribs = *(size_t *)manager->cur;
   manager->cur += sizeof(size_t);
 
   for (size_t i = 0; i < num_attribs; i++) {
-    const auto [total_size, key, value] = recreate_attrib(manager->cur);
-    size_t size_attrib = total_size - (key.size() + 1 + sizeof(size_t));
-
-    attribs->insert(
-        unpack(size_attrib, unpack_default(size_attrib, {key, value})));
+    std::string key(manager->cur);
+    manager->cur += key.size() + 1;
+    size_t type, size;
+    memcpy(&type, manager->cur, sizeof(size_t));
+    manager->cur += sizeof(size_t);
+    memcpy(&size, manager->cur, sizeof(size_t));
+    manager->cur += sizeof(size_t);
 
-    manager->cur += total_size;
+    if (type == SYS_SAGE_ATTRIB_TYPE_NONE) {
+      // packed by the user -- hand a copy of the data to the unpack function
+      void *value = malloc(size);
+      if (value) {
+        memcpy(value, manager->cur, size);
+        attribs->insert(unpack(size, {key, value}));
+      }
+    } else {
+      AttribKey attribKey(key);
+      const AttribTypeDescriptor *d =
+          type == SYS_SAGE_ATTRIB_TYPE_VOIDPTR
+              ? AttribRegistry::GetKeyDescriptor(attribKey.GetId())
+              : AttribRegistry::GetTypeDescriptor(type);
+      if (d != nullptr && d->deserialize != nullptr) {
+        d->deserialize(attribs, attribKey, manager->cur, size);
+      }
+    }
+    manager->cur += size;
   }
 }
 
@@ -372,6 +394,47 @@ void import_datapaths(SharedMemory *manager,
   }
 }
 
+void import_datapath_matrices(SharedMemory *manager) {
+  size_t num_matrices = *(size_t *)manager->cur;
+  manager->cur += sizeof(size_t);
+
+  for (size_t k = 0; k < num_matrices; k++) {
+    size_t *header = (size_t *)manager->cur;
+    int dp_type = *(header++);
+    int oriented = *(header++);
+    size_t n = *(header++);
+    size_t num_metrics = *(header++);
+
+    // ----- Translate component offsets -----
+    std::vector<Component *> components(n, NULL);
+    for (size_t i = 0; i < n; i++, header++) {
+      if (auto search = manager->comp_offsets.find(*header);
+          search != manager->comp_offsets.end()) {
+        components[i] = search->second;
+      }
+    }
+    manager->cur = (char *)header;
+
+    std::vector<std::string> metrics;
+    for (size_t i = 0; i < num_metrics; i++) {
+      metrics.emplace_back(manager->cur);
+      manager->cur += metrics.back().size() + 1;
+    }
+
+    // ----- Import DataPathMatrix -----
+    size_t values = num_metrics * n * n * sizeof(double);
+    DataPathMatrix *m =
+        new DataPathMatrix(components, dp_type, metrics, oriented);
+    memcpy(m->GetData(), manager->cur, values);
+    manager->cur += values;
+    // a matrix without any imported component is not referenced by anything
+    if (std::all_of(components.begin(), components.end(),
+                    [](Component *c) { return c == NULL; })) {
+      m->DeleteDataPathMatrix();
+    }
+  }
+}
+
 Component *import_recursive(SharedMemory *manager,
                             std::pair<std::string, void *> (*unpack)(
                                 size_t size, std::pair<std::string, void *>)) {
@@ -476,6 +539,7 @@ Component *import_topology(std::string path,
   // ----- Import -----
   Component *component = import_recursive(shmem, unpack);
   import_datapaths(shmem, unpack);
+  import_datapath_matrices(shmem);
 
   delete shmem;
   return component;
@@ -17,6 +17,8 @@
 #include <cstring>
 
 #include "Topology.hpp"
+#include "DataPathMatrix.hpp"
+#include "AttribRegistry.hpp"
 
 #define PAGE_SIZE 4096
 
@@ -43,7 +45,7 @@ struct CopyAttrib {
    *
    * @return size_t Total size
    */
-  size_t getTotalSize() { return key.size() + 1 + sizeof(size_t) + size; }
+  size_t getTotalSize() { return key.size() + 1 + 2 * sizeof(size_t) + size; }
 
   /**
    * @brief Copies the CopyAttrib to the provided pointer.
@@ -58,6 +60,11 @@ struct CopyAttrib {
     strcpy((char*)cur, key.c_str());
     cur += key.size() + 1;
 
+    // Copy type (user-packed)
+    size_t type = SYS_SAGE_ATTRIB_TYPE_NONE;
+    memcpy(cur, &type, sizeof(size_t));
+    cur += sizeof(size_t);
+
     // Copy size
     memcpy(cur, &size, sizeof(size_t));
     cur += sizeof(size_t);
@@ -76,6 +83,8 @@ class SharedMemory {
   size_t size;
   std::map<DataPath*, std::pair<size_t, size_t>> dp_offsets;
   std::map<size_t, Component*> comp_offsets;
+  std::map<Component*, size_t> exported_comps;
+  std::vector<DataPathMatrix*> dp_matrices;
 
   std::string GetPath() { return path; }
 
@@ -2,8 +2,20 @@
 #define SYS_SAGE
 
 //includes all other headers
+#include "AttribStore.hpp"
+#include "AttribTimeSeries.hpp"
+#include "AttribRegistry.hpp"
+#include "CpuSet.hpp"
 #include "Topology.hpp"
 #include "DataPath.hpp"
+#include "DataPathGraph.hpp"
+#include "DataPathMatrix.hpp"
+#include "DistanceMatrix.hpp"
+#include "FrozenTopology.hpp"
+#include "TopologyView.hpp"
+#include "TopologyDiff.hpp"
+#include "ComponentQuery.hpp"
+#include "TopologyArena.hpp"
 #include "xml_dump.hpp"
 #include "parsers/hwloc.hpp"
 #include "parsers/caps-numa-benchmark.hpp"
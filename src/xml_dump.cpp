@@ -1,5 +1,7 @@
 #include <sstream>
 #include <cstdint>
+#include <charconv>
+#include <cmath>
 
 #include "xml_dump.hpp"
 #include <libxml/parser.h>
@@ -7,118 +9,68 @@
 std::function<int(string,void*,string*)> search_custom_attrib_key_fcn = NULL;
 std::function<int(string,void*,xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL;
 
-//methods for printing out default attributes, i.e. those 
+//methods for printing out default attributes, i.e. those registered in AttribRegistry
 //for a specific key, return the value as a string to be printed in the xml
 int search_default_attrib_key(string key, void* value, string* ret_value_str)
 {
-    //value: uint64_t 
-    if(!key.compare("CATcos") || 
-    !key.compare("CATL3mask") )
-    {
-        *ret_value_str=std::to_string(*(uint64_t*)value);
-        return 1;
-    }
-    //value: long long
-    else if(!key.compare("mig_size") )
-    {
-        *ret_value_str=std::to_string(*(long long*)value);
-        return 1;
-    }
-    //value: int
-    else if(!key.compare("Number_of_streaming_multiprocessors") || 
-    !key.compare("Number_of_cores_in_GPU") || 
-    !key.compare("Number_of_cores_per_SM")  || 
-    !key.compare("Bus_Width_bit") )
-    {
-        *ret_value_str=std::to_string(*(int*)value);
-        return 1;
-    }
-    //value: double
-    else if(!key.compare("Clock_Frequency") )
-    {
-        *ret_value_str=std::to_string(*(double*)value);
-        return 1;
-    }
-    //value: float
-    else if(!key.compare("latency") ||
-    !key.compare("latency_min") ||
-    !key.compare("latency_max") )
-    {
-        *ret_value_str=std::to_string(*(float*)value);
-        return 1;
-    }   
-    //value: string
-    else if(!key.compare("CUDA_compute_capability") || 
-    !key.compare("mig_uuid") )
-    {
-        *ret_value_str=*(string*)value;
-        return 1;
-    }
-
-    return 0;
+    unsigned int keyId;
+    if(!AttribKey::Find(key, &keyId))
+        return 0;
+    const AttribTypeDescriptor* d = AttribRegistry::GetKeyDescriptor(keyId);
+    if(d == NULL || d->toXml != NULL)
+        return 0;
+    *ret_value_str = d->toString(value);
+    return 1;
 }
 
 int search_default_complex_attrib_key(string key, void* value, xmlNodePtr n)
 {
-    //value: std::vector<std::tuple<long long,double>>*
-    if(!key.compare("freq_history"))
-    {
-        std::vector<std::tuple<long long,double>>* val = (std::vector<std::tuple<long long,double>>*)value;
-
-        xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-        xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-        xmlAddChild(n, attrib_node);
-        for(auto [ ts,freq ] : *val)
-        {
-            xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-            xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(ts).c_str());
-            xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-            xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)"MHz");
-            xmlAddChild(attrib_node, attrib);
-        }
-        return 1;
-    }
-    //value: std::tuple<double, std::string>
-    else if(!key.compare("GPU_Clock_Rate"))
-    {
-        xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-        xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-        xmlAddChild(n, attrib_node);
-
-        auto [ freq, unit ] = *(std::tuple<double, std::string>*)value;
-        xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-        xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-        xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)unit.c_str());
-        xmlAddChild(attrib_node, attrib);
-        return 1;
-    }
-
-    return 0;
+    unsigned int keyId;
+    if(!AttribKey::Find(key, &keyId))
+        return 0;
+    const AttribTypeDescriptor* d = AttribRegistry::GetKeyDescriptor(keyId);
+    if(d == NULL || d->toXml == NULL)
+        return 0;
+    d->toXml(key, value, n);
+    return 1;
 }
 
-int print_attrib(map<string,void*> attrib, xmlNodePtr n)
+int print_attrib(AttribStore& attrib, xmlNodePtr n)
 {
     string attrib_value;
-    for (auto const& [key, val] : attrib){
+    for (const AttribStore::Entry& e : attrib.GetEntries()){
+        const string& key = *e.name;
+        void* val = e.GetData();
         int ret = 0;
-        if(search_custom_attrib_key_fcn != NULL)
-            ret=search_custom_attrib_key_fcn(key,val,&attrib_value);
-        if(ret==0)
-            ret = search_default_attrib_key(key,val,&attrib_value);
+        //untyped values of unregistered keys may be handled by the custom functions passed to exportToXml
+        if(e.GetType() == SYS_SAGE_ATTRIB_TYPE_VOIDPTR && (search_custom_attrib_key_fcn != NULL || search_custom_complex_attrib_key_fcn != NULL))
+        {
+            if(search_custom_attrib_key_fcn != NULL)
+                ret=search_custom_attrib_key_fcn(key,val,&attrib_value);
+            if(ret==1)//attrib found
+            {
+                xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
+                xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
+                xmlNewProp(attrib_node, (const unsigned char *)"value", (const unsigned char *)attrib_value.c_str());
+                xmlAddChild(n, attrib_node);
+                continue;
+            }
+            if(search_custom_complex_attrib_key_fcn != NULL && search_custom_complex_attrib_key_fcn(key,val,n) == 1)
+                continue;
+        }
 
-        if(ret==1)//attrib found
+        const AttribTypeDescriptor* d = AttribRegistry::GetDescriptor(e);
+        if(d == NULL)
+            continue;
+        if(d->toXml != NULL)
         {
-            xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-            xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-            xmlNewProp(attrib_node, (const unsigned char *)"value", (const unsigned char *)attrib_value.c_str());
-            xmlAddChild(n, attrib_node);
+            d->toXml(key, val, n);
             continue;
         }
-
-        if(ret == 0 && search_custom_complex_attrib_key_fcn != NULL) //try looking in search_custom_complex_attrib_key
-            ret=search_custom_complex_attrib_key_fcn(key,val,n);
-        if(ret==0)
-            ret = search_default_complex_attrib_key(key,val,n);
+        xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
+        xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
+        xmlNewProp(attrib_node, (const unsigned char *)"value", (const unsigned char *)d->toString(val).c_str());
+        xmlAddChild(n, attrib_node);
     }
 
     return 1;
@@ -225,6 +177,47 @@ xmlNodePtr Component::CreateXmlSubtree()
     return n;
 }
 
+xmlNodePtr CreateDataPathMatrixXml(DataPathMatrix* m)
+{
+    xmlNodePtr n = xmlNewNode(NULL, BAD_CAST "datapath-matrix");
+    xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(m->GetSize())).c_str());
+    xmlNewProp(n, (const unsigned char *)"oriented", (const unsigned char *)(std::to_string(m->GetOriented())).c_str());
+    xmlNewProp(n, (const unsigned char *)"dp_type", (const unsigned char *)(std::to_string(m->GetDpType())).c_str());
+    for(int i = 0; i < m->GetSize(); i++)
+    {
+        if(m->GetComponent(i) == NULL)
+            continue;
+        xmlNodePtr c_n = xmlNewNode(NULL, BAD_CAST "component");
+        std::ostringstream addr;
+        addr << m->GetComponent(i);
+        xmlNewProp(c_n, (const unsigned char *)"index", (const unsigned char *)(std::to_string(i)).c_str());
+        xmlNewProp(c_n, (const unsigned char *)"addr", (const unsigned char *)(addr.str().c_str()));
+        xmlAddChild(n, c_n);
+    }
+
+    size_t block = (size_t)m->GetSize() * m->GetSize();
+    for(size_t metric = 0; metric < m->GetMetrics().size(); metric++)
+    {
+        const double* values = m->GetData() + metric * block;
+        string text;
+        char buf[32];
+        for(size_t k = 0; k < block; k++)
+        {
+            if(k > 0)
+                text.push_back(' ');
+            if(std::isnan(values[k]))
+                text.append("NaN");
+            else
+                text.append(buf, std::to_chars(buf, buf + sizeof(buf), values[k]).ptr);
+        }
+        xmlNodePtr metric_n = xmlNewNode(NULL, BAD_CAST "metric");
+        xmlNewProp(metric_n, (const unsigned char *)"name", (const unsigned char *)m->GetMetrics()[metric].c_str());
+        xmlNodeAddContent(metric_n, (const unsigned char *)text.c_str());
+        xmlAddChild(n, metric_n);
+    }
+    return n;
+}
+
 int exportToXml(Component* root, string path, std::function<int(string,void*,string*)> _search_custom_attrib_key_fcn, std::function<int(string,void*,xmlNodePtr)> _search_custom_complex_attrib_key_fcn)
 {
     search_custom_attrib_key_fcn=_search_custom_attrib_key_fcn;
@@ -277,6 +270,24 @@ int exportToXml(Component* root, string path, std::function<int(string,void*,str
         }
     }
 
+    //DataPathMatrices are printed once, with the values of each metric as a whitespace-separated list (row-major)
+    vector<DataPathMatrix*> matrices;
+    for(Component* cPtr : components)
+    {
+        for(DataPathMatrix* m : cPtr->GetDataPathMatrices())
+        {
+            if(std::find(matrices.begin(), matrices.end(), m) == matrices.end())
+                matrices.push_back(m);
+        }
+    }
+    if(!matrices.empty())
+    {
+        xmlNodePtr matrices_root = xmlNewNode(NULL, BAD_CAST "datapath-matrices");
+        xmlAddChild(sys_sage_root, matrices_root);
+        for(DataPathMatrix* m : matrices)
+            xmlAddChild(matrices_root, CreateDataPathMatrixXml(m));
+    }
+
     xmlSaveFormatFileEnc(path=="" ? "-" : path.c_str(), doc, "UTF-8", 1);
 
     xmlFreeDoc(doc);
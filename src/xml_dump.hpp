@@ -5,9 +5,12 @@
 
 #include "Topology.hpp"
 #include "DataPath.hpp"
+#include "DataPathMatrix.hpp"
+#include "AttribRegistry.hpp"
 
 int exportToXml(Component *root, string path = "", std::function<int(string, void *, string *)> search_custom_attrib_key_fcn = NULL, std::function<int(string, void *, xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL);
 int search_default_attrib_key(string key, void *value, string *ret_value_str);
 
-int print_attrib(map<string, void *> attrib, xmlNodePtr n);
+int print_attrib(AttribStore& attrib, xmlNodePtr n);
+xmlNodePtr CreateDataPathMatrixXml(DataPathMatrix* m);
 #endif
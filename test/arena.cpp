@@ -0,0 +1,76 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+#include <memory>
+
+using namespace boost::ut;
+
+static suite<"arena"> _ = []
+{
+    "Components and DataPaths are placed in the current arena"_test = []
+    {
+        auto arena = std::make_unique<TopologyArena>(1024);
+        expect(that % nullptr == TopologyArena::GetCurrent());
+        {
+            TopologyArena::Scope scope{arena.get()};
+            expect(that % arena.get() == TopologyArena::GetCurrent());
+
+            auto topo = new Topology();
+            auto node = new Node(topo, 0);
+            auto core0 = new Core(node, 0);
+            auto core1 = new Core(node, 1);
+            new DataPath(core0, core1, SYS_SAGE_DATAPATH_ORIENTED);
+            expect(that % 5 == arena->GetNumObjects());
+            expect(that % arena->GetReservedBytes() >= 1024);
+
+            core1->Delete(true);
+            expect(that % 3 == arena->GetNumObjects());
+            expect(that % 1 == node->GetChildren()->size());
+            expect(that % 0 == core0->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        }
+        expect(that % nullptr == TopologyArena::GetCurrent());
+
+        auto heapCore = new Core();
+        delete heapCore;
+        expect(that % 3 == arena->GetNumObjects());
+    };
+
+    "Nested scopes restore the previous arena"_test = []
+    {
+        TopologyArena outer, inner;
+        TopologyArena::Scope outerScope{&outer};
+        {
+            TopologyArena::Scope innerScope{&inner};
+            expect(that % &inner == TopologyArena::GetCurrent());
+            TopologyArena::Scope nullScope{nullptr};
+            expect(that % &inner == TopologyArena::GetCurrent());
+        }
+        expect(that % &outer == TopologyArena::GetCurrent());
+    };
+
+    "Parse hwloc into an arena"_test = []
+    {
+        Topology heapTopo;
+        Node heapNode{&heapTopo};
+        expect(that % (0 == parseHwlocOutput(&heapNode, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        std::vector<Component*> heapComponents;
+        heapTopo.GetSubtreeNodeList(&heapComponents);
+        heapNode.DeleteSubtree();
+
+        TopologyArena arena;
+        Topology* topo;
+        {
+            TopologyArena::Scope scope{&arena};
+            topo = new Topology();
+            new Node(topo);
+        }
+        Node* node = (Node*)topo->GetChild(0);
+        expect(that % (0 == parseHwlocOutput(node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml", &arena)) >> fatal);
+        expect(that % nullptr == TopologyArena::GetCurrent());
+        std::vector<Component*> components;
+        topo->GetSubtreeNodeList(&components);
+        expect(that % heapComponents.size() == components.size());
+        expect(that % components.size() == arena.GetNumObjects());
+    };
+};
@@ -0,0 +1,247 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+#include <filesystem>
+#include <thread>
+#include <cmath>
+
+#include <libxml/parser.h>
+#include <libxml/xpath.h>
+
+using namespace boost::ut;
+
+static suite<"attrib"> _ = []
+{
+    "Typed values"_test = []
+    {
+        AttribStore attrib;
+        expect(that % 42 == *attrib.Set("int", 42));
+        attrib.Set<long long>("long long", 1ll << 40);
+        attrib.Set<uint64_t>("uint64", 7);
+        attrib.Set("double", 2.5);
+        attrib.Set("float", 1.5f);
+        attrib.Set("string", "foo");
+        attrib.Set("freq_history", AttribFreqHistory{{1, 2.0}, {3, 4.0}});
+        attrib.Set("clock", AttribValueUnit{1.4, "GHz"});
+
+        expect(that % 8 == attrib.size());
+        expect(that % 42 == *attrib.Get<int>("int"));
+        expect(that % (1ll << 40) == *attrib.Get<long long>("long long"));
+        expect(that % 7 == *attrib.Get<uint64_t>("uint64"));
+        expect(that % 2.5 == *attrib.Get<double>("double"));
+        expect(that % 1.5f == *attrib.Get<float>("float"));
+        expect(that % "foo"sv == *attrib.Get<std::string>("string"));
+        expect(that % 2 == attrib.Get<AttribFreqHistory>("freq_history")->size());
+        expect(that % "GHz"sv == std::get<1>(*attrib.Get<AttribValueUnit>("clock")));
+
+        expect(that % nullptr == attrib.Get<double>("int"));
+        expect(that % nullptr == attrib.Get<int>("missing"));
+        expect(that % SYS_SAGE_ATTRIB_TYPE_FLOAT == attrib.GetType("float"));
+        expect(that % SYS_SAGE_ATTRIB_TYPE_NONE == attrib.GetType("missing"));
+
+        attrib.Set("int", 2.0);
+        expect(that % nullptr == attrib.Get<int>("int"));
+        expect(that % 2.0 == *attrib.Get<double>("int"));
+        expect(that % 1 == attrib.Remove("int"));
+        expect(that % 0 == attrib.Remove("int"));
+        expect(that % 7 == attrib.size());
+
+        AttribStore copy = attrib;
+        *copy.Get<std::string>("string") = "bar";
+        expect(that % "foo"sv == *attrib.Get<std::string>("string"));
+        expect(that % "bar"sv == *copy.Get<std::string>("string"));
+    };
+
+    "Lookups do not intern keys"_test = []
+    {
+        AttribStore attrib;
+        attrib.Set("set_key", 1);
+        unsigned int id;
+        expect(that % !AttribKey::Find("lookup_only_key", &id));
+        expect(that % nullptr == attrib.Get<int>("lookup_only_key"));
+        expect(that % nullptr == attrib.Get<int>(std::string("lookup_only_key")));
+        expect(that % SYS_SAGE_ATTRIB_TYPE_NONE == attrib.GetType("lookup_only_key"));
+        expect(that % 0 == attrib.Remove("lookup_only_key"));
+        expect(that % 0 == attrib.count("lookup_only_key"));
+        expect(that % !AttribKey::Find("lookup_only_key", &id));
+
+        static const AttribKey set_key("set_key");
+        expect(that % AttribKey::Find("set_key", &id));
+        expect(that % set_key.GetId() == id);
+        expect(that % 1 == *attrib.Get<int>(set_key));
+        expect(that % 1 == *attrib.Get<int>("set_key"));
+    };
+
+    "Map-like interface"_test = []
+    {
+        Component c;
+        int a = 1, b = 2;
+        c.attrib["b"] = &b;
+        expect(that % c.attrib.insert({"a", (void *)&a}).second);
+        expect(that % !c.attrib.insert({"a", (void *)&b}).second);
+        c.attrib.Set("c", 3);
+
+        expect(that % 1 == *(int *)c.attrib["a"]);
+        expect(that % 2 == *(int *)c.attrib["b"]);
+        expect(that % 3 == *(int *)c.attrib["c"]);
+        expect(that % SYS_SAGE_ATTRIB_TYPE_VOIDPTR == c.attrib.GetType("a"));
+        expect(that % 1 == c.attrib.count("a"));
+        expect(that % 0 == c.attrib.count("never_used_key"));
+        expect(that % (c.attrib.find("never_used_key") == c.attrib.end()));
+        expect(that % (void *)&b == c.attrib.find("b")->second);
+
+        std::vector<std::string> keys;
+        for (const auto &[key, value] : c.attrib)
+            keys.push_back(key);
+        expect(that % std::vector<std::string>{"a", "b", "c"} == keys);
+
+        expect(that % 1 == c.attrib.erase("b"));
+        expect(that % 0 == c.attrib.erase("b"));
+        expect(that % 2 == c.attrib.size());
+    };
+    "Registry"_test = []
+    {
+        int rack = 15;
+        Component c;
+        c.attrib["registry_rack_no"] = (void *)&rack;
+        c.attrib.Set("registry_double", 2.5);
+        c.attrib.Set("registry_string", "foo");
+        c.attrib.Set("registry_clock", AttribValueUnit{1.4, "GHz"});
+
+        auto entry = [&](const std::string &key) -> const AttribStore::Entry & { return c.attrib.find(key).GetEntry(); };
+        expect(that % (AttribRegistry::GetDescriptor(entry("registry_rack_no")) == nullptr));
+        expect(that % 0 == AttribRegistry::RegisterKey("registry_rack_no", SYS_SAGE_ATTRIB_TYPE_INT));
+        expect(that % 1 == AttribRegistry::RegisterKey("registry_rack_no", SYS_SAGE_ATTRIB_TYPE_VOIDPTR));
+        const AttribTypeDescriptor *d = AttribRegistry::GetDescriptor(entry("registry_rack_no"));
+        expect(that % (d != nullptr) >> fatal);
+        expect(that % "15"sv == d->toString(entry("registry_rack_no").GetData()));
+        expect(that % "foo"sv == AttribRegistry::GetDescriptor(entry("registry_string"))->toString(entry("registry_string").GetData()));
+        expect(that % (AttribRegistry::GetTypeDescriptor(SYS_SAGE_ATTRIB_TYPE_NONE) == nullptr));
+        expect(that % (AttribRegistry::GetTypeDescriptor(SYS_SAGE_ATTRIB_TYPE_VOIDPTR) == nullptr));
+
+        //typed and registered attributes survive the shared memory export/import
+        std::string path = std::filesystem::temp_directory_path() / "sys-sage-test-attrib-registry";
+        SharedMemory *shm = export_topology(path, &c);
+        expect(that % (shm != nullptr) >> fatal);
+        Component *imported = import_topology(path);
+        expect(that % (imported != nullptr) >> fatal);
+        expect(that % 15 == *imported->attrib.Get<int>("registry_rack_no"));
+        expect(that % 2.5 == *imported->attrib.Get<double>("registry_double"));
+        expect(that % "foo"sv == *imported->attrib.Get<std::string>("registry_string"));
+        expect(that % "GHz"sv == std::get<1>(*imported->attrib.Get<AttribValueUnit>("registry_clock")));
+        delete shm;
+        std::filesystem::remove(path);
+    };
+
+    "Time series"_test = []
+    {
+        AttribTimeSeries ts(4);
+        expect(that % 4 == ts.GetCapacity());
+        expect(std::isnan(ts.GetMean()));
+        AttribTimeSeries::Sample last;
+        expect(!ts.GetLast(&last));
+        for(int i = 1; i <= 6; i++)
+            ts.Append(i, 10.0 * i);
+        //the ring buffer keeps the last 4 samples
+        expect(that % 4 == ts.GetSize());
+        expect(that % 6 == ts.GetCount());
+        std::vector<AttribTimeSeries::Sample> samples;
+        expect(that % 4 == ts.GetSamples(&samples));
+        expect(that % 3 == samples.front().timestamp);
+        expect(that % 60.0 == samples.back().value);
+        expect(ts.GetLast(&last));
+        expect(that % 6 == last.timestamp);
+        expect(that % 30.0 == ts.GetMin());
+        expect(that % 60.0 == ts.GetMax());
+        expect(that % 45.0 == ts.GetMean());
+        expect(that % 40.0 == ts.GetPercentile(50));
+        expect(that % 60.0 == ts.GetPercentile(100));
+        expect(that % 30.0 == ts.GetPercentile(0));
+        //time windows
+        expect(that % 50.0 == ts.GetMax(0, 5));
+        expect(that % 45.0 == ts.GetMean(4, 5));
+        expect(std::isnan(ts.GetMin(7)));
+
+        AttribTimeSeries copy = ts;
+        copy.Append(7, 0.0);
+        expect(that % 0.0 == copy.GetMin());
+        expect(that % 30.0 == ts.GetMin());
+
+        Component c;
+        c.attrib.Set("ts_metric", 1);
+        AttribTimeSeries* stored = c.attrib.AppendSample("ts_metric", 1, 2.0, 8);
+        expect(that % stored == c.attrib.AppendSample("ts_metric", 2, 3.0));
+        expect(that % 8 == stored->GetCapacity());
+        expect(that % 2 == stored->GetSize());
+        expect(that % SYS_SAGE_ATTRIB_TYPE_TIME_SERIES == c.attrib.GetType("ts_metric"));
+        expect(that % "(1,2.000000)(2,3.000000)"sv == AttribRegistry::GetDescriptor(c.attrib.find("ts_metric").GetEntry())->toString(stored));
+
+        //XML export
+        std::string xml = std::filesystem::temp_directory_path() / "sys-sage-test-attrib-time-series.xml";
+        exportToXml(&c, xml);
+        xmlDocPtr doc = xmlParseFile(xml.c_str());
+        expect(that % (doc != NULL) >> fatal);
+        xmlXPathContextPtr ctx = xmlXPathNewContext(doc);
+        xmlXPathObjectPtr res = xmlXPathEvalExpression(BAD_CAST "sum(//Attribute[@name='ts_metric' and @capacity='8']/ts_metric/@value)", ctx);
+        expect(that % 5.0 == res->floatval);
+        xmlXPathFreeObject(res);
+        xmlXPathFreeContext(ctx);
+        xmlFreeDoc(doc);
+        std::filesystem::remove(xml);
+
+        //shared memory export/import
+        std::string path = std::filesystem::temp_directory_path() / "sys-sage-test-attrib-time-series";
+        SharedMemory *shm = export_topology(path, &c);
+        expect(that % (shm != nullptr) >> fatal);
+        Component *imported = import_topology(path);
+        expect(that % (imported != nullptr) >> fatal);
+        AttribTimeSeries* imported_ts = imported->attrib.Get<AttribTimeSeries>("ts_metric");
+        expect(that % (imported_ts != nullptr) >> fatal);
+        expect(that % 8 == imported_ts->GetCapacity());
+        expect(that % 2 == imported_ts->GetSize());
+        expect(that % 2.5 == imported_ts->GetMean());
+        delete shm;
+        std::filesystem::remove(path);
+
+        //the serialized size does not depend on the samples appended between size() and serialize()
+        const AttribTypeDescriptor* d = AttribRegistry::GetTypeDescriptor(SYS_SAGE_ATTRIB_TYPE_TIME_SERIES);
+        AttribTimeSeries small(4);
+        small.Append(1, 1.0);
+        std::vector<char> buf(d->size(&small));
+        small.Append(2, 2.0);
+        small.Append(3, 6.0);
+        d->serialize(&small, buf.data());
+        Component roundtrip;
+        d->deserialize(&roundtrip.attrib, AttribKey("ts_metric"), buf.data(), buf.size());
+        expect(that % 3 == roundtrip.attrib.Get<AttribTimeSeries>("ts_metric")->GetSize());
+        expect(that % 3.0 == roundtrip.attrib.Get<AttribTimeSeries>("ts_metric")->GetMean());
+    };
+
+    "Time series with a concurrent writer"_test = []
+    {
+        AttribTimeSeries ts(64);
+        const long long n = 200000;
+        std::thread writer([&]{
+            for(long long i = 0; i < n; i++)
+                ts.Append(i, (double)i);
+        });
+        //every snapshot consists of consecutive, consistent samples
+        bool consistent = true;
+        std::vector<AttribTimeSeries::Sample> samples;
+        while(ts.GetCount() < (unsigned long long)n)
+        {
+            samples.clear();
+            ts.GetSamples(&samples);
+            for(size_t i = 0; i < samples.size(); i++)
+                consistent = consistent && samples[i].value == (double)samples[i].timestamp && (i == 0 || samples[i].timestamp == samples[i-1].timestamp + 1);
+            AttribTimeSeries::Sample last;
+            if(ts.GetLast(&last))
+                consistent = consistent && last.value == (double)last.timestamp;
+        }
+        writer.join();
+        expect(consistent);
+        expect(that % 64 == ts.GetSize());
+        expect(that % (double)(n - 1) == ts.GetMax());
+    };
+};
@@ -0,0 +1,97 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace std::literals;
+
+static suite<"cpuset"> _ = []
+{
+    "Set operations"_test = []
+    {
+        CpuSet a{{0, 1, 2, 3, 70}};
+        CpuSet b{{2, 3, 4}};
+
+        expect(that % 5 == a.Count());
+        expect(a.IsSet(70));
+        expect(not a.IsSet(64));
+        expect(that % "0-3,70"sv == a.ToString());
+        expect(that % 0 == a.First());
+        expect(that % 70 == a.Next(3));
+        expect(that % -1 == a.Next(70));
+
+        expect(that % "2-3"sv == (a & b).ToString());
+        expect(that % "0-4,70"sv == (a | b).ToString());
+        CpuSet c = a;
+        c.AndNot(b);
+        expect(that % "0-1,70"sv == c.ToString());
+        expect(a.Intersects(b));
+        expect(not c.Intersects(b));
+        expect(c.IsSubsetOf(a));
+        expect(not a.IsSubsetOf(b));
+
+        //sets of different length compare as padded with zeros
+        CpuSet d{{70}};
+        d.Clear(70);
+        d.Set(1);
+        expect(d == CpuSet{{1}});
+        expect(CpuSet().IsEmpty());
+        expect(that % -1 == CpuSet().First());
+        expect(that % std::vector<int>{0, 1, 2, 3, 70} == a.GetIds());
+    };
+
+    "Parse the list format"_test = []
+    {
+        CpuSet s;
+        expect(that % 0 == s.Parse(" 0-3,8,10-11\n"));
+        expect(that % "0-3,8,10-11"sv == s.ToString());
+        expect(that % 0 == s.Parse("65535"));
+        expect(that % 1 == s.Count());
+        //malformed lists leave the set empty instead of throwing or allocating huge masks
+        expect(that % 1 == s.Parse("99999999999"));
+        expect(s.IsEmpty());
+        expect(that % 1 == s.Parse("5-2"));
+        expect(that % 1 == s.Parse("0-2147483647"));
+        expect(that % 1 == s.Parse("65536"));
+        expect(that % 1 == s.Parse("1,,2"));
+        expect(that % 1 == s.Parse("-1"));
+        expect(s.IsEmpty());
+    };
+
+    "Component cpusets"_test = []
+    {
+        Topology topo;
+        Chip socket{&topo, 0};
+        Cache l3{&socket, 0, 3};
+        Cache l2a{&l3, 0, 2};
+        Core core0{&l2a, 0};
+        Thread t0{&core0, 0};
+        Thread t1{&core0, 1};
+        Cache l2b{&l3, 1, 2};
+        Core core1{&l2b, 1};
+        Thread t2{&core1, 2};
+        Numa numa{&socket, 0};
+
+        expect(that % "0-2"sv == topo.GetCpuSet().ToString());
+        expect(that % "0-1"sv == l2a.GetCpuSet().ToString());
+        expect(that % "2"sv == t2.GetCpuSet().ToString());
+        expect(numa.GetCpuSet().IsEmpty());
+
+        expect(that % &core0 == topo.FindSmallestComponentCovering(CpuSet{{0, 1}}));
+        expect(that % &t1 == topo.FindSmallestComponentCovering(CpuSet{{1}}));
+        expect(that % &l3 == topo.FindSmallestComponentCovering(CpuSet{{1, 2}}));
+        expect(that % &l2a == topo.FindSmallestComponentCovering(CpuSet{{1}}, SYS_SAGE_COMPONENT_CACHE));
+        expect(that % &socket == topo.FindSmallestComponentCovering(CpuSet{{1, 2}}, SYS_SAGE_COMPONENT_CHIP));
+        expect(topo.FindSmallestComponentCovering(CpuSet{{7}}) == nullptr);
+        expect(topo.FindSmallestComponentCovering(CpuSet()) == nullptr);
+
+        //tree edits invalidate the cached sets of the ancestors
+        Thread t3{&core1, 3};
+        expect(that % "0-3"sv == topo.GetCpuSet().ToString());
+        expect(that % "2-3"sv == l2b.GetCpuSet().ToString());
+        l3.RemoveChild(&l2a);
+        expect(that % "2-3"sv == topo.GetCpuSet().ToString());
+        expect(that % "0-1"sv == l2a.GetCpuSet().ToString());
+        core1.RemoveChild(&t3);
+    };
+};
@@ -0,0 +1,111 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"datapath-graph"> _ = []
+{
+    "CSR snapshot"_test = []
+    {
+        Topology* t = new Topology();
+        Node* node = new Node(t, 0);
+        Chip* socket = new Chip(node, 0);
+        Core* c0 = new Core(socket, 0);
+        Core* c1 = new Core(socket, 1);
+        Core* c2 = new Core(socket, 2);
+        Memory* mem = new Memory(node);
+        Component outside;
+        new DataPath(c0, c1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 10.0, 20.0);
+        new DataPath(c1, c2, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_C2C, 5.0, 30.0);
+        new DataPath(c0, mem, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 100.0, 80.0);
+        new DataPath(c2, c2, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_C2C, 1.0, 1.0);
+        new DataPath(c0, &outside, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C);
+
+        DataPathGraph g{t};
+        expect(that % 7 == g.GetNumVertices());
+        expect(that % 5 == g.GetNumEdges());
+        expect(that % t == g.GetComponent(0));
+        expect(that % -1 == g.GetIndex(&outside));
+        int v0 = g.GetIndex(c0), v1 = g.GetIndex(c1), v2 = g.GetIndex(c2), vm = g.GetIndex(mem);
+        expect(that % std::vector<int>{v1, vm} == std::vector<int>(g.GetNeighbors(v0).begin(), g.GetNeighbors(v0).end()));
+        expect(that % std::vector<int>{v2} == std::vector<int>(g.GetNeighbors(v1).begin(), g.GetNeighbors(v1).end()));
+        expect(that % std::vector<int>{v1, v2} == std::vector<int>(g.GetNeighbors(v2).begin(), g.GetNeighbors(v2).end()));
+        int e = g.GetRowOffsets()[v0];
+        expect(that % 10.0 == g.GetBandwidths()[e]);
+        expect(that % 20.0 == g.GetLatencies()[e]);
+        expect(that % c1 == g.GetEdgeDataPaths()[e]->GetTarget());
+
+        DataPathGraph c2c{t, SYS_SAGE_DATAPATH_TYPE_C2C};
+        expect(that % 4 == c2c.GetNumEdges());
+        expect(c2c.IsUpToDate());
+
+        //only the rows of the changed components are recomputed
+        DataPath* added = new DataPath(c1, c0, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 7.0, 7.0);
+        expect(not c2c.IsUpToDate());
+        expect(that % 2 == c2c.Update());
+        expect(that % 5 == c2c.GetNumEdges());
+        expect(that % v0 == c2c.GetTargets()[c2c.GetRowOffsets()[v1 + 1] - 1]);
+        expect(that % 0 == c2c.Update());
+        added->DeleteDataPath();
+        expect(that % 2 == c2c.Update());
+        expect(that % 4 == c2c.GetNumEdges());
+
+        //structural changes rebuild the snapshot
+        Core* c3 = new Core(socket, 3);
+        new DataPath(c3, c0, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C);
+        expect(that % 8 == c2c.Update());
+        expect(that % 5 == c2c.GetNumEdges());
+        expect(that % c2c.GetIndex(c0) == c2c.GetNeighbors(c2c.GetIndex(c3))[0]);
+
+        outside.DeleteAllDataPaths();
+        t->Delete(true);
+    };
+
+    "Routing"_test = []
+    {
+        Component root;
+        Component a{&root, 0}, b{&root, 1}, c{&root, 2}, d{&root, 3};
+        DataPath* bd = new DataPath(&b, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 2.0, 1.0);
+        new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 10.0, 1.0);
+        new DataPath(&a, &c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 8.0, 2.0);
+        new DataPath(&c, &d, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 8.0, 2.0);
+        new DataPath(&a, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 100.0, 10.0);
+        new DataPath(&a, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_LOGICAL, 1000.0, 0.0);
+        DataPathGraph g{&root, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+
+        DataPathGraph::Route r;
+        expect(that % 0 == g.GetRoute(&a, &d, SYS_SAGE_ROUTE_MIN_LATENCY, &r));
+        expect(that % std::vector<Component *>{&a, &b, &d} == r.components);
+        expect(that % 2.0 == r.latency);
+        expect(that % 2.0 == r.bw);
+        expect(that % bd == r.dataPaths[1]);
+
+        expect(that % 0 == g.GetRoute(&a, &d, SYS_SAGE_ROUTE_MAX_BANDWIDTH, &r));
+        expect(that % std::vector<Component *>{&a, &d} == r.components);
+        expect(that % 100.0 == r.bw);
+
+        expect(that % 0 == g.GetRoute(&d, &c, SYS_SAGE_ROUTE_MIN_LATENCY, &r));
+        expect(that % 1 == g.GetRoute(&d, &a, SYS_SAGE_ROUTE_MIN_LATENCY, &r));
+        expect(that % 0 == g.GetRoute(&a, &a, SYS_SAGE_ROUTE_MIN_LATENCY, &r));
+        expect(r.dataPaths.empty());
+
+        std::vector<DataPathGraph::Route> routes;
+        expect(that % 3 == g.GetKShortestRoutes(&a, &d, 5, &routes));
+        expect(that % 2.0 == routes[0].latency);
+        expect(that % std::vector<Component *>{&a, &c, &d} == routes[1].components);
+        expect(that % 10.0 == routes[2].latency);
+        routes.clear();
+        expect(that % 2 == g.GetKShortestRoutes(&a, &d, 2, &routes));
+
+        //the cached routes are dropped when DataPaths change
+        bd->DeleteDataPath();
+        expect(that % 0 == g.GetRoute(&a, &d, SYS_SAGE_ROUTE_MIN_LATENCY, &r));
+        expect(that % 4.0 == r.latency);
+        routes.clear();
+        expect(that % 2 == g.GetKShortestRoutes(&a, &d, 5, &routes));
+
+        for(Component* comp : {&a, &b, &c, &d})
+            comp->DeleteAllDataPaths();
+    };
+};
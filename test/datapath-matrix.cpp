@@ -0,0 +1,183 @@
+#include <boost/ut.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include <libxml/parser.h>
+#include <libxml/xpath.h>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"datapath-matrix"> _ = []
+{
+    "Dense relation"_test = []
+    {
+        Topology* topo = new Topology();
+        Core* c0 = new Core(topo, 0);
+        Core* c1 = new Core(topo, 1);
+        Core* c2 = new Core(topo, 2);
+        Memory* mem = new Memory(topo);
+
+        DataPathMatrix* m = new DataPathMatrix({c0, c1, c2}, SYS_SAGE_DATAPATH_TYPE_C2C, {"latency", "bw"});
+        expect(that % 3 == m->GetSize());
+        expect(that % 1 == m->GetIndex(c1));
+        expect(that % -1 == m->GetIndex(mem));
+        expect(that % 1 == m->GetMetricIndex("bw"));
+        expect(that % -1 == m->GetMetricIndex("latency_min"));
+        expect(that % m == c0->GetDataPathMatrix(SYS_SAGE_DATAPATH_TYPE_C2C));
+        expect(that % (DataPathMatrix*)NULL == c0->GetDataPathMatrix(SYS_SAGE_DATAPATH_TYPE_PHYSICAL));
+        expect(that % (DataPathMatrix*)NULL == mem->GetDataPathMatrix(SYS_SAGE_DATAPATH_TYPE_C2C));
+
+        expect(that % 0 == m->Set(c0, c1, "latency", 40.0));
+        expect(that % 0 == m->Set(c0, c1, "bw", 8.0));
+        expect(that % 1 == m->Set(c0, mem, "latency", 1.0));
+        expect(that % 1 == m->Set(c0, c1, "unknown", 1.0));
+        m->Set(2, 0, 0, 55.0);
+        expect(that % 40.0 == m->GetLatency(c0, c1));
+        expect(that % 8.0 == m->GetBw(c0, c1));
+        expect(that % 55.0 == m->Get(c2, c0, "latency"));
+        //oriented: the reverse direction is not set
+        expect(that % -1.0 == m->GetLatency(c1, c0));
+        expect(std::isnan(m->Get(c1, c0, "latency")));
+        expect(std::isnan(m->Get(c0, mem, "latency")));
+        expect(that % 55.0 == m->GetData()[2 * 3 + 0]);
+        expect(that % 8.0 == m->GetData()[9 + 0 * 3 + 1]);
+
+        MatrixDataPath dp;
+        expect(that % 1 == m->GetDataPath(c0, mem, &dp));
+        expect(that % (DataPathMatrix*)NULL == dp.GetMatrix());
+        expect(that % 0 == m->GetDataPath(c0, c1, &dp));
+        expect(that % c0 == dp.GetSource());
+        expect(that % c1 == dp.GetTarget());
+        expect(that % 40.0 == dp.GetLatency());
+        expect(that % 8.0 == dp.GetBw());
+        expect(that % SYS_SAGE_DATAPATH_TYPE_C2C == dp.GetDpType());
+        expect(that % SYS_SAGE_DATAPATH_ORIENTED == dp.GetOriented());
+        expect(std::isnan(dp.GetMetric("latency_max")));
+
+        DataPathMatrix* bidir = new DataPathMatrix({c0, c1}, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, {"bw"}, SYS_SAGE_DATAPATH_BIDIRECTIONAL);
+        bidir->Set(c1, c0, "bw", 3.0);
+        expect(that % 3.0 == bidir->GetBw(c0, c1));
+        expect(that % 2 == c0->GetDataPathMatrices().size());
+        bidir->DeleteDataPathMatrix();
+        expect(that % 1 == c0->GetDataPathMatrices().size());
+
+        //deleting a component clears its row and column
+        c0->Delete();
+        expect(that % (Component*)NULL == m->GetComponent(0));
+        expect(that % -1 == m->GetIndex(c0));
+        expect(std::isnan(m->Get(2, 0, 0)));
+        expect(that % 1 == c1->GetDataPathMatrices().size());
+        //the matrix deletes itself with its last component
+        c1->DeleteAllDataPaths();
+        expect(that % 0 == c1->GetDataPathMatrices().size());
+        expect(that % 1 == c2->GetDataPathMatrices().size());
+        c2->DeleteAllDataPaths();
+        expect(that % 0 == c2->GetDataPathMatrices().size());
+        topo->Delete(true);
+    };
+
+    "cccbench output"_test = []
+    {
+        std::string csv = std::filesystem::temp_directory_path() / "sys-sage-test-cccbench.csv";
+        {
+            std::ofstream f(csv);
+            f << "xcore,ycore,xylat" << std::endl;
+            for(int x = 0; x < 3; x++)
+                for(int y = 0; y < 3; y++)
+                    for(int rep = 0; rep < 2; rep++)
+                        f << x << "," << y << "," << (10 * x + y + rep) << std::endl;
+        }
+        Topology* topo = new Topology();
+        Node* node = new Node(topo, 0);
+        for(int i = 0; i < 3; i++)
+            new Core(node, i);
+        expect(that % (0 == parseCccbenchOutput(node, csv, NULL, SYS_SAGE_CCCBENCH_MATRIX)) >> fatal);
+        std::filesystem::remove(csv);
+
+        Core* c0 = (Core*)node->GetChild(0);
+        Core* c2 = (Core*)node->GetChild(2);
+        DataPathMatrix* m = c0->GetDataPathMatrix(SYS_SAGE_DATAPATH_TYPE_C2C);
+        expect(that % (m != NULL) >> fatal);
+        expect(that % 0 == c0->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(that % 2.5 == m->GetLatency(c0, c2));
+        expect(that % 2.0 == m->Get(c0, c2, "latency_min"));
+        expect(that % 3.0 == m->Get(c0, c2, "latency_max"));
+        expect(that % 20.5 == m->GetLatency(c2, c0));
+        expect(std::isnan(m->Get(c2, c2, "latency")));
+
+        //XML export
+        std::string xml = std::filesystem::temp_directory_path() / "sys-sage-test-datapath-matrix.xml";
+        exportToXml(topo, xml);
+        xmlDocPtr doc = xmlParseFile(xml.c_str());
+        expect(that % (doc != NULL) >> fatal);
+        xmlXPathContextPtr ctx = xmlXPathNewContext(doc);
+        xmlXPathObjectPtr res = xmlXPathEvalExpression(BAD_CAST "string(/sys-sage/datapath-matrices/datapath-matrix/metric[@name='latency_max'])", ctx);
+        expect(that % std::string("NaN 2 3 11 NaN 13 21 22 NaN") == std::string((const char*)res->stringval));
+        xmlXPathFreeObject(res);
+        res = xmlXPathEvalExpression(BAD_CAST "count(/sys-sage/datapath-matrices/datapath-matrix/component)", ctx);
+        expect(that % 3.0 == res->floatval);
+        xmlXPathFreeObject(res);
+        xmlXPathFreeContext(ctx);
+        xmlFreeDoc(doc);
+        std::filesystem::remove(xml);
+
+        //shared memory export/import
+        std::string path = std::filesystem::temp_directory_path() / "sys-sage-test-datapath-matrix";
+        SharedMemory* shm = export_topology(path, topo);
+        expect(that % (shm != nullptr) >> fatal);
+        Component* imported = import_topology(path);
+        expect(that % (imported != nullptr) >> fatal);
+        Component* i0 = imported->GetChild(0)->GetChild(0);
+        Component* i2 = imported->GetChild(0)->GetChild(2);
+        DataPathMatrix* im = i0->GetDataPathMatrix(SYS_SAGE_DATAPATH_TYPE_C2C);
+        expect(that % (im != NULL && im != m) >> fatal);
+        expect(that % 3 == im->GetSize());
+        expect(that % 2.5 == im->GetLatency(i0, i2));
+        expect(that % 21.0 == im->Get(i2, i0, "latency_max"));
+        expect(that % SYS_SAGE_DATAPATH_ORIENTED == im->GetOriented());
+        delete shm;
+        std::filesystem::remove(path);
+        imported->Delete(true);
+        topo->Delete(true);
+    };
+
+    "cccbench output as DataPaths"_test = []
+    {
+        std::string csv = std::filesystem::temp_directory_path() / "sys-sage-test-cccbench-dp.csv";
+        {
+            std::ofstream f(csv);
+            f << "xcore,ycore,xylat" << std::endl;
+            for(int x = 0; x < 3; x++)
+                for(int y = 0; y < 3; y++)
+                    f << x << "," << y << "," << (10 * x + y) << std::endl;
+        }
+        Topology* topo = new Topology();
+        Node* node = new Node(topo, 0);
+        for(int i = 0; i < 3; i++)
+            new Core(node, i);
+        expect(that % (0 == parseCccbenchOutput(node, csv, NULL, SYS_SAGE_CCCBENCH_DATAPATHS | SYS_SAGE_CCCBENCH_MATRIX)) >> fatal);
+        std::filesystem::remove(csv);
+
+        Core* c0 = (Core*)node->GetChild(0);
+        Core* c2 = (Core*)node->GetChild(2);
+        expect(that % (c0->GetDataPathMatrix(SYS_SAGE_DATAPATH_TYPE_C2C) != NULL));
+        expect(that % 2 == c0->GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_OUTGOING).size());
+        DataPath* dp = FindDataPath(c0, c2, SYS_SAGE_DATAPATH_TYPE_C2C);
+        expect(that % (dp != NULL) >> fatal);
+        expect(that % 2.0 == dp->GetLatency());
+        expect(that % 2.0f == *dp->attrib.Get<float>("latency_max"));
+
+        //the DataPaths are seen by the routing and distance queries
+        DataPathGraph graph(node, SYS_SAGE_DATAPATH_TYPE_C2C);
+        DataPathGraph::Route route;
+        expect(that % (0 == graph.GetRoute(c2, c0, SYS_SAGE_ROUTE_MIN_LATENCY, &route)) >> fatal);
+        expect(that % 20.0 == route.latency);
+        DistanceMatrix* distances = BuildDistanceMatrix(node, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DISTANCE_LATENCY);
+        expect(that % 12.0 == distances->Get(node->GetChild(1), c2));
+        delete distances;
+        topo->Delete(true);
+    };
+};
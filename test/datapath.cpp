@@ -133,4 +133,101 @@ static suite<"data-path"> _ = []
             expect(that % std::vector{&dp2, &dp3, &dp4} == v);
         };
     };
+
+    "Data paths grouped by type"_test = []
+    {
+        Component a, b;
+        DataPath* dp1 = new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+        DataPath* dp2 = new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        DataPath* dp3 = new DataPath(&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+
+        expect(that % std::vector{dp1, dp3} == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % std::vector{dp2} == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % std::vector{dp3} == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_INCOMING));
+        expect(that % std::vector{dp1, dp3} == b.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_INCOMING));
+        expect(a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_LOGICAL, SYS_SAGE_DATAPATH_OUTGOING).empty());
+        expect(a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_INCOMING | SYS_SAGE_DATAPATH_OUTGOING).empty());
+
+        dp1->DeleteDataPath();
+        expect(that % std::vector{dp3} == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % dp3 == a.GetDpByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_OUTGOING));
+        //the last DataPath takes the position of the deleted one
+        expect(that % std::vector{dp3, dp2} == *a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING));
+        a.DeleteAllDataPaths();
+        expect(a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING).empty());
+        expect(b.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_INCOMING).empty());
+        expect(b.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->empty());
+    };
+
+    "Delete data paths"_test = []
+    {
+        Component root;
+        Component a{&root, 0}, b{&root, 1};
+        std::vector<DataPath *> cat;
+        for(int i = 0; i < 10; i++)
+        {
+            new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+            cat.push_back(new DataPath(&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT));
+        }
+        DataPath* loop = new DataPath(&a, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        expect(that % 22 == a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+
+        cat[3]->DeleteDataPath();
+        cat[0]->DeleteDataPath();
+        loop->DeleteDataPath();
+        expect(that % 18 == a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(that % 8 == a.GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        expect(that % 8 == b.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING).size());
+        for(DataPath* dp : *a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING))
+            expect(dp != cat[0] && dp != cat[3] && dp != loop);
+
+        expect(that % 8 == root.DeleteDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, true));
+        expect(that % 10 == a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(a.GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->empty());
+        expect(b.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->empty());
+        expect(that % 10 == b.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % 0 == a.DeleteDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT));
+        a.DeleteAllDataPaths();
+        expect(b.GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->empty());
+    };
+
+    "Upsert data paths"_test = []
+    {
+        Component root;
+        Component a{&root, 0}, b{&root, 1};
+        bool created = false;
+        DataPath* dp = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT, &created);
+        expect(created);
+        //bidirectional DataPaths are found from either end
+        expect(that % dp == UpsertDataPath(&b, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT, &created));
+        expect(!created);
+        expect(that % (DataPath*)NULL == FindDataPath(&a, &b, SYS_SAGE_DATAPATH_TYPE_MIG));
+
+        DataPath* mig0 = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, "mig_uuid", "MIG-0");
+        DataPath* mig1 = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, "mig_uuid", std::string("MIG-1"), &created);
+        expect(created);
+        expect(mig0 != mig1);
+        expect(that % mig0 == UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG, "mig_uuid", std::string("MIG-0"), &created));
+        expect(!created);
+        //oriented DataPaths are only found from their source
+        expect(that % (DataPath*)NULL == FindDataPath(&b, &a, SYS_SAGE_DATAPATH_TYPE_MIG));
+        expect(that % 2 == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 3 == a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+
+        //in-place updates count as DataPath changes
+        unsigned long long versionA = a.GetDataPathChangeVersion(), versionB = b.GetDataPathChangeVersion();
+        mig1->SetBw(10.0);
+        mig1->SetLatency(2.5);
+        expect(that % 10.0 == mig1->GetBw());
+        expect(that % 2.5 == mig1->GetLatency());
+        expect(a.GetDataPathChangeVersion() > versionA);
+        expect(b.GetDataPathChangeVersion() > versionB);
+
+        //re-setting a typed attribute reuses its storage
+        std::string* uuid = mig1->attrib.Get<std::string>("mig_uuid");
+        mig1->attrib.Set("mig_uuid", std::string("MIG-2"));
+        expect(that % uuid == mig1->attrib.Get<std::string>("mig_uuid"));
+        expect(that % std::string("MIG-2") == *uuid);
+        a.DeleteAllDataPaths();
+    };
 };
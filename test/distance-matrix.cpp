@@ -0,0 +1,109 @@
+#include <boost/ut.hpp>
+#include <cmath>
+#include <cstdint>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"distance-matrix"> _ = []
+{
+    "Matrix of caps-numa-benchmark data"_test = []
+    {
+        Topology topo;
+        Node node{&topo};
+        expect(that % (0 == parseHwlocOutput(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        expect(that % (0 == parseCapsNumaBenchmark(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv")) >> fatal);
+
+        DistanceMatrix* m = BuildDistanceMatrix(&topo, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, SYS_SAGE_DISTANCE_LATENCY);
+        expect(that % 4 == m->GetNumRows());
+        expect(that % 4 == m->GetNumCols());
+        expect(that % 8 == m->GetStride());
+        expect(that % 0 == (reinterpret_cast<uintptr_t>(m->GetRow(1)) % 64));
+        for(int i = 0; i < m->GetNumRows(); i++)
+        {
+            for(DataPath* dp : *m->GetRowComponent(i)->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING))
+                expect(that % dp->GetLatency() == m->Get(dp->GetSource(), dp->GetTarget()));
+            int closest = m->RowArgMin(i);
+            for(int j = 0; j < m->GetNumCols(); j++)
+                expect(m->Get(i, closest) <= m->Get(i, j));
+        }
+        delete m;
+    };
+
+    "Row scans over several cache lines"_test = []
+    {
+        Topology* topo = new Topology();
+        Thread* t0 = new Thread(topo, 0);
+        Thread* t1 = new Thread(topo, 1);
+        std::vector<Numa*> numas;
+        for(int j = 0; j < 19; j++)
+            numas.push_back(new Numa(topo, j));
+        //t0: missing entries in between, the minimum in the last (padded) cache line, the maximum twice; t1: only a single value in the second cache line
+        const double latencies[19] = {70, -1, 50, 90, 60, -1, 80, 55, 65, 90, 75, -1, 85, 95, 52, 66, 95, 40, -1};
+        for(int j = 0; j < 19; j++)
+            new DataPath(t0, numas[j], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 1.0, latencies[j]);
+        new DataPath(t1, numas[9], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 1.0, 30.0);
+
+        DistanceMatrix lat{topo, SYS_SAGE_COMPONENT_THREAD, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, SYS_SAGE_DISTANCE_LATENCY};
+        expect(that % 24 == lat.GetStride());
+        expect(that % 17 == lat.RowArgMin(0));
+        expect(that % 13 == lat.RowArgMax(0));
+        expect(that % 9 == lat.RowArgMin(1));
+        expect(that % 9 == lat.RowArgMax(1));
+        topo->Delete(true);
+    };
+
+    "Missing entries and refresh"_test = []
+    {
+        Topology* topo = new Topology();
+        Thread* t0 = new Thread(topo, 0);
+        Thread* t1 = new Thread(topo, 1);
+        Numa* n0 = new Numa(topo, 0);
+        Numa* n1 = new Numa(topo, 1);
+        Numa* n2 = new Numa(topo, 2);
+        new DataPath(t0, n0, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 10.0, 100.0);
+        new DataPath(t0, n1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 20.0, 50.0);
+        new DataPath(n2, t0, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 5.0, 200.0);
+        new DataPath(t0, n1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 99.0, 1.0);
+        new DataPath(n0, t1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 1.0, 1.0);
+
+        DistanceMatrix lat{topo, SYS_SAGE_COMPONENT_THREAD, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, SYS_SAGE_DISTANCE_LATENCY};
+        DistanceMatrix bw{topo, SYS_SAGE_COMPONENT_THREAD, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, SYS_SAGE_DISTANCE_BW};
+        expect(that % 2 == lat.GetNumRows());
+        expect(that % 3 == lat.GetNumCols());
+        expect(that % 8 == lat.GetStride());
+        expect(that % 0 == (reinterpret_cast<uintptr_t>(lat.GetRow(1)) % 64));
+        expect(that % 50.0 == lat.Get(t0, n1));
+        expect(that % 200.0 == lat.Get(t0, n2));
+        expect(that % 5.0 == bw.Get(t0, n2));
+        expect(that % 1 == lat.RowArgMin(0));
+        expect(that % 2 == lat.RowArgMax(0));
+        expect(that % 1 == bw.RowArgMax(0));
+        //the DataPath between n0 and t1 is oriented the other way
+        expect(std::isnan(lat.Get(t1, n0)));
+        expect(that % -1 == lat.RowArgMin(1));
+        expect(that % -1 == lat.RowArgMax(1));
+        expect(std::isnan(lat.Get(n0, t0)));
+
+        DataPath* dp = new DataPath(t1, n2, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 1.0, 30.0);
+        expect(that % 1 == lat.Refresh());
+        expect(that % 0 == lat.Refresh());
+        expect(that % 2 == lat.RowArgMin(1));
+        expect(that % 30.0 == lat.Get(1, 2));
+        //unknown (negative) values are missing entries
+        dp->DeleteDataPath();
+        new DataPath(t1, n2, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER);
+        expect(that % 1 == lat.Refresh());
+        expect(that % -1 == lat.RowArgMin(1));
+
+        Thread* t2 = new Thread(topo, 2);
+        expect(that % 3 == lat.Refresh());
+        expect(that % t2 == lat.GetRowComponent(2));
+        expect(that % -1 == lat.RowArgMin(2));
+
+        for(Component* c : std::vector<Component*>{t0, t1, n0, n1, n2})
+            c->DeleteAllDataPaths();
+        topo->Delete(true);
+    };
+};
@@ -0,0 +1,56 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+#include <memory>
+
+using namespace boost::ut;
+
+static suite<"frozen-topology"> _ = []
+{
+    Topology topo;
+    Node node{&topo, 1};
+    Chip chip0{&node, 0};
+    Cache l3{&chip0, 0, 3};
+    Core core0{&l3, 0};
+    Thread thread0{&core0, 0};
+    Thread thread1{&core0, 1};
+    Core core1{&l3, 1};
+    Thread thread2{&core1, 2};
+    Chip chip1{&node, 1};
+    Core core2{&chip1, 2};
+    Thread thread3{&core2, 3};
+
+    auto frozen = std::unique_ptr<FrozenTopology>(topo.Freeze());
+
+    "Layout"_test = [&]
+    {
+        expect(that % 12 == frozen->GetNumComponents());
+        expect(that % &topo == frozen->GetComponent(0));
+        expect(that % -1 == frozen->GetParentIdx(0));
+        expect(that % 12 == frozen->GetSubtreeEnd(0));
+
+        int chipIdx = frozen->GetIndex(&chip0);
+        expect(that % 2 == chipIdx);
+        expect(that % frozen->GetIndex(&l3) == frozen->GetFirstChildIdx(chipIdx));
+        expect(that % frozen->GetIndex(&chip1) == frozen->GetNextSiblingIdx(chipIdx));
+        expect(that % frozen->GetIndex(&chip1) == frozen->GetSubtreeEnd(chipIdx));
+        expect(that % 2 == frozen->GetDepth(chipIdx));
+        expect(that % -1 == frozen->GetIndex(nullptr));
+    };
+
+    "Queries match the Component Tree"_test = [&]
+    {
+        expect(that % topo.GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD) == frozen->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+        expect(that % chip1.GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE) == frozen->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE, frozen->GetIndex(&chip1)));
+
+        expect(that % &thread2 == frozen->GetSubcomponentById(2, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % nullptr == frozen->GetSubcomponentById(2, SYS_SAGE_COMPONENT_THREAD, frozen->GetIndex(&chip1)));
+
+        expect(that % &l3 == frozen->GetAncestorType(&thread1, SYS_SAGE_COMPONENT_CACHE));
+        expect(that % nullptr == frozen->GetAncestorType(&thread3, SYS_SAGE_COMPONENT_CACHE));
+
+        expect(that % topo.GetTopoTreeDepth() == frozen->GetTopoTreeDepth());
+        expect(that % chip1.GetTopoTreeDepth() == frozen->GetTopoTreeDepth(frozen->GetIndex(&chip1)));
+    };
+};
@@ -1,6 +1,8 @@
 #include "sys-sage.hpp"
 
 #include <boost/ut.hpp>
+#include <filesystem>
+#include <fstream>
 
 using namespace boost::ut;
 
@@ -57,4 +59,110 @@ static suite<"hwloc"> _ = []
 
     auto thread = dynamic_cast<Thread *>(core->GetChildByType(SYS_SAGE_COMPONENT_THREAD));
     expect(that % (thread != nullptr) >> fatal);
+
+    "Streaming and DOM parsers"_test = []
+    {
+        std::string xml = std::filesystem::temp_directory_path() / "sys-sage-test-hwloc-stream.xml";
+        {
+            //hwloc 1.x style "Cache" objects, an ignored element with an object inside, and Package info
+            std::ofstream f(xml);
+            f << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<topology>\n"
+              << "<object type=\"Machine\" os_index=\"0\"><distances nbobjs=\"1\"><object type=\"Core\" os_index=\"9\"/></distances>\n"
+              << "<object type=\"Package\" os_index=\"3\"><info name=\"CPUModel\" value=\"Test CPU\"/>\n"
+              << "<object type=\"Cache\" gp_index=\"5\" cache_size=\"4096\" depth=\"2\" cache_linesize=\"64\" cache_associativity=\"4\">"
+              << "<object type=\"Bridge\"><object type=\"Core\" os_index=\"1\"><object type=\"PU\" os_index=\"2\"/></object></object>"
+              << "</object></object></object>\n</topology>\n";
+        }
+        for(std::string path : {xml, std::string(SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")})
+        {
+            Topology stream, dom;
+            Node* streamNode = new Node(&stream);
+            Node* domNode = new Node(&dom);
+            expect(that % (0 == parseHwlocOutput(streamNode, path)) >> fatal);
+            expect(that % (0 == parseHwlocOutputDOM(domNode, path)) >> fatal);
+            expect(that % domNode->CountAllSubcomponents() == streamNode->CountAllSubcomponents());
+            TopologyPatch* patch = Diff(&dom, &stream);
+            expect(that % (patch != NULL) >> fatal);
+            expect(patch->IsEmpty());
+            delete patch;
+        }
+
+        Topology topo;
+        Node* node = new Node(&topo);
+        expect(that % (0 == parseHwlocOutput(node, xml)) >> fatal);
+        Chip* chip = (Chip*)node->GetChildByType(SYS_SAGE_COMPONENT_CHIP);
+        expect(that % (chip != nullptr) >> fatal);
+        expect(that % 3 == chip->GetId());
+        expect(that % "Test CPU"sv == chip->GetModel());
+        Cache* cache = (Cache*)chip->GetChildByType(SYS_SAGE_COMPONENT_CACHE);
+        expect(that % (cache != nullptr) >> fatal);
+        expect(that % 4096 == cache->GetCacheSize());
+        //objects of unknown types are skipped, their children kept
+        Core* core = (Core*)cache->GetChildByType(SYS_SAGE_COMPONENT_CORE);
+        expect(that % (core != nullptr) >> fatal);
+        expect(that % 1 == core->GetId());
+        expect(that % 1 == node->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE).size());
+
+        //malformed and missing files
+        {
+            std::ofstream f(xml);
+            f << "<topology><object type=\"Machine\"><object type=\"Core\">";
+        }
+        Node* broken = new Node(&topo, 1);
+        new Chip(broken, 7);
+        expect(that % 0 != parseHwlocOutput(broken, xml));
+        //nothing of the malformed file is attached
+        expect(that % 1 == broken->GetChildren()->size());
+        expect(that % 1 == broken->CountAllSubcomponents());
+        std::filesystem::remove(xml);
+        expect(that % 0 != parseHwlocOutput(broken, xml));
+    };
+
+    "Modified relevant object types"_test = []
+    {
+        //parseHwlocOutput() falls back to the DOM parser, which honors the modified lists
+        std::vector<std::string> types = xmlRelevantObjectTypes;
+        xmlRelevantObjectTypes.erase(std::find(xmlRelevantObjectTypes.begin(), xmlRelevantObjectTypes.end(), "PU"));
+        Topology topo;
+        Node* node = new Node(&topo);
+        expect(that % (0 == parseHwlocOutput(node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        xmlRelevantObjectTypes = types;
+        expect(that % 24 == node->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 0 == node->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+    };
+
+    "NUMA node after its sibling caches"_test = []
+    {
+        std::string xml = std::filesystem::temp_directory_path() / "sys-sage-test-hwloc-numa-order.xml";
+        {
+            std::ofstream f(xml);
+            f << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<topology>\n"
+              << "<object type=\"Machine\" os_index=\"0\"><object type=\"Package\" os_index=\"0\">\n"
+              << "<object type=\"L3Cache\" gp_index=\"1\" cache_size=\"1024\" depth=\"3\"><object type=\"Core\" os_index=\"0\"/></object>\n"
+              << "<object type=\"L3Cache\" gp_index=\"2\" cache_size=\"1024\" depth=\"3\"><object type=\"Core\" os_index=\"1\"/></object>\n"
+              << "<object type=\"NUMANode\" os_index=\"0\" local_memory=\"4096\"/>\n"
+              << "</object></object>\n</topology>\n";
+        }
+        for(auto parse : {parseHwlocOutput, parseHwlocOutputDOM})
+        {
+            Topology topo;
+            Node* node = new Node(&topo);
+            expect(that % (0 == parse(node, xml, NULL)) >> fatal);
+            Component* chip = node->GetChildByType(SYS_SAGE_COMPONENT_CHIP);
+            expect(that % (chip != nullptr) >> fatal);
+            //the caches are moved below the NUMA node, as if it had been listed first
+            expect(that % 1 == chip->GetChildren()->size());
+            Component* numa = chip->GetChildByType(SYS_SAGE_COMPONENT_NUMA);
+            expect(that % (numa != nullptr) >> fatal);
+            expect(that % 2 == numa->GetChildren()->size());
+            for(Component* cache : *numa->GetChildren())
+            {
+                expect(that % SYS_SAGE_COMPONENT_CACHE == cache->GetComponentType());
+                expect(that % numa == cache->GetParent());
+            }
+            expect(that % 2 == node->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+            expect(that % &topo == numa->GetRoot());
+        }
+        std::filesystem::remove(xml);
+    };
 };
@@ -0,0 +1,88 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"query"> _ = []
+{
+    Topology topo;
+    Node node{&topo, 1};
+    Chip gpu{&node, 0, "gpu", SYS_SAGE_CHIP_TYPE_GPU};
+    expect(that % (0 == parseGpuTopo(&gpu, SYS_SAGE_TEST_RESOURCE_DIR "/pascal_gpu_topo.csv")) >> fatal);
+    Chip cpu{&node, 1, "cpu", SYS_SAGE_CHIP_TYPE_CPU_SOCKET};
+    Cache cpuL2{&cpu, 0, 2, 1024};
+    Core core0{&cpuL2, 0};
+    Core core1{&cpuL2, 1};
+    int rack = 7;
+    core1.attrib.Set("temperature", 41.5);
+    core1.attrib["rack_no"] = (void *)&rack;
+    AttribRegistry::RegisterKey("rack_no", SYS_SAGE_ATTRIB_TYPE_INT);
+
+    "Path steps and predicates"_test = [&]
+    {
+        std::vector<Component *> gpuL2;
+        for (Cache *c : gpu.GetAllSubcomponents<Cache>())
+            if (c->GetCacheLevel() == 2)
+                gpuL2.push_back(c);
+        expect(that % !gpuL2.empty());
+        expect(that % gpuL2 == topo.Query("Node/Chip[type=GPU]//Cache[level=L2]"));
+        expect(that % std::vector<Component *>{&cpuL2} == topo.Query("Node/Chip[type=CPU_SOCKET]//Cache[level=2]"));
+        expect(that % std::vector<Component *>{&gpu, &cpu} == topo.Query("/Node/Chip"));
+        expect(that % std::vector<Component *>{&cpu} == topo.Query("Node/Chip[name='cpu']"));
+        expect(that % std::vector<Component *>{&cpu} == topo.Query("Node/Chip[type!=GPU]"));
+        expect(that % std::vector<Component *>{&core1} == topo.Query("//Core[id=1]"));
+        expect(that % std::vector<Component *>{&core0, &core1} == cpu.Query("//Core[id<=1]"));
+        expect(that % std::vector<Component *>{&cpuL2, &core0, &core1} == cpu.Query("//Cache|Core"));
+        expect(that % std::vector<Component *>{&core0, &core1} == cpu.Query("Cache/*"));
+        expect(that % _u(3840) == topo.Query("//Thread").size());
+        expect(that % _u(3840) == topo.Query("//Subdivision//Thread").size());
+    };
+
+    "Attribute predicates"_test = [&]
+    {
+        expect(that % std::vector<Component *>{&core1} == topo.Query("//Core[@temperature]"));
+        expect(that % std::vector<Component *>{&core1} == topo.Query("//Core[@temperature > 40]"));
+        expect(that % 0 == topo.Query("//Core[@temperature > 42]").size());
+        expect(that % std::vector<Component *>{&core1} == topo.Query("//Core[@rack_no=7]"));
+    };
+
+    "Memoization"_test = [&]
+    {
+        ComponentQuery query{"//Core"};
+        expect(that % query.IsValid());
+        expect(that % 2 == query.Evaluate(&cpu).size());
+        Core core2{&cpuL2, 2};
+        expect(that % 3 == query.Evaluate(&cpu).size());
+        cpuL2.RemoveChild(&core2);
+        expect(that % 2 == query.Evaluate(&cpu).size());
+
+        //attributes and names change without a change of the tree version, so such queries are not memoized
+        ComponentQuery hot{"//Core[@temperature > 40]"};
+        expect(that % 1 == hot.Evaluate(&cpu).size());
+        core1.attrib.Set("temperature", 30.0);
+        expect(that % 0 == hot.Evaluate(&cpu).size());
+        core1.attrib.Set("temperature", 41.5);
+        core0.attrib.Set("temperature", 60.0);
+        expect(that % 2 == topo.Query("//Core[@temperature > 40]").size());
+        core0.attrib.Remove("temperature");
+        expect(that % 1 == topo.Query("//Core[@temperature > 40]").size());
+
+        expect(that % 1 == topo.Query("Node/Chip[name='cpu']").size());
+        cpu.SetName("socket");
+        expect(that % 0 == topo.Query("Node/Chip[name='cpu']").size());
+        cpu.SetName("cpu");
+        expect(that % 1 == topo.Query("Node/Chip[name='cpu']").size());
+    };
+
+    "Syntax errors"_test = []
+    {
+        for (const char *expression : {"", "Node/", "Gizmo", "Node[foo=1]", "Node[id=x]", "Node[id=1", "Chip[type=FPGA]", "Node Chip", "Cache[level]"})
+        {
+            ComponentQuery query{expression};
+            expect(that % !query.IsValid());
+            expect(that % !query.GetError().empty());
+            expect(that % 0 == query.Evaluate(nullptr).size());
+        }
+    };
+};
@@ -0,0 +1,126 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace std::literals;
+
+static Topology* BuildTopology()
+{
+    Topology* t = new Topology();
+    Node* node = new Node(t, 0);
+    Chip* socket = new Chip(node, 0, "socket", SYS_SAGE_CHIP_TYPE_CPU_SOCKET);
+    Cache* l3 = new Cache(socket, 0, "3", 1 << 20);
+    l3->attrib.Set("CATL3mask", (uint64_t)0xff);
+    for(int i = 0; i < 4; i++)
+        new Thread(new Core(l3, i), i);
+    Memory* mem = new Memory(node, "mem", 1 << 30);
+    new DataPath(t->GetSubcomponentById(0, SYS_SAGE_COMPONENT_THREAD), mem, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 10.0, 100.0);
+    new DataPath(t->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD), mem, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 10.0, 100.0);
+    return t;
+}
+
+static suite<"topology-diff"> _ = []
+{
+    "Equal trees"_test = []
+    {
+        Topology* a = BuildTopology();
+        Topology* b = BuildTopology();
+        TopologyPatch* patch = Diff(a, b);
+        expect(patch != nullptr);
+        expect(patch->IsEmpty());
+        expect(that % 0 == ApplyPatch(a, patch));
+        delete patch;
+        expect(Diff(a, a->GetChild(0)) == nullptr);
+        a->Delete(true);
+        b->Delete(true);
+    };
+
+    "Diff and apply"_test = []
+    {
+        Topology* oldTopo = BuildTopology();
+        Topology* newTopo = BuildTopology();
+
+        //CPU hotplug of core 3, a new core 4 with a DataPath, a changed L3 and a changed DataPath
+        Component* core3 = newTopo->GetSubcomponentById(3, SYS_SAGE_COMPONENT_CORE);
+        core3->Delete(true);
+        Cache* l3 = (Cache*)newTopo->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CACHE);
+        Thread* t4 = new Thread(new Core(l3, 4), 4);
+        Component* mem = newTopo->GetChild(0)->GetChildByType(SYS_SAGE_COMPONENT_MEMORY);
+        new DataPath(t4, mem, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 20.0, 50.0);
+        l3->SetCacheSize(1 << 19);
+        l3->attrib.Set("CATL3mask", (uint64_t)0x0f);
+        l3->attrib.Set("owner", "tenant0"s);
+        ((Chip*)newTopo->GetChild(0)->GetChildByType(SYS_SAGE_COMPONENT_CHIP))->SetModel("model-b");
+        DataPath* dp1 = (*newTopo->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD)->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING))[0];
+        dp1->attrib.Set("congested", 1);
+        oldTopo->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CACHE)->attrib.Set("stale", 1);
+
+        TopologyPatch* patch = Diff(oldTopo, newTopo);
+        expect(patch != nullptr);
+        expect(not patch->IsEmpty());
+        int removals = 0, additions = 0;
+        for(const TopologyPatch::Operation& op : patch->GetOperations())
+        {
+            removals += op.type == SYS_SAGE_PATCH_REMOVE_COMPONENT;
+            additions += op.type == SYS_SAGE_PATCH_ADD_COMPONENT;
+        }
+        expect(that % 1 == removals);
+        expect(that % 1 == additions);
+
+        //unchanged components are kept
+        Component* t0 = oldTopo->GetSubcomponentById(0, SYS_SAGE_COMPONENT_THREAD);
+        Cache* oldL3 = (Cache*)oldTopo->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CACHE);
+        expect(that % 0 == ApplyPatch(oldTopo, patch));
+        expect(that % t0 == oldTopo->GetSubcomponentById(0, SYS_SAGE_COMPONENT_THREAD));
+        expect(oldTopo->GetSubcomponentById(3, SYS_SAGE_COMPONENT_CORE) == nullptr);
+        expect(that % 4 == oldTopo->GetSubcomponentById(4, SYS_SAGE_COMPONENT_THREAD)->GetId());
+        expect(that % (1 << 19) == oldL3->GetCacheSize());
+        expect(that % 0x0f == *oldL3->attrib.Get<uint64_t>("CATL3mask"));
+        expect(that % "tenant0"sv == *oldL3->attrib.Get<std::string>("owner"));
+        expect(that % SYS_SAGE_ATTRIB_TYPE_NONE == oldL3->attrib.GetType("stale"));
+        expect(that % "model-b"sv == ((Chip*)oldTopo->GetChild(0)->GetChildByType(SYS_SAGE_COMPONENT_CHIP))->GetModel());
+        DataPath* applied = (*oldTopo->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD)->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING))[0];
+        expect(that % 1 == *applied->attrib.Get<int>("congested"));
+        expect(that % 10.0 == applied->GetBw());
+        DataPath* added = (*oldTopo->GetSubcomponentById(4, SYS_SAGE_COMPONENT_THREAD)->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING))[0];
+        expect(that % 50.0 == added->GetLatency());
+        expect(that % oldTopo->GetChild(0)->GetChildByType(SYS_SAGE_COMPONENT_MEMORY) == added->GetTarget());
+
+        //the patched tree equals the new one
+        TopologyPatch* rest = Diff(oldTopo, newTopo);
+        expect(rest->IsEmpty());
+        delete rest;
+
+        //operations whose components are missing are skipped and counted
+        Topology* other = BuildTopology();
+        other->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CHIP)->Delete(true);
+        expect(ApplyPatch(other, patch) > 0);
+
+        delete patch;
+        other->Delete(true);
+        oldTopo->Delete(true);
+        newTopo->Delete(true);
+    };
+
+    "Two parses of the same file"_test = []
+    {
+        expect(that % SYS_SAGE_SUBDIVISION_TYPE_NONE == Numa().GetSubdivisionType());
+        expect(that % SYS_SAGE_SUBDIVISION_TYPE_NONE == Subdivision().GetSubdivisionType());
+
+        Topology* a = new Topology();
+        Topology* b = new Topology();
+        expect(that % (0 == parseHwlocOutput(new Node(a), SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        expect(that % (0 == parseHwlocOutput(new Node(b), SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        expect(that % 4 == b->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_NUMA));
+        TopologyPatch* patch = Diff(a, b);
+        expect(that % (patch != NULL) >> fatal);
+        expect(patch->IsEmpty());
+        expect(that % 0 == ApplyPatch(a, patch));
+        for(Component* numa : a->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_NUMA))
+            expect(that % SYS_SAGE_SUBDIVISION_TYPE_NONE == ((Numa*)numa)->GetSubdivisionType());
+        delete patch;
+        a->Delete(true);
+        b->Delete(true);
+    };
+};
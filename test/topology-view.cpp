@@ -0,0 +1,91 @@
+#include <boost/ut.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace std::literals;
+
+static suite<"topology-view"> _ = []
+{
+    Topology topo;
+    Node node{&topo, 0};
+    Chip socket0{&node, 0};
+    Numa numa0{&socket0, 0};
+    Core core0{&socket0, 0};
+    Thread t0{&core0, 0};
+    Thread t1{&core0, 1};
+    Core core1{&socket0, 1};
+    Thread t2{&core1, 2};
+    Chip socket1{&node, 1};
+    Core core2{&socket1, 2};
+    Thread t3{&core2, 3};
+    Memory mem{&node};
+    DataPath dp0{&core0, &core1, SYS_SAGE_DATAPATH_ORIENTED};
+    DataPath dp1{&core0, &core2, SYS_SAGE_DATAPATH_ORIENTED};
+
+    "Cpuset view"_test = [&]
+    {
+        TopologyView view{&topo, CpuSet{{1, 2}}};
+        expect(view.Contains(&topo));
+        expect(view.Contains(&numa0));
+        expect(view.Contains(&mem));
+        expect(view.Contains(&t1));
+        expect(not view.Contains(&t0));
+        expect(not view.Contains(&socket1));
+        expect(not view.Contains(&t3));
+
+        expect(that % std::vector<Component *>{&socket0, &mem} == view.GetChildren(&node));
+        expect(that % std::vector<Component *>{&t1, &t2} == view.GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+        expect(that % 2 == view.GetNumThreads());
+        expect(that % 2 == view.CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 8 == view.CountAllSubcomponents());
+        expect(that % "1-2"sv == view.GetCpuSet().ToString());
+        expect(that % "1"sv == view.GetCpuSet(&core0).ToString());
+        expect(view.GetCpuSet(&socket1).IsEmpty());
+        expect(that % &socket0 == view.FindSmallestComponentCovering(CpuSet{{1, 2}}));
+        expect(that % &t1 == view.FindSmallestComponentCovering(CpuSet{{1}}));
+        expect(view.FindSmallestComponentCovering(CpuSet{{3}}) == nullptr);
+        expect(that % &t2 == view.GetSubcomponentById(2, SYS_SAGE_COMPONENT_THREAD));
+        expect(view.GetSubcomponentById(3, SYS_SAGE_COMPONENT_THREAD) == nullptr);
+
+        expect(that % std::vector<DataPath *>{&dp0} == view.GetDataPaths(&core0, SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % std::vector<Component *>{&core0, &core1} == view.Query("//Core"));
+
+        //the caches follow tree changes
+        Thread t4{&core2, 4};
+        Thread t5{&core1, 1};
+        expect(that % 3 == view.GetNumThreads());
+        core1.RemoveChild(&t5);
+        core2.RemoveChild(&t4);
+        expect(that % 2 == view.GetNumThreads());
+    };
+
+    "Predicate view"_test = [&]
+    {
+        TopologyView view{&node, [](Component* c){ return c->GetComponentType() != SYS_SAGE_COMPONENT_CHIP || c->GetId() == 1; }};
+        expect(that % std::vector<Component *>{&socket1, &mem} == view.GetChildren());
+        expect(that % 1 == view.GetNumThreads());
+        expect(not view.Contains(&topo));
+        std::vector<Component *> nodes;
+        view.GetSubtreeNodeList(&nodes);
+        expect(that % std::vector<Component *>{&node, &socket1, &core2, &t3, &mem} == nodes);
+        expect(view.GetDataPaths(&core0, SYS_SAGE_DATAPATH_OUTGOING).empty());
+    };
+
+    "Reading a cgroup cpuset"_test = []
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "sys-sage-test-cpuset.cpus.effective").string();
+        std::ofstream(path) << "0-3,8,10-11\n";
+        CpuSet allowed;
+        expect(that % 0 == TopologyView::ReadCgroupCpuSet(path, &allowed));
+        expect(that % 7 == allowed.Count());
+        expect(that % "0-3,8,10-11"sv == allowed.ToString());
+        std::filesystem::remove(path);
+
+        expect(that % 1 == allowed.Parse("0-x"));
+        expect(allowed.IsEmpty());
+        expect(that % 0 == allowed.Parse(""));
+    };
+};
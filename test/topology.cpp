@@ -2,6 +2,9 @@
 
 #include "sys-sage.hpp"
 
+#include <thread>
+#include <filesystem>
+
 using namespace boost::ut;
 
 static suite<"topology"> _ = []
@@ -243,6 +246,48 @@ static suite<"topology"> _ = []
         expect(that % 2_u == array.size());
     };
 
+    "Depth and level index"_test = []
+    {
+        Node a{0};
+        Chip b{&a, 1};
+        Chip c{&a, 2};
+        Core d{&b, 3};
+        Core e{&c, 4};
+        Thread f{&d, 5};
+        Thread g{&e, 6};
+        Thread h{&e, 7};
+
+        expect(that % 0 == a.GetDepth());
+        expect(that % 1 == c.GetDepth());
+        expect(that % 3 == h.GetDepth());
+
+        expect(that % std::vector<Component *>{&f, &g, &h} == std::vector<Component *>(a.GetComponentsNLevelsDeeper(3).begin(), a.GetComponentsNLevelsDeeper(3).end()));
+        expect(that % std::vector<Component *>{&g, &h} == std::vector<Component *>(c.GetComponentsNLevelsDeeper(2).begin(), c.GetComponentsNLevelsDeeper(2).end()));
+        expect(that % 1 == d.GetComponentsNLevelsDeeper(0).size());
+        expect(that % &d == d.GetComponentsNLevelsDeeper(0)[0]);
+        expect(a.GetComponentsNLevelsDeeper(4).empty());
+        expect(f.GetComponentsNLevelsDeeper(1).empty());
+
+        std::vector<Component *> bfs;
+        a.GetSubtreeNodeListBreadthFirst(&bfs);
+        expect(that % std::vector<Component *>{&a, &b, &c, &d, &e, &f, &g, &h} == bfs);
+
+        //moving a subtree updates the depths and the level index
+        Core i{&a, 8};
+        c.RemoveChild(&e);
+        i.InsertChild(&e);
+        expect(that % 2 == e.GetDepth());
+        expect(that % 3 == g.GetDepth());
+        b.RemoveChild(&d);
+        e.InsertChild(&d);
+        expect(that % 3 == d.GetDepth());
+        expect(that % 4 == f.GetDepth());
+        expect(that % std::vector<Component *>{&f} == std::vector<Component *>(a.GetComponentsNLevelsDeeper(4).begin(), a.GetComponentsNLevelsDeeper(4).end()));
+        std::vector<Component *> array;
+        a.GetComponentsNLevelsDeeper(&array, 3);
+        expect(that % std::vector<Component *>{&g, &h, &d} == array);
+    };
+
     "Get subcomponents by type"_test = []
     {
         Node a;
@@ -312,4 +357,509 @@ static suite<"topology"> _ = []
 
         expect(that % 3 == a.GetTopoTreeDepth());
     };
+
+    "Subcomponent index"_test = []
+    {
+        Node a{0};
+        Chip b{&a, 1};
+        Core c{&b, 1};
+        Thread d{&c, 7};
+        Thread e{&c, 8};
+
+        a.EnableSubcomponentIndex();
+        expect(that % a.HasSubcomponentIndex());
+        expect(that % d.HasSubcomponentIndex());
+        expect(that % &d == a.GetSubcomponentById(7, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % &c == a.GetSubcomponentById(1, SYS_SAGE_COMPONENT_CORE));
+        expect(that % nullptr == a.GetSubcomponentById(7, SYS_SAGE_COMPONENT_CORE));
+
+        Thread f{9};
+        c.InsertChild(&f);
+        expect(that % &f == b.GetSubcomponentById(9, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % 1 == c.RemoveChild(&d));
+        expect(that % nullptr == a.GetSubcomponentById(7, SYS_SAGE_COMPONENT_THREAD));
+
+        // duplicate ids: the first match in DFS order wins, as without the index
+        Chip g{&a, 2};
+        Core h{&g, 1};
+        expect(that % &c == a.GetSubcomponentById(1, SYS_SAGE_COMPONENT_CORE));
+        expect(that % &h == g.GetSubcomponentById(1, SYS_SAGE_COMPONENT_CORE));
+
+        std::vector<Thread> threads;
+        threads.reserve(32);
+        for (int i = 0; i < 32; ++i)
+            threads.emplace_back(&c, 100 + i);
+        expect(that % &threads[20] == c.GetChild(120));
+        expect(that % nullptr == c.GetChild(200));
+
+        a.DisableSubcomponentIndex();
+        expect(that % !a.HasSubcomponentIndex());
+        expect(that % &threads[20] == a.GetSubcomponentById(120, SYS_SAGE_COMPONENT_THREAD));
+    };
+
+    "Range views"_test = []
+    {
+        static_assert(std::ranges::forward_range<ComponentSubtreeView>);
+        static_assert(std::ranges::view<ComponentSubtreeView>);
+        static_assert(std::ranges::view<ComponentAncestorView>);
+
+        Node a{0};
+        Chip b{&a, 1};
+        Core c{&b, 2};
+        Thread d{&c, 3};
+        Thread e{&c, 4};
+        Memory f{&a};
+
+        std::vector<Component *> expected, actual;
+        a.GetSubtreeNodeList(&expected);
+        for (Component *x : a.Subtree())
+            actual.push_back(x);
+        expect(that % expected == actual);
+
+        actual.clear();
+        for (Component *x : a.SubtreeOfType(SYS_SAGE_COMPONENT_THREAD | SYS_SAGE_COMPONENT_MEMORY))
+            actual.push_back(x);
+        expect(that % std::vector<Component *>{&d, &e, &f} == actual);
+
+        actual.clear();
+        for (Component *x : a.AtDepth(1))
+            actual.push_back(x);
+        expect(that % std::vector<Component *>{&b, &f} == actual);
+        actual.clear();
+        for (Component *x : b.AtDepth(2))
+            actual.push_back(x);
+        expect(that % std::vector<Component *>{&d, &e} == actual);
+        expect(that % 0 == std::ranges::distance(f.AtDepth(1)));
+
+        actual.clear();
+        for (Component *x : e.Ancestors())
+            actual.push_back(x);
+        expect(that % std::vector<Component *>{&c, &b, &a} == actual);
+        expect(that % 0 == std::ranges::distance(a.Ancestors()));
+
+        // early termination and composition with std::views
+        auto threads = a.Subtree() | std::views::filter([](Component *x) { return x->GetComponentType() == SYS_SAGE_COMPONENT_THREAD; }) | std::views::take(1);
+        expect(that % 1 == std::ranges::distance(threads));
+        expect(that % &d == *threads.begin());
+
+        // trees deeper than the inline position stack
+        std::vector<Component> chain(40);
+        for (size_t i = 1; i < chain.size(); ++i)
+            chain[i - 1].InsertChild(&chain[i]);
+        Component leaf{&chain[20]};
+        expect(that % 41 == std::ranges::distance(chain[0].Subtree()));
+        expect(that % &chain[39] == *chain[0].AtDepth(39).begin());
+        expect(that % 39 == std::ranges::distance(chain.back().Ancestors()));
+    };
+    "Subtree aggregates"_test = []
+    {
+        Node a{0};
+        Chip b{&a, 1};
+        Core c{&b, 2};
+        Thread d{&c, 3};
+        Thread e{&c, 4};
+        Memory f{&a};
+        Subdivision g{&b, 5, "custom", 4096};
+        expect(that % 6 == a.CountAllSubcomponents());
+        expect(that % 2 == a.GetNumThreads());
+        expect(that % 1 == a.CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 1 == a.CountAllSubcomponentsByType(4096));
+        expect(that % 3 == a.GetTopoTreeDepth());
+
+        // moving a subtree updates both ancestor chains
+        b.RemoveChild(&c);
+        expect(that % 3 == a.CountAllSubcomponents());
+        expect(that % 0 == a.GetNumThreads());
+        expect(that % 2 == a.GetTopoTreeDepth());
+        f.InsertChild(&c);
+        expect(that % 6 == a.CountAllSubcomponents());
+        expect(that % 2 == f.GetNumThreads());
+        expect(that % 3 == a.GetTopoTreeDepth());
+        expect(that % 1 == b.GetTopoTreeDepth());
+
+        Thread *h = new Thread(&b, 6);
+        expect(that % 3 == a.GetNumThreads());
+        h->Delete();
+        expect(that % 2 == a.GetNumThreads());
+        expect(that % 6 == a.CountAllSubcomponents());
+
+        // compare with a traversal of a parsed topology
+        Topology topo;
+        Node *n = new Node(&topo, 1);
+        expect(that % (0 == parseHwlocOutput(n, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        for (Component *x : topo.Subtree())
+        {
+            std::vector<Component *> subtree;
+            x->GetSubtreeNodeList(&subtree);
+            expect(that % ((int)subtree.size() - 1) == x->CountAllSubcomponents());
+            int caches = std::ranges::count_if(subtree, [](Component *y) { return y->GetComponentType() == SYS_SAGE_COMPONENT_CACHE; });
+            expect(that % (caches - (x->GetComponentType() == SYS_SAGE_COMPONENT_CACHE)) == x->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CACHE));
+        }
+        expect(that % 0 == topo.CheckComponentTreeConsistency());
+        n->Delete();
+    };
+    "Ancestor and lowest common ancestor queries"_test = []
+    {
+        Node a{0};
+        Chip b{&a, 1};
+        Cache l3{&b, 0, "3"};
+        Core c{&l3, 2};
+        Thread d{&c, 3};
+        Thread e{&c, 4};
+        Core f{&l3, 5};
+        Thread g{&f, 6};
+        Memory m{&a};
+
+        expect(that % a.IsAncestorOf(&d));
+        expect(that % c.IsAncestorOf(&e));
+        expect(that % !c.IsAncestorOf(&g));
+        expect(that % !d.IsAncestorOf(&c));
+        expect(that % !d.IsAncestorOf(&d));
+        expect(that % &c == d.GetLowestCommonAncestor(&e));
+        expect(that % &l3 == d.GetLowestCommonAncestor(&g));
+        expect(that % &a == g.GetLowestCommonAncestor(&m));
+        expect(that % &c == c.GetLowestCommonAncestor(&e));
+        expect(that % &l3 == d.GetSharedComponent(&g, SYS_SAGE_COMPONENT_CACHE));
+        expect(that % &l3 == d.GetSharedComponent(&e, SYS_SAGE_COMPONENT_CACHE | SYS_SAGE_COMPONENT_NUMA));
+        expect(that % &b == d.GetSharedComponent(&g, SYS_SAGE_COMPONENT_CHIP));
+        expect(that % (d.GetSharedComponent(&g, SYS_SAGE_COMPONENT_NUMA) == nullptr));
+
+        // labels follow changes of the tree
+        Node other{1};
+        expect(that % (d.GetLowestCommonAncestor(&other) == nullptr));
+        l3.RemoveChild(&f);
+        c.InsertChild(&f);
+        expect(that % c.IsAncestorOf(&g));
+        expect(that % &c == d.GetLowestCommonAncestor(&g));
+        c.RemoveChild(&f);
+        other.InsertChild(&f);
+        expect(that % !a.IsAncestorOf(&g));
+        expect(that % &other == g.GetLowestCommonAncestor(&other));
+        expect(that % (d.GetLowestCommonAncestor(&g) == nullptr));
+        other.RemoveChild(&f);
+
+        // compare with walking up the tree in a parsed topology
+        Topology topo;
+        Node *n = new Node(&topo, 1);
+        expect(that % (0 == parseHwlocOutput(n, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        std::vector<Component *> threads = n->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD);
+        for (Component *x : threads)
+        {
+            for (Component *y : threads)
+            {
+                Component *lca = x;
+                while (lca != y && !lca->IsAncestorOf(y))
+                    lca = lca->GetParent();
+                expect(that % lca == x->GetLowestCommonAncestor(y));
+                Component *numa = x->GetAncestorType(SYS_SAGE_COMPONENT_NUMA);
+                expect(that % (numa == y->GetAncestorType(SYS_SAGE_COMPONENT_NUMA) ? numa : nullptr) == x->GetSharedComponent(y, SYS_SAGE_COMPONENT_NUMA));
+            }
+        }
+        n->Delete();
+    };
+    "Labels are kept per Component Tree"_test = []
+    {
+        Node a{0};
+        Chip b{&a, 1};
+        Core c{&b, 2};
+        Core d{&b, 3};
+        Node other{1};
+        Chip x{&other, 1};
+        Core y{&x, 2};
+
+        std::span<Component *const> cores = a.GetComponentsNLevelsDeeper(2);
+        expect(that % a.IsAncestorOf(&c));
+        expect(that % other.IsAncestorOf(&y));
+        //changes of another tree keep the labels (and the returned views) of this one
+        Core z{&x, 3};
+        x.RemoveChild(&y);
+        expect(that % std::vector<Component *>{&c, &d} == std::vector<Component *>(cores.begin(), cores.end()));
+        expect(that % cores.data() == a.GetComponentsNLevelsDeeper(2).data());
+        expect(that % other.IsAncestorOf(&z));
+        expect(that % !other.IsAncestorOf(&y));
+
+        //concurrent queries on different trees and on the same tree
+        auto query = [&](Component *root, Component *leaf, bool *ok) {
+            for (int i = 0; i < 10000; i++)
+                *ok = *ok && root == leaf->GetLowestCommonAncestor(root) && root->IsAncestorOf(leaf) && !leaf->IsAncestorOf(root);
+        };
+        bool ok1 = true, ok2 = true, ok3 = true;
+        b.RemoveChild(&d);
+        x.InsertChild(&y);
+        std::thread t1(query, &a, &c, &ok1);
+        std::thread t2(query, &other, &z, &ok2);
+        std::thread t3(query, &b, &c, &ok3);
+        t1.join();
+        t2.join();
+        t3.join();
+        expect(that % (ok1 && ok2 && ok3));
+    };
+
+    "Type mask queries"_test = []
+    {
+        Node a{0};
+        Chip b{&a, 1};
+        Cache l3{&b, 0, "3"};
+        Core c{&l3, 2};
+        Thread d{&c, 3};
+        Numa n{&b, 4};
+        Core e{&b, 5};
+
+        expect(that % &l3 == b.GetChildByTypeMask(SYS_SAGE_COMPONENT_CORE | SYS_SAGE_COMPONENT_CACHE));
+        expect(that % &n == b.GetChildByTypeMask(SYS_SAGE_COMPONENT_NUMA));
+        expect(that % (b.GetChildByTypeMask(SYS_SAGE_COMPONENT_THREAD) == nullptr));
+        expect(that % std::vector<Component *>{&l3, &e} == b.GetAllChildrenByTypeMask(SYS_SAGE_COMPONENT_CORE | SYS_SAGE_COMPONENT_CACHE));
+
+        int mask = SYS_SAGE_COMPONENT_CORE | SYS_SAGE_COMPONENT_CACHE | SYS_SAGE_COMPONENT_NUMA;
+        expect(that % std::vector<Component *>{&l3, &c, &n, &e} == a.GetAllSubcomponentsByTypeMask(mask));
+        expect(that % std::vector<Component *>{&c} == l3.GetAllSubcomponentsByTypeMask(mask));
+        expect(that % 4 == a.CountAllSubcomponentsByTypeMask(mask));
+        expect(that % 1 == l3.CountAllSubcomponentsByTypeMask(mask));
+        expect(that % 0 == d.CountAllSubcomponentsByTypeMask(mask));
+
+        auto buckets = a.GetAllSubcomponentsByTypeMaskBucketed(mask);
+        expect(that % 3 == buckets.size());
+        expect(that % std::vector<Component *>{&c, &e} == buckets[SYS_SAGE_COMPONENT_CORE]);
+        expect(that % std::vector<Component *>{&l3} == buckets[SYS_SAGE_COMPONENT_CACHE]);
+        expect(that % std::vector<Component *>{&n} == buckets[SYS_SAGE_COMPONENT_NUMA]);
+
+        std::vector<Core *> cores = a.GetAllSubcomponents<Core>();
+        expect(that % std::vector<Core *>{&c, &e} == cores);
+        expect(that % std::vector<Numa *>{&n} == a.GetAllSubcomponents<Numa>());
+        expect(that % 0 == a.GetAllSubcomponents<Node>().size());
+    };
+
+    "Shared subtrees"_test = []
+    {
+        Topology* t = new Topology();
+        for(int n = 0; n < 3; n++)
+        {
+            Node* node = new Node(t, n);
+            Chip* socket = new Chip(node, 0, "socket", SYS_SAGE_CHIP_TYPE_CPU_SOCKET);
+            Cache* l3 = new Cache(socket, 0, "3", 1 << 20);
+            for(int i = 0; i < 2; i++)
+                new Thread(new Core(l3, i), i);
+        }
+        expect(that % 21 == t->CountAllSubcomponents());
+
+        expect(that % 12 == t->ShareIdenticalSubtrees());
+        expect(that % 21 == t->CountAllSubcomponents());
+        expect(that % 6 == t->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+        int visited = 0;
+        for([[maybe_unused]] Component* c : t->Subtree())
+            visited++;
+        expect(that % 22 == visited);
+
+        Node* n1 = (Node*)t->GetChild(1);
+        Node* n2 = (Node*)t->GetChild(2);
+        Component* socket = t->GetChild(0)->GetChild(0);
+        //iterators at different references of the shared socket are different positions
+        std::vector<ComponentSubtreeView::iterator> atSocket;
+        for(auto it = t->Subtree().begin(); it != std::default_sentinel; ++it)
+        {
+            if(*it == socket)
+                atSocket.push_back(it);
+        }
+        expect(that % (3 == atSocket.size()) >> fatal);
+        expect(atSocket[0] != atSocket[1]);
+        expect(atSocket[1] != atSocket[2]);
+        auto copy = atSocket[1];
+        expect(copy == atSocket[1]);
+        expect(*++copy == *++atSocket[2]);
+        expect(copy != atSocket[2]);
+        expect(that % socket == n1->GetChild(0));
+        expect(that % socket == n2->GetChild(0));
+        expect(that % 3 == socket->GetNumParents());
+        //the first instance is kept, so the first Node stays the parent
+        expect(that % t->GetChild(0) == socket->GetParent());
+        expect(socket->IsShared());
+        expect(not n1->IsShared());
+        expect(that % 1 == n1->GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_CACHE).size());
+
+        Component* thread = n1->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD);
+        Component* own = n1->Unshare(thread);
+        expect(own != nullptr && own != thread);
+        expect(not own->IsShared());
+        expect(that % 2 == socket->GetNumParents());
+        expect(n1->GetChild(0) != socket);
+        expect(that % 6 == t->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+        own->attrib.Set("private", 1);
+        expect(that % 1 == n1->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD)->attrib.size());
+        expect(that % 0 == n2->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD)->attrib.size());
+
+        n2->Delete(true);
+        expect(that % 1 == socket->GetNumParents());
+        expect(that % 4 == t->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+        t->Delete(true);
+    };
+
+    "Labels of a shared subtree"_test = []
+    {
+        Topology* t = new Topology();
+        Node* n0 = new Node(t, 0);
+        Node* n1 = new Node(t, 1);
+        Chip* sock = new Chip(n0, 0);
+        Core* core = new Core(sock, 0);
+        n1->InsertSharedChild(sock);
+        expect(that % n0 == sock->GetParent());
+        //upward queries follow the first parent
+        expect(n0->IsAncestorOf(sock));
+        expect(n0->IsAncestorOf(core));
+        expect(not n1->IsAncestorOf(sock));
+        expect(that % n0 == n0->GetLowestCommonAncestor(sock));
+        expect(that % sock == sock->GetLowestCommonAncestor(core));
+        expect(that % t == n1->GetLowestCommonAncestor(core));
+        //downward queries see each reference
+        expect(that % std::vector<Component*>{core} == std::vector<Component*>(n1->GetComponentsNLevelsDeeper(2).begin(), n1->GetComponentsNLevelsDeeper(2).end()));
+        expect(that % 2 == t->GetComponentsNLevelsDeeper(3).size());
+        n1->RemoveChild(sock);
+        t->Delete(true);
+    };
+
+    "Shared subtrees of concurrently built trees"_test = []
+    {
+        //the sharing bookkeeping is global -- unrelated trees may be shared, unshared and deleted concurrently
+        auto build = [](bool *ok) {
+            for(int r = 0; r < 50; r++)
+            {
+                Topology* t = new Topology();
+                for(int n = 0; n < 3; n++)
+                    new Core(new Chip(new Node(t, n), 0), 0);
+                *ok = *ok && 4 == t->ShareIdenticalSubtrees();
+                Component* fork = t->Fork();
+                Component* core = t->GetChild(1)->GetChild(0)->GetChild(0);
+                *ok = *ok && core->IsShared() && fork->Unshare(core) != core && t->GetChild(1)->Unshare(core) != core;
+                fork->Delete(true);
+                *ok = *ok && 9 == t->CountAllSubcomponents();
+                t->Delete(true);
+            }
+        };
+        bool ok1 = true, ok2 = true;
+        std::thread t1(build, &ok1);
+        std::thread t2(build, &ok2);
+        t1.join();
+        t2.join();
+        expect(that % (ok1 && ok2));
+    };
+
+    "Clone and fork"_test = []
+    {
+        Topology* t = new Topology();
+        Node* node = new Node(t, 0);
+        Chip* socket = new Chip(node, 0, "socket", SYS_SAGE_CHIP_TYPE_CPU_SOCKET);
+        Cache* l3 = new Cache(socket, 0, "3", 1 << 20);
+        Thread* t0 = new Thread(new Core(l3, 0), 0);
+        Thread* t1 = new Thread(new Core(l3, 1), 1);
+        Memory* mem = new Memory(node, "mem", 1 << 30);
+        int rack = 7;
+        node->attrib["rack_no"] = (void*)&rack;
+        AttribRegistry::RegisterKey("rack_no", SYS_SAGE_ATTRIB_TYPE_INT);
+        l3->attrib.Set("CATL3mask", (uint64_t)0xff);
+        DataPath* dp = new DataPath(t0, t1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 5.0, 42.0);
+        dp->attrib.Set("latency", 1.5f);
+        new DataPath(t0, mem, SYS_SAGE_DATAPATH_BIDIRECTIONAL);
+
+        Component* clone = node->CloneSubtree();
+        expect(that % nullptr == clone->GetParent());
+        expect(that % 0 == clone->GetDepth());
+        expect(that % node->CountAllSubcomponents() == clone->CountAllSubcomponents());
+        Cache* l3Copy = (Cache*)clone->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CACHE);
+        expect(l3Copy != l3);
+        expect(that % (1 << 20) == l3Copy->GetCacheSize());
+        expect(that % 0xff == *l3Copy->attrib.Get<uint64_t>("CATL3mask"));
+        //untyped attributes with a registered key are re-created as owned values
+        expect(that % SYS_SAGE_ATTRIB_TYPE_INT == clone->attrib.GetType("rack_no"));
+        expect(that % 7 == *clone->attrib.Get<int>("rack_no"));
+
+        Component* t0Copy = clone->GetSubcomponentById(0, SYS_SAGE_COMPONENT_THREAD);
+        Component* t1Copy = clone->GetSubcomponentById(1, SYS_SAGE_COMPONENT_THREAD);
+        expect(that % 2 == t0Copy->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        DataPath* dpCopy = (*t0Copy->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING))[0];
+        expect(dpCopy != dp);
+        expect(that % t1Copy == dpCopy->GetTarget());
+        expect(that % 42.0 == dpCopy->GetLatency());
+        expect(that % 1.5f == *dpCopy->attrib.Get<float>("latency"));
+        clone->Delete(true);
+        expect(that % 2 == t0->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+
+        //the fork shares everything until a component is unshared
+        Component* fork = t->Fork();
+        expect(that % node == fork->GetChild(0));
+        expect(that % t->CountAllSubcomponents() == fork->CountAllSubcomponents());
+        Component* l3Fork = fork->Unshare(l3);
+        expect(l3Fork != l3);
+        expect(that % node != fork->GetChild(0));
+        expect(that % socket != fork->GetChild(0)->GetChild(0));
+        expect(that % 0 == l3Fork->GetChild(0)->GetChild(0)->GetId());
+        expect(that % t0 == l3Fork->GetChild(0)->GetChild(0));
+        ((Cache*)l3Fork)->SetCacheSize(1 << 19);
+        expect(that % (1 << 20) == l3->GetCacheSize());
+        expect(that % (1 << 20) == ((Cache*)t->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CACHE))->GetCacheSize());
+        expect(that % (1 << 19) == ((Cache*)fork->GetSubcomponentById(0, SYS_SAGE_COMPONENT_CACHE))->GetCacheSize());
+
+        fork->Delete(true);
+        expect(that % t == node->GetParent());
+        expect(that % 1 == node->GetNumParents());
+        expect(that % 8 == t->CountAllSubcomponents());
+        t->Delete(true);
+    };
+
+    "Depth of an imported subtree"_test = []
+    {
+        Topology* t = new Topology();
+        Node* node = new Node(t, 0);
+        Chip* socket = new Chip(node, 0);
+        Core* core = new Core(socket, 0);
+        new Thread(core, 0);
+
+        //the root of the import has no parent, so the depths start at 0 regardless of the depth of the exported component
+        std::string path = std::filesystem::temp_directory_path() / "sys-sage-test-import-depth";
+        SharedMemory* shm = export_topology(path, socket);
+        expect(that % (shm != nullptr) >> fatal);
+        Component* imported = import_topology(path);
+        expect(that % (imported != nullptr) >> fatal);
+        expect(that % 0 == imported->GetDepth());
+        expect(that % 1 == imported->GetChild(0)->GetDepth());
+        expect(that % 2 == imported->GetChild(0)->GetChild(0)->GetDepth());
+        delete shm;
+        std::filesystem::remove(path);
+        t->Delete(true);
+    };
+
+    "Unshare with DataPaths"_test = []
+    {
+        Topology* t = new Topology();
+        Node* node = new Node(t, 0);
+        Cache* l3 = new Cache(node, 0, "3");
+        Core* core = new Core(l3, 0);
+        Memory* mem = new Memory(node);
+        DataPath* cat = new DataPath(l3, core, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        cat->attrib.Set("CATL3mask", (uint64_t)0xff);
+        new DataPath(core, mem, SYS_SAGE_DATAPATH_ORIENTED);
+
+        Component* fork = t->Fork();
+        Component* coreFork = fork->Unshare(core);
+        Component* l3Fork = coreFork->GetParent();
+        expect(coreFork != core && l3Fork != l3);
+        //the originals keep exactly their own DataPaths
+        expect(that % 1 == l3->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(that % 0 == l3->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        expect(that % 1 == core->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        expect(that % 1 == core->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(that % 1 == mem->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        //the L3CAT DataPath is copied once, between the copies; the one to the (still shared) memory is not
+        expect(that % 1 == l3Fork->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(that % 1 == coreFork->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        expect(that % 0 == coreFork->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        DataPath* catFork = (*coreFork->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING))[0];
+        expect(catFork != cat);
+        expect(that % l3Fork == catFork->GetSource());
+        expect(that % SYS_SAGE_DATAPATH_TYPE_L3CAT == catFork->GetDpType());
+        expect(that % 0xff == *catFork->attrib.Get<uint64_t>("CATL3mask"));
+
+        fork->Delete(true);
+        expect(that % 1 == l3->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING)->size());
+        expect(that % 1 == core->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        t->Delete(true);
+    };
 };